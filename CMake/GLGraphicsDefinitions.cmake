@@ -19,6 +19,7 @@ target_compile_definitions(${PROJECT_NAME} PUBLIC LINA_GRAPHICS_BINDTEXTURE_TEXT
 target_compile_definitions(${PROJECT_NAME} PUBLIC LINA_GRAPHICS_BINDTEXTURE_TEXTURE2D_MULTISAMPLE=0x9100)
 target_compile_definitions(${PROJECT_NAME} PUBLIC LINA_GRAPHICS_BINDTEXTURE_CUBEMAP=0x8513)
 target_compile_definitions(${PROJECT_NAME} PUBLIC LINA_GRAPHICS_BINDTEXTURE_CUBEMAP_POSITIVE_X=0x8515)
+target_compile_definitions(${PROJECT_NAME} PUBLIC LINA_GRAPHICS_BINDTEXTURE_TEXTUREBUFFER=0x8C2A)
 
 #----------------------------------- BUFFER BIT DEFINITIONS ----------------------------------- #
 target_compile_definitions(${PROJECT_NAME} PUBLIC LINA_GRAPHICS_BUFFERBIT_COLOR=0x00004000)
@@ -80,6 +80,12 @@ namespace LinaEngine
 			return m_duration; 
 		}
 
+		// Used for durations measured elsewhere, e.g. on the GPU.
+		void SetDuration(double duration)
+		{
+			m_duration = duration;
+		}
+
 		static const std::map<std::string, Timer*>& GetTimerMap() { return s_activeTimers; }
 		static Timer& GetTimer(const std::string& name);
 		static void UnloadTimers();
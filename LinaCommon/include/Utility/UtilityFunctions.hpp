@@ -40,6 +40,7 @@ Timestamp: 1/5/2019 12:42:58 AM
 #include <string>
 #include <vector>
 #include <functional>
+#include <iosfwd>
 
 namespace LinaEngine
 {
@@ -64,6 +65,12 @@ namespace LinaEngine
 		// Mostly used for loading shaders.
 		bool LoadTextFileWithIncludes(std::string& output, const std::string& fileName, const std::string& includeKeyword);
 
+		// Files written with versioned serialize functions start with this tag, files without it use the unversioned layouts.
+		void WriteVersionTag(std::ostream& stream);
+
+		// Consumes the tag & returns true if the stream starts with it, rewinds the stream otherwise.
+		bool ReadVersionTag(std::istream& stream);
+
 	}
 }
 
@@ -31,6 +31,7 @@ SOFTWARE.
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <cstring>
 
 namespace LinaEngine
 {
@@ -150,5 +151,26 @@ namespace LinaEngine
 			output = ss.str();
 			return true;
 		}
+
+		static const char s_versionTag[4] = { 'L', 'N', 'V', 'T' };
+
+		void WriteVersionTag(std::ostream& stream)
+		{
+			stream.write(s_versionTag, sizeof(s_versionTag));
+		}
+
+		bool ReadVersionTag(std::istream& stream)
+		{
+			std::streampos start = stream.tellg();
+			char tag[sizeof(s_versionTag)];
+			stream.read(tag, sizeof(tag));
+
+			if (stream.gcount() == sizeof(tag) && std::memcmp(tag, s_versionTag, sizeof(tag)) == 0)
+				return true;
+
+			stream.clear();
+			stream.seekg(start);
+			return false;
+		}
 	}
 }
\ No newline at end of file
@@ -72,6 +72,19 @@ namespace LinaEngine::ECS
 
 	};
 
+	// Reads a component from the snapshots written before its serialize function was versioned.
+	template<typename Type>
+	struct LegacyComponent
+	{
+		Type m_component;
+
+		template<class Archive>
+		void serialize(Archive& archive)
+		{
+			m_component.serialize(archive, 0);
+		}
+	};
+
 	template<typename T>
 	ECSTypeID GetTypeID()
 	{
@@ -102,6 +115,17 @@ namespace LinaEngine::ECS
 		ECSEntity GetEntity(const std::string& name);
 		void DestroyEntity(ECSEntity entity, bool isRoot = true);
 
+		// Moves the components loaded as LegacyComponent<Type> into Type.
+		template<typename Type>
+		void MigrateLegacyComponent()
+		{
+			auto legacyView = view<LegacyComponent<Type>>();
+			for (ECSEntity entity : legacyView)
+				emplace<Type>(entity, legacyView.get(entity).m_component);
+
+			clear<LegacyComponent<Type>>();
+		}
+
 	private:
 
 
@@ -85,6 +85,7 @@ namespace LinaEditor
 		int m_currentWrapR = 0;
 		int m_currentWrapT = 0;
 		bool m_currentGenerateMips = 0;
+		bool m_currentCompress = false;
 		int m_currentAnisotropy = 0;
 		
 	};
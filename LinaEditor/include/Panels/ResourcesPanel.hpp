@@ -123,6 +123,7 @@ namespace LinaEditor
 		void MaterialTextureSelected(LinaEngine::Graphics::Texture* texture);
 		void TextureReimported(std::pair<LinaEngine::Graphics::Texture*, LinaEngine::Graphics::Texture*> textures);
 		bool VerifyMaterialFiles(EditorFolder& folder, std::pair<LinaEngine::Graphics::Texture*, LinaEngine::Graphics::Texture*> textures);
+		void ReloadShaders();
 
 	private:
 
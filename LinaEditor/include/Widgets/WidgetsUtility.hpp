@@ -60,7 +60,8 @@ namespace LinaEditor
 		
 	public:
 		
-		static void ColorButton(const char* id, float* colorX);
+		// Returns true if the color was changed through the picker.
+		static bool ColorButton(const char* id, float* colorX);
 		static bool SelectableInput(const char* str_id, bool selected, int flags, char* buf, size_t buf_size);
 		static bool ToggleButton(const char* label, bool* v, float heightMultiplier = 1.0f, float widthMultiplier = 1.0f, const ImVec4& activeColor = ImVec4(0.56f, 0.83f, 0.26f, 1.0f), const ImVec4& activeHoveredColor = ImVec4(0.64f, 0.83f, 0.34f, 1.0f), const ImVec4& inActiveColor = ImVec4(0.85f, 0.85f, 0.85f, 1.0f), const ImVec4& inActiveHovered = ImVec4(0.78f, 0.78f, 0.78f, 1.0f));   // toggle button
 		static void DrawWindowBorders(const ImVec4& color, float thickness);
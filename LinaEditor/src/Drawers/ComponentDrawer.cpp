@@ -702,22 +702,28 @@ namespace LinaEditor
 			WidgetsUtility::ColorButton("##dclr", &dLight.m_color.r);
 
 			ImGui::SetCursorPosX(cursorPosLabels);
-			WidgetsUtility::AlignedText("Shadow Near Plane");
+			WidgetsUtility::AlignedText("Shadow Distance");
 			ImGui::SameLine();
 			ImGui::SetCursorPosX(cursorPosValues);
-			ImGui::DragFloat("##szNear", &dLight.m_shadowZNear);
+			ImGui::DragFloat("##sdist", &dLight.m_shadowDistance, 1.0f, 0.0f, 10000.0f);
 
 			ImGui::SetCursorPosX(cursorPosLabels);
-			WidgetsUtility::AlignedText("Shadow Far Plane");
+			WidgetsUtility::AlignedText("Shadow Cascades");
 			ImGui::SameLine();
 			ImGui::SetCursorPosX(cursorPosValues);
-			ImGui::DragFloat("##szFar", &dLight.m_shadowZFar);
+			ImGui::SliderInt("##scascades", &dLight.m_cascadeCount, 0, SC_MAXSHADOWCASCADES);
 
 			ImGui::SetCursorPosX(cursorPosLabels);
-			WidgetsUtility::AlignedText("Shadow Projection");
+			WidgetsUtility::AlignedText("Cascade Split");
 			ImGui::SameLine();
 			ImGui::SetCursorPosX(cursorPosValues);
-			ImGui::DragFloat4("##sproj", &dLight.m_shadowOrthoProjection.x);
+			ImGui::SliderFloat("##ssplit", &dLight.m_cascadeSplitLambda, 0.0f, 1.0f);
+
+			ImGui::SetCursorPosX(cursorPosLabels);
+			WidgetsUtility::AlignedText("Caster Distance");
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(cursorPosValues);
+			ImGui::DragFloat("##scaster", &dLight.m_shadowCasterDistance, 1.0f, 0.0f, 10000.0f);
 
 			WidgetsUtility::IncrementCursorPosY(CURSORPOS_Y_INCREMENT_AFTER);
 		}
@@ -848,6 +854,20 @@ namespace LinaEditor
 			renderer.m_materialID = renderer.m_selectedMatID;
 			renderer.m_materialPath = renderer.m_selectedMatPath;
 
+			// Static renderers are cached in the shadow map.
+			ImGui::SetCursorPosX(cursorPosLabels);
+			WidgetsUtility::AlignedText("Static");
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(cursorPosValues);
+			WidgetsUtility::ToggleButton("##meshRendererStatic", &renderer.m_isStatic);
+
+			// Occluders are rasterized on the CPU to hide what is behind them.
+			ImGui::SetCursorPosX(cursorPosLabels);
+			WidgetsUtility::AlignedText("Occluder");
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(cursorPosValues);
+			WidgetsUtility::ToggleButton("##meshRendererOccluder", &renderer.m_isOccluder);
+
 			WidgetsUtility::IncrementCursorPosY(CURSORPOS_Y_INCREMENT_AFTER);
 		}
 
@@ -925,6 +945,14 @@ namespace LinaEditor
 			renderer.m_materialID = renderer.m_selectedMatID;
 			renderer.m_materialPath = renderer.m_selectedMatPath;
 
+			// Sorting layer of the batched sprites.
+			ImGui::SetCursorPosX(cursorPosLabels);
+			WidgetsUtility::AlignedText("Layer");
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(cursorPosValues);
+			ImGui::SetNextItemWidth(ImGui::GetWindowWidth() - 35 - ImGui::GetCursorPosX());
+			ImGui::DragInt("##spriteLayer", &renderer.m_layer, 0.1f);
+
 			WidgetsUtility::IncrementCursorPosY(CURSORPOS_Y_INCREMENT_AFTER);
 		}
 
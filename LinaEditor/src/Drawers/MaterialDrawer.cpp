@@ -172,7 +172,8 @@ namespace LinaEditor
 				ImGui::SetCursorPosX(cursorPosValues);
 				ImGui::SetNextItemWidth(ImGui::GetWindowWidth() - 12 - ImGui::GetCursorPosX());
 				std::string label = "##f" + it->first;
-				ImGui::DragFloat(label.c_str(), &it->second, 0.08f);
+				if (ImGui::DragFloat(label.c_str(), &it->second, 0.08f))
+					m_selectedMaterial->SetDirty();
 				WidgetsUtility::PopStyleVar();
 			}
 		}
@@ -200,7 +201,8 @@ namespace LinaEditor
 				ImGui::SetCursorPosX(cursorPosValues);
 				ImGui::SetNextItemWidth(ImGui::GetWindowWidth() - 12 - ImGui::GetCursorPosX());
 				std::string label = "##i" + it->first;
-				ImGui::DragInt(label.c_str(), &it->second, 0.4f);
+				if (ImGui::DragInt(label.c_str(), &it->second, 0.4f))
+					m_selectedMaterial->SetDirty();
 				WidgetsUtility::PopStyleVar();
 			}
 		}
@@ -228,7 +230,8 @@ namespace LinaEditor
 				ImGui::SetCursorPosX(cursorPosValues);
 				ImGui::SetNextItemWidth(ImGui::GetWindowWidth() - 12 - ImGui::GetCursorPosX());
 				std::string label = "##i" + it->first;
-				ImGui::Checkbox(label.c_str(), &it->second);
+				if (ImGui::Checkbox(label.c_str(), &it->second))
+					m_selectedMaterial->SetDirty();
 				WidgetsUtility::PopStyleVar();
 			}
 		}
@@ -256,7 +259,8 @@ namespace LinaEditor
 				ImGui::SetCursorPosX(cursorPosValues);
 				ImGui::SetNextItemWidth(ImGui::GetWindowWidth() - 12 - ImGui::GetCursorPosX());
 				std::string label = "##c" + it->first;
-				WidgetsUtility::ColorButton(label.c_str(), &it->second.r);
+				if (WidgetsUtility::ColorButton(label.c_str(), &it->second.r))
+					m_selectedMaterial->SetDirty();
 				WidgetsUtility::PopStyleVar();
 			}
 		}
@@ -284,7 +288,8 @@ namespace LinaEditor
 				ImGui::SetCursorPosX(cursorPosValues);
 				ImGui::SetNextItemWidth(ImGui::GetWindowWidth() - 12 - ImGui::GetCursorPosX());
 				std::string label = "##v2" + it->first;
-				ImGui::DragFloat2(label.c_str(), &it->second.x);
+				if (ImGui::DragFloat2(label.c_str(), &it->second.x))
+					m_selectedMaterial->SetDirty();
 				WidgetsUtility::PopStyleVar();
 			}
 		}
@@ -313,7 +318,8 @@ namespace LinaEditor
 				ImGui::SetCursorPosX(cursorPosValues);
 				ImGui::SetNextItemWidth(ImGui::GetWindowWidth() - 12 - ImGui::GetCursorPosX());
 				std::string label = "##v3" + it->first;
-				ImGui::DragFloat3(label.c_str(), &it->second.x);
+				if (ImGui::DragFloat3(label.c_str(), &it->second.x))
+					m_selectedMaterial->SetDirty();
 				WidgetsUtility::PopStyleVar();
 			}
 		}
@@ -341,7 +347,8 @@ namespace LinaEditor
 				ImGui::SetCursorPosX(cursorPosValues);
 				ImGui::SetNextItemWidth(ImGui::GetWindowWidth() - 12 - ImGui::GetCursorPosX());
 				std::string label = "##v4" + it->first;
-				ImGui::DragFloat4(label.c_str(), &it->second.x);
+				if (ImGui::DragFloat4(label.c_str(), &it->second.x))
+					m_selectedMaterial->SetDirty();
 				WidgetsUtility::PopStyleVar();
 			}
 		}
@@ -70,6 +70,43 @@ namespace LinaEditor
 		ImGui::SetCursorPosX(cursorPosValues);
 		ImGui::Checkbox("##tangentSpace", &m_selectedParams.m_calculateTangentSpace);
 
+		ImGui::SetCursorPosX(cursorPosLabels);
+		WidgetsUtility::AlignedText("LOD Count");
+		ImGui::SameLine();
+		ImGui::SetCursorPosX(cursorPosValues);
+		ImGui::SetNextItemWidth(ImGui::GetWindowSize().x - cursorPosValues - 12);
+		ImGui::DragInt("##lodCount", &m_selectedParams.m_lodCount, 0.1f, 0, 8);
+
+		ImGui::SetCursorPosX(cursorPosLabels);
+		WidgetsUtility::AlignedText("LOD Reduction");
+		ImGui::SameLine();
+		ImGui::SetCursorPosX(cursorPosValues);
+		ImGui::SetNextItemWidth(ImGui::GetWindowSize().x - cursorPosValues - 12);
+		ImGui::DragFloat("##lodReduction", &m_selectedParams.m_lodReduction, 0.01f, 0.1f, 0.9f);
+
+		ImGui::SetCursorPosX(cursorPosLabels);
+		WidgetsUtility::AlignedText("Quantize Positions");
+		ImGui::SameLine();
+		ImGui::SetCursorPosX(cursorPosValues);
+		ImGui::Checkbox("##quantizePositions", &m_selectedParams.m_quantizePositions);
+
+		ImGui::SetCursorPosX(cursorPosLabels);
+		WidgetsUtility::AlignedText("Optimize Mesh");
+		ImGui::SameLine();
+		ImGui::SetCursorPosX(cursorPosValues);
+		ImGui::Checkbox("##optimizeMesh", &m_selectedParams.m_optimizeMesh);
+
+		// Cache misses per triangle & per vertex of each sub mesh, before -> after.
+		const std::vector<LinaEngine::Graphics::MeshOptimizationReport>& reports = m_selectedMesh->GetOptimizationReports();
+		for (uint32 i = 0; i < reports.size(); i++)
+		{
+			ImGui::SetCursorPosX(cursorPosLabels);
+			WidgetsUtility::AlignedText(("Sub Mesh " + std::to_string(i)).c_str());
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(cursorPosValues);
+			ImGui::Text("ACMR %.2f -> %.2f ATVR %.2f -> %.2f", reports[i].m_acmrBefore, reports[i].m_acmrAfter, reports[i].m_atvrBefore, reports[i].m_atvrAfter);
+		}
+
 		ImGui::SetCursorPosX(cursorPosLabels);
 
 		if (ImGui::Button("Apply"))
@@ -99,6 +99,7 @@ namespace LinaEditor
 		m_currentWrapT = GetWrapModeID(params.m_textureParams.m_wrapT);
 		m_currentAnisotropy = params.m_anisotropy;
 		m_currentGenerateMips = params.m_textureParams.m_generateMipMaps;
+		m_currentCompress = params.m_compress;
 	}
 
 	void TextureDrawer::DrawSelectedTexture()
@@ -129,6 +130,12 @@ namespace LinaEditor
 		ImGui::SetCursorPosX(cursorPosValues);
 		ImGui::Checkbox("##generateMipmaps", &m_currentGenerateMips);
 
+		WidgetsUtility::IncrementCursorPosX(CURSORPOS_X_LABELS);
+		WidgetsUtility::AlignedText("Compress?");
+		ImGui::SameLine();
+		ImGui::SetCursorPosX(cursorPosValues);
+		ImGui::Checkbox("##compress", &m_currentCompress);
+
 		WidgetsUtility::IncrementCursorPosX(CURSORPOS_X_LABELS);
 		WidgetsUtility::AlignedText("Anisotropy");
 		ImGui::SameLine();
@@ -313,6 +320,7 @@ namespace LinaEditor
 		{
 			params.m_anisotropy = m_currentAnisotropy;
 			params.m_textureParams.m_generateMipMaps = m_currentGenerateMips;
+			params.m_compress = m_currentCompress;
 			params.m_textureParams.m_internalPixelFormat = selectedInternalPF;
 			params.m_textureParams.m_pixelFormat = selectedPF;
 			params.m_textureParams.m_minFilter = selectedMinFilter;
@@ -324,7 +332,7 @@ namespace LinaEditor
 
 			std::string filePath = m_selectedTexture->GetPath();
 			std::string paramsPath = m_selectedTexture->GetParamsPath();
-			LinaEngine::Graphics::Texture* reimportedTexture = &LinaEngine::Graphics::Texture::CreateTexture2D(filePath, newParams, false, false, paramsPath);
+			LinaEngine::Graphics::Texture* reimportedTexture = &LinaEngine::Graphics::Texture::CreateTexture2D(filePath, newParams, newParams.m_compress, false, paramsPath);
 
 			auto pair = std::make_pair(m_selectedTexture, reimportedTexture);
 			LinaEditor::EditorApplication::GetEditorDispatcher().DispatchAction<std::pair<LinaEngine::Graphics::Texture*, LinaEngine::Graphics::Texture*>>(LinaEngine::Action::ActionType::TextureReimported,
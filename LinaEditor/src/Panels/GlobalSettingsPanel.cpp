@@ -105,6 +105,32 @@ namespace LinaEditor
 			ImGui::SetCursorPosX(cursorPosValues);
 			ImGui::Checkbox("##bloomEnabled", &renderSettings.m_bloomEnabled);
 
+			ImGui::SetCursorPosX(cursorPosLabels);
+			WidgetsUtility::AlignedText("Threshold");
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(cursorPosValues);
+			ImGui::DragFloat("##bloomThreshold", &renderSettings.m_bloomThreshold, 0.05f, 0.0f, 10.0f);
+
+			ImGui::SetCursorPosX(cursorPosLabels);
+			WidgetsUtility::AlignedText("Radius");
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(cursorPosValues);
+			ImGui::DragFloat("##bloomRadius", &renderSettings.m_bloomRadius, 0.05f, 0.1f, 4.0f);
+
+			WidgetsUtility::IncrementCursorPosY(6);
+
+			WidgetsUtility::DrawBeveledLine();
+			WidgetsUtility::IncrementCursorPosY(6);
+
+			ImGui::SetCursorPosX(cursorPosLabels);
+			WidgetsUtility::AlignedText("Occlusion Culling");
+
+			ImGui::SetCursorPosX(cursorPosLabels);
+			WidgetsUtility::AlignedText("Enabled");
+			ImGui::SameLine();
+			ImGui::SetCursorPosX(cursorPosValues);
+			ImGui::Checkbox("##occlusionCullingEnabled", &renderSettings.m_occlusionCullingEnabled);
+
 			WidgetsUtility::IncrementCursorPosY(6);
 
 			WidgetsUtility::DrawBeveledLine();
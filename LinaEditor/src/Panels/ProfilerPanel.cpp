@@ -31,6 +31,7 @@ SOFTWARE.
 #include "Core/Application.hpp"
 #include "Core/EditorCommon.hpp"
 #include "Core/Timer.hpp"
+#include "Rendering/RenderEngine.hpp"
 #include "imgui/imgui.h"
 #include "imgui/implot/implot.h"
 
@@ -174,6 +175,67 @@ namespace LinaEditor
 
 				ImPlot::EndPlot();
 
+			}
+
+			// Render stats of the last frame.
+			const LinaEngine::Graphics::RenderStats& stats = LinaEngine::Graphics::RenderEngine::GetRenderDevice().GetLastFrameStats();
+			const std::deque<LinaEngine::Graphics::RenderStats>& statsHistory = LinaEngine::Graphics::RenderEngine::GetRenderDevice().GetStatsHistory();
+
+			WidgetsUtility::IncrementCursorPosY(12);
+			WidgetsUtility::IncrementCursorPosX(12);
+			ImGui::Text("Draw Calls: %u (Instanced: %u, Instances: %u, Indirect Commands: %u)", stats.m_drawCalls, stats.m_instancedDrawCalls, stats.m_instances, stats.m_indirectCommands);
+			WidgetsUtility::IncrementCursorPosX(12);
+			ImGui::Text("Triangles: %u", stats.m_triangles);
+			WidgetsUtility::IncrementCursorPosX(12);
+			ImGui::Text("Shader Binds: %u, Texture Binds: %u", stats.m_shaderBinds, stats.m_textureBinds);
+			WidgetsUtility::IncrementCursorPosX(12);
+			ImGui::Text("Uniform Calls: %u, FBO Switches: %u", stats.m_uniformCalls, stats.m_fboSwitches);
+			WidgetsUtility::IncrementCursorPosX(12);
+			ImGui::Text("Uploaded: %.2f KB", (double)stats.m_uploadedBytes / 1024.0);
+
+			// Triangles saved by the selected levels of detail.
+			const LinaEngine::ECS::LODStats& lodStats = LinaEngine::Application::GetRenderEngine().GetMeshRendererSystem()->GetLODStats();
+			WidgetsUtility::IncrementCursorPosX(12);
+			ImGui::Text("LOD Triangles: %u / %u (Saved: %u)", lodStats.m_drawnTriangles, lodStats.m_fullTriangles, lodStats.m_fullTriangles - lodStats.m_drawnTriangles);
+
+			// Packets hidden by the occluders in the main view.
+			const LinaEngine::Graphics::OcclusionStats& occlusionStats = LinaEngine::Application::GetRenderEngine().GetOcclusionCuller().GetStats();
+			WidgetsUtility::IncrementCursorPosX(12);
+			ImGui::Text("Occluded: %u / %u (Occluder Triangles: %u)", occlusionStats.m_occludedBounds, occlusionStats.m_testedBounds, occlusionStats.m_occluderTriangles);
+
+			// Sprites drawn from the atlas pages.
+			const LinaEngine::Graphics::SpriteBatchStats& spriteStats = LinaEngine::Application::GetRenderEngine().GetSpriteBatcher().GetStats();
+			WidgetsUtility::IncrementCursorPosX(12);
+			ImGui::Text("Batched Sprites: %u (Batches: %u, Atlas Pages: %u)", spriteStats.m_sprites, spriteStats.m_batches, spriteStats.m_pages);
+
+			// Per frame history of draw calls & triangles.
+			static std::vector<float> drawCallData;
+			static std::vector<float> triangleData;
+			drawCallData.resize(statsHistory.size());
+			triangleData.resize(statsHistory.size());
+			for (size_t i = 0; i < statsHistory.size(); i++)
+			{
+				drawCallData[i] = (float)statsHistory[i].m_drawCalls;
+				triangleData[i] = (float)statsHistory[i].m_triangles / 1000.0f;
+			}
+
+			WidgetsUtility::IncrementCursorPosX(12);
+			WidgetsUtility::IncrementCursorPosY(12);
+			ImPlot::SetNextPlotLimitsX(0, RENDERSTATS_HISTORY_SIZE, ImGuiCond_Always);
+
+			if (!drawCallData.empty() && ImPlot::BeginPlot("##renderStats", NULL, NULL, ImVec2(-1, 115), 0, rt_axis, rt_axis)) {
+
+				std::string drawCallLabel = "Draw Calls " + std::to_string(stats.m_drawCalls);
+				std::string triangleLabel = "Triangles (K) " + std::to_string(stats.m_triangles / 1000);
+				ImPlot::PushStyleColor(ImPlotCol_Line, ImGui::GetStyleColorVec4(ImGuiCol_Header));
+				ImPlot::PlotLine(drawCallLabel.c_str(), &drawCallData[0], (int)drawCallData.size());
+				ImPlot::PopStyleColor();
+				ImPlot::PushStyleColor(ImPlotCol_Line, ImVec4(1.0, 1.0, 0.0, 1.0));
+				ImPlot::PlotLine(triangleLabel.c_str(), &triangleData[0], (int)triangleData.size());
+				ImPlot::PopStyleColor();
+
+				ImPlot::EndPlot();
+
 			}
 			ImGui::End();
 
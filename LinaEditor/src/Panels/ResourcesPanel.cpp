@@ -32,6 +32,7 @@ SOFTWARE.
 #include "Core/Application.hpp"
 #include "Core/EditorApplication.hpp"
 #include "Rendering/RenderEngine.hpp"
+#include "Rendering/Shader.hpp"
 #include "Input/InputMappings.hpp"
 #include "Core/EditorCommon.hpp"
 #include "Widgets/WidgetsUtility.hpp"
@@ -208,6 +209,12 @@ namespace LinaEditor
 				ImGui::EndMenu();
 			}
 
+			ImGui::Separator();
+
+			// Pick up the shader sources edited on disk.
+			if (ImGui::MenuItem("Reload Shaders"))
+				ReloadShaders();
+
 			ImGui::EndPopup();
 		}
 	}
@@ -433,7 +440,7 @@ namespace LinaEditor
 					if (LinaEngine::Utility::FileExists(samplerParamsPath))
 						samplerParams = LinaEngine::Graphics::Texture::LoadParameters(samplerParamsPath);
 
-					LinaEngine::Graphics::Texture::CreateTexture2D(file.m_path, samplerParams, false, false, samplerParamsPath);
+					LinaEngine::Graphics::Texture::CreateTexture2D(file.m_path, samplerParams, samplerParams.m_compress, false, samplerParamsPath);
 
 					LinaEngine::Graphics::Texture::SaveParameters(samplerParamsPath, samplerParams);
 				}
@@ -562,6 +569,16 @@ namespace LinaEditor
 			return FileType::Unknown;
 	}
 
+	void ResourcesPanel::ReloadShaders()
+	{
+		// Every source is dropped from the cache, includes as well, variants are compiled again on next use.
+		for (const auto& entry : std::filesystem::recursive_directory_iterator("resources"))
+		{
+			if (entry.path().extension() == ".glsl")
+				LinaEngine::Graphics::Shader::ReloadSource(entry.path().generic_string());
+		}
+	}
+
 	void ResourcesPanel::MaterialTextureSelected(LinaEngine::Graphics::Texture* texture)
 	{
 		ExpandFileResource(m_resourceFolders[0], texture->GetPath(), FileType::Texture2D);
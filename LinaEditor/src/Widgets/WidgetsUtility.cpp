@@ -38,8 +38,9 @@ namespace LinaEditor
 	std::map<std::string, float> WidgetsUtility::s_debugFloats;
 	std::map<std::string, bool> WidgetsUtility::s_carets;
 
-	void WidgetsUtility::ColorButton(const char* id, float* colorX)
+	bool WidgetsUtility::ColorButton(const char* id, float* colorX)
 	{
+		bool changed = false;
 		static bool alpha_preview = true;
 		static bool alpha_half_preview = false;
 		static bool drag_and_drop = true;
@@ -75,7 +76,7 @@ namespace LinaEditor
 
 			buf.append("##picker");
 			ImGui::Separator();
-			ImGui::ColorPicker4(buf.c_str(), colorX, misc_flags | ImGuiColorEditFlags_NoSidePreview | ImGuiColorEditFlags_NoSmallPreview);
+			changed = ImGui::ColorPicker4(buf.c_str(), colorX, misc_flags | ImGuiColorEditFlags_NoSidePreview | ImGuiColorEditFlags_NoSmallPreview);
 			ImGui::SameLine();
 			
 			buf.append("##current");
@@ -90,11 +91,14 @@ namespace LinaEditor
 				colorX[1] = backup_color.y;
 				colorX[2] = backup_color.z;
 				colorX[3] = backup_color.w;
+				changed = true;
 			}
 
 			ImGui::EndGroup();
 			ImGui::EndPopup();
 		}
+
+		return changed;
 	}
 
 	bool WidgetsUtility::SelectableInput(const char* str_id, bool selected, int flags, char* buf, size_t buf_size)
@@ -81,6 +81,9 @@ namespace LinaEngine::World
 		virtual void Tick(bool isInPlayMode, float delta) {};
 		virtual void SerializeRegistry(LinaEngine::ECS::ECSRegistry&, cereal::BinaryOutputArchive&);
 		virtual void DeserializeRegistry(LinaEngine::ECS::ECSRegistry&, cereal::BinaryInputArchive&);
+
+		// Loads snapshots written before the components were versioned, the versioned components are read as ECS::LegacyComponent.
+		virtual void DeserializeLegacyRegistry(LinaEngine::ECS::ECSRegistry&, cereal::BinaryInputArchive&);
 		void SerializeLevelData(const std::string& path, const std::string& levelName);
 		void DeserializeLevelData(const std::string& path, const std::string& levelName);
 		LevelData& GetLevelData() { return m_levelData; }
@@ -90,6 +93,9 @@ namespace LinaEngine::World
 
 		void LoadLevelResources();
 
+		// Merges the static mesh renderers, the merged data is cached next to the level file.
+		void BuildStaticBatches(const std::string& path, const std::string& levelName);
+
 
 	private:
 		LevelData m_levelData;
@@ -14,18 +14,23 @@
  * limitations under the License.
  */
 
+#pragma variant HAS_DIFFUSE material.diffuse
+
 
 #if defined(VS_BUILD)
 #include <../UniformBuffers.glh>
+#include <../Utility.glh>
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec2 texCoords;
-layout (location = 2) in mat4 model;
-layout (location = 6) in mat4 inverseTransposeModel;
+layout (location = 2) in vec4 modelRow0;
+layout (location = 3) in vec4 modelRow1;
+layout (location = 4) in vec4 modelRow2;
 out vec2 TexCoords;
 out vec3 FragPos;
 
 void main()
 {
+	mat4 model = InstanceModel(modelRow0, modelRow1, modelRow2);
 	gl_Position = projection * view * model * vec4(position, 1.0);
 	FragPos = vec3(model * vec4(position,1.0));
 	TexCoords = texCoords;
@@ -43,15 +48,23 @@ in vec2 TexCoords;
 struct Material
 {
   MaterialSampler2D diffuse;
-  vec3 objectColor;
 };
 
 uniform Material material;
 
+layout (std140) uniform MaterialData
+{
+  vec3 objectColor;
+} materialData;
+
 
 void main()
 {
-	fragColor = (material.diffuse.isActive ? texture(material.diffuse.texture ,TexCoords) : vec4(1.0)) * vec4(material.objectColor, 1.0);
-
+#if defined(HAS_DIFFUSE)
+	fragColor = texture(material.diffuse.texture, TexCoords) * vec4(materialData.objectColor, 1.0);
+#else
+	fragColor = vec4(materialData.objectColor, 1.0);
+#endif
+	brightColor = fragColor;
 }
 #endif
@@ -14,27 +14,38 @@
  * limitations under the License.
  */
 
+#pragma variant HAS_ALBEDOMAP material.albedoMap
+#pragma variant HAS_NORMALMAP material.normalMap
+#pragma variant HAS_ROUGHNESSMAP material.roughnessMap
+#pragma variant HAS_METALLICMAP material.metallicMap
+#pragma variant HAS_AOMAP material.aoMap
+#pragma variant HAS_SHADOWMAP material.shadowMap
+#pragma variant HAS_IRRADIANCEMAP material.irradianceMap
+#pragma variant HAS_IRRADIANCESH material.irradianceSH
+#pragma variant HAS_PREFILTERMAP material.prefilterMap
+#pragma variant HAS_BRDFLUTMAP material.brdfLUTMap
+
 
 #if defined(VS_BUILD)
 #include <../UniformBuffers.glh>
+#include <../Utility.glh>
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec2 texCoords;
-layout (location = 2) in vec3 normal;
-layout (location = 3) in vec3 tangent;
-layout (location = 4) in vec3 biTangent;
-layout (location = 5) in mat4 model;
-layout (location = 9) in mat4 inverseTransposeModel;
+layout (location = 2) in vec2 normal;
+layout (location = 3) in vec4 tangent;
+layout (location = 5) in vec4 modelRow0;
+layout (location = 6) in vec4 modelRow1;
+layout (location = 7) in vec4 modelRow2;
 out vec2 TexCoords;
 out vec3 WorldPos;
 out vec3 Normal;
-out vec4 FragPosLightSpace;
 
 void main()
 {
+    mat4 model = InstanceModel(modelRow0, modelRow1, modelRow2);
     TexCoords = texCoords;
     WorldPos = vec3(model * vec4(position, 1.0));
-    Normal = mat3(model) * normal;
-	FragPosLightSpace = lightSpace* vec4(WorldPos, 1.0);
+    Normal = normalize(NormalMatrix(model) * DecodeOctahedral(normal));
     gl_Position =  projection * view * vec4(WorldPos, 1.0);
 }
 
@@ -50,7 +61,6 @@ layout (location = 1) out vec4 brightColor;
 in vec2 TexCoords;
 in vec3 WorldPos;
 in vec3 Normal;
-in vec4 FragPosLightSpace;
 
 struct Material
 {
@@ -62,33 +72,63 @@ struct Material
   MaterialSampler2D brdfLUTMap;
   MaterialSamplerCube irradianceMap;
   MaterialSamplerCube prefilterMap;
+  MaterialSampler2D shadowMap;
+};
+
+uniform Material material;
+
+layout (std140) uniform MaterialData
+{
   vec3 objectColor;
   float metallic;
   float roughness;
   int workflow;
   int surfaceType;
   vec2 tiling;
-};
-
-uniform Material material;
+} materialData;
 
 // ----------------------------------------------------------------------------
 void main()
 {
-  vec2 tiled = vec2(TexCoords.x * material.tiling.x, TexCoords.y * material.tiling.y);
+  vec2 tiled = vec2(TexCoords.x * materialData.tiling.x, TexCoords.y * materialData.tiling.y);
   // material properties
-  vec3 albedo = material.albedoMap.isActive ? (pow(texture(material.albedoMap.texture, tiled).rgb, vec3(2.2)) * material.objectColor) : vec3(1.0);
-  float metallic = material.metallicMap.isActive ? (texture(material.metallicMap.texture,tiled).r * material.metallic) : material.metallic;
-  float roughness = material.roughnessMap.isActive  ? (texture(material.roughnessMap.texture, tiled).r * material.roughness) : material.roughness;
-  float ao = material.aoMap.isActive? texture(material.aoMap.texture, tiled).r : 1.0;
+#if defined(HAS_ALBEDOMAP)
+  vec4 albedoSample = texture(material.albedoMap.texture, tiled);
+  vec3 albedo = pow(albedoSample.rgb, vec3(2.2)) * materialData.objectColor;
+#else
+  vec4 albedoSample = vec4(1.0);
+  vec3 albedo = vec3(1.0);
+#endif
+
+#if defined(HAS_METALLICMAP)
+  float metallic = texture(material.metallicMap.texture,tiled).r * materialData.metallic;
+#else
+  float metallic = materialData.metallic;
+#endif
 
-  vec3 N = material.normalMap.isActive ? getNormalFromMap(texture(material.normalMap.texture, tiled).rgb, tiled, WorldPos, Normal) : Normal;
+#if defined(HAS_ROUGHNESSMAP)
+  float roughness = texture(material.roughnessMap.texture, tiled).r * materialData.roughness;
+#else
+  float roughness = materialData.roughness;
+#endif
+
+#if defined(HAS_AOMAP)
+  float ao = texture(material.aoMap.texture, tiled).r;
+#else
+  float ao = 1.0;
+#endif
+
+#if defined(HAS_NORMALMAP)
+  vec3 N = getNormalFromMap(texture(material.normalMap.texture, tiled).rgb, tiled, WorldPos, Normal);
+#else
+  vec3 N = Normal;
+#endif
   vec3 V = normalize(vec3(cameraPosition.x, cameraPosition.y, cameraPosition.z) - WorldPos);
 
 
     // calculate reflectance at normal incidence; if dia-electric (like plastic) use F0
     // of 0.04 and if it's a metal, use the albedo color as F0 (metallic workflow)
-    vec3 F0 = material.workflow == 0 ? vec3(0.04) : albedo; // plastic 0, metallic 1
+    vec3 F0 = materialData.workflow == 0 ? vec3(0.04) : albedo; // plastic 0, metallic 1
     F0 = mix(F0, albedo, metallic);
 
     // reflectance equation
@@ -97,43 +137,39 @@ void main()
     {
       vec3 L = -directionalLight.direction;
       vec3 radiance = directionalLight.color;
+#if defined(HAS_SHADOWMAP)
+      radiance *= 1.0 - GetDirectionalShadow(material.shadowMap.texture, WorldPos, N);
+#endif
       Lo += CalculateLight(N, V, L, albedo, metallic, roughness, radiance, F0);
     }
 
-    // Point lights.
-    for(int i = 0; i < pointLightCount; ++i)
+    // Point & spot lights of this fragment's cluster.
+    uvec2 lightRange = GetClusterLightRange(WorldPos);
+    for(uint i = 0u; i < lightRange.y; ++i)
     {
-        // calculate per-light radiance
-        vec3 L = normalize(pointLights[i].position - WorldPos);
-        float distance = length(pointLights[i].position - WorldPos);
-        float attenuation = 1.0 / (distance * distance);
-        vec3 radiance = pointLights[i].color * attenuation;
-        Lo += CalculateLight(N, V, L, albedo, metallic, roughness, radiance, F0);
-    }
+      uint lightIndex = texelFetch(lightIndexBuffer, int(lightRange.x + i)).r;
+      ClusterLight light = FetchClusterLight(lightIndex);
 
-    // Spot lights
-    for(int i = 0; i < spotLightCount; ++i)
-    {
       // calculate per-light radiance
-      vec3 L = normalize(spotLights[i].position - WorldPos);
-      float distance = length(spotLights[i].position - WorldPos);
-      float attenuation = 1.0 / (distance * distance);
-
-      float theta = dot(L, normalize(-spotLights[i].direction));
-      float epsilon = (spotLights[i].cutOff - spotLights[i].outerCutOff);
-      float intensity = clamp((theta - spotLights[i].outerCutOff) / epsilon, 0.0, 1.0);
-      vec3 radiance = spotLights[i].color * attenuation * intensity;
+      vec3 L = normalize(light.position - WorldPos);
+      float distance = length(light.position - WorldPos);
+      float attenuation = GetRangeWindow(distance, light.distance) / (distance * distance);
+      vec3 radiance = light.color * attenuation;
+
+      // Spot lights come after the point lights in the light buffer.
+      if(lightIndex >= uint(pointLightCount))
+      {
+        float theta = dot(L, normalize(-light.direction));
+        float epsilon = (light.cutOff - light.outerCutOff);
+        radiance *= clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+      }
 
       Lo += CalculateLight(N, V, L, albedo, metallic, roughness, radiance, F0);
     }
 
     vec3 ambient = vec3(0.0);
 
-    bool irrActive = material.irradianceMap.isActive;
-    bool preActive = material.prefilterMap.isActive;
-    bool lutActive = material.brdfLUTMap.isActive;
-
-    if(irrActive && preActive && lutActive)
+#if (defined(HAS_IRRADIANCEMAP) || defined(HAS_IRRADIANCESH)) && defined(HAS_PREFILTERMAP) && defined(HAS_BRDFLUTMAP)
     {
       vec3 R = reflect(-V, N);
 
@@ -143,7 +179,11 @@ void main()
       vec3 kD = 1.0 - kS;
       kD *= 1.0 - metallic;
 	  
+#if defined(HAS_IRRADIANCESH)
+      vec3 irradiance = EvaluateIrradianceSH(N);
+#else
       vec3 irradiance = texture(material.irradianceMap.texture, N).rgb;
+#endif
       vec3 diffuse = irradiance * albedo;
 
       // sample both the pre-filter map and the BRDF lut and combine them together as per the Split-Sum approximation to get the IBL specular part.
@@ -154,24 +194,22 @@ void main()
 
       ambient = (kD * (diffuse + specular)) * ao;
     }
+#endif
     // else
       // ambient = ambientColor.xyz * albedo * ao;
 	 
 
     vec3 color = ambient + Lo;
 
-	float brightness = dot(color.rgb, vec3(0.2126, 0.7152, 0.0722));
-    if(brightness > 1.0)
-        brightColor = vec4(color.rgb, 1.0);
-    else
-        brightColor = vec4(0.0, 0.0, 0.0, 1.0);
+	// Raw HDR color, the bloom prefilter applies the threshold.
+	brightColor = vec4(color.rgb, 1.0);
 		
     // HDR tonemapping
     color = color / (color + vec3(1.0));
     // gamma correct
     color = pow(color, vec3(1.0/2.2));
 
-	float alpha =  material.surfaceType == 0 ? 1.0 : (material.albedoMap.isActive ? texture(material.albedoMap.texture, tiled).a : 1.0);
+	float alpha =  materialData.surfaceType == 0 ? 1.0 : albedoSample.a;
     fragColor = vec4(color, alpha);
 
 }
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2019 Inan Evin
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#if defined(VS_BUILD)
+#include <../UniformBuffers.glh>
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 texCoords;
+out vec2 TexCoords;
+
+void main()
+{
+    gl_Position = vec4(position.x, position.y, 0.0, 1.0);
+    TexCoords = texCoords;
+}
+
+#elif defined(FS_BUILD)
+#include <../MaterialSamplers.glh>
+out vec4 fragColor;
+in vec2 TexCoords;
+
+struct Material
+{
+  MaterialSampler2D screenMap;
+  MaterialSampler2D bloomMap;
+};
+
+uniform Material material;
+
+layout (std140) uniform MaterialData
+{
+  vec3 inverseScreenMapSize;
+  float threshold;
+  float radius;
+  int pass;
+} materialData;
+
+// Pass types, matching the ones set by the render engine.
+#define PASS_PREFILTER 0
+#define PASS_DOWNSAMPLE 1
+#define PASS_UPSAMPLE 2
+
+float Luminance(vec3 color)
+{
+  return dot(color, vec3(0.2126, 0.7152, 0.0722));
+}
+
+// Soft knee threshold, keeps the part of the color above the threshold w/o a hard cut.
+vec3 Prefilter(vec3 color)
+{
+  float knee = materialData.threshold * 0.5;
+  float brightness = max(color.r, max(color.g, color.b));
+  float soft = clamp(brightness - materialData.threshold + knee, 0.0, 2.0 * knee);
+  soft = soft * soft / (4.0 * knee + 0.0001);
+  float contribution = max(soft, brightness - materialData.threshold) / max(brightness, 0.0001);
+  return color * contribution;
+}
+
+// Weights a sample group by its inverse luminance, stops single bright pixels from flickering.
+vec3 KarisAverage(vec3 a, vec3 b, vec3 c, vec3 d)
+{
+  float wa = 1.0 / (1.0 + Luminance(a));
+  float wb = 1.0 / (1.0 + Luminance(b));
+  float wc = 1.0 / (1.0 + Luminance(c));
+  float wd = 1.0 / (1.0 + Luminance(d));
+  return (a * wa + b * wb + c * wc + d * wd) / (wa + wb + wc + wd);
+}
+
+// 13 tap downsample as 5 overlapping 4 tap boxes.
+vec3 Downsample(bool prefilter)
+{
+  vec2 t = materialData.inverseScreenMapSize.xy;
+  vec3 a = texture(material.screenMap.texture, TexCoords + t * vec2(-2.0, 2.0)).rgb;
+  vec3 b = texture(material.screenMap.texture, TexCoords + t * vec2(0.0, 2.0)).rgb;
+  vec3 c = texture(material.screenMap.texture, TexCoords + t * vec2(2.0, 2.0)).rgb;
+  vec3 d = texture(material.screenMap.texture, TexCoords + t * vec2(-2.0, 0.0)).rgb;
+  vec3 e = texture(material.screenMap.texture, TexCoords).rgb;
+  vec3 f = texture(material.screenMap.texture, TexCoords + t * vec2(2.0, 0.0)).rgb;
+  vec3 g = texture(material.screenMap.texture, TexCoords + t * vec2(-2.0, -2.0)).rgb;
+  vec3 h = texture(material.screenMap.texture, TexCoords + t * vec2(0.0, -2.0)).rgb;
+  vec3 i = texture(material.screenMap.texture, TexCoords + t * vec2(2.0, -2.0)).rgb;
+  vec3 j = texture(material.screenMap.texture, TexCoords + t * vec2(-1.0, 1.0)).rgb;
+  vec3 k = texture(material.screenMap.texture, TexCoords + t * vec2(1.0, 1.0)).rgb;
+  vec3 l = texture(material.screenMap.texture, TexCoords + t * vec2(-1.0, -1.0)).rgb;
+  vec3 m = texture(material.screenMap.texture, TexCoords + t * vec2(1.0, -1.0)).rgb;
+
+  if(prefilter)
+  {
+    vec3 center = KarisAverage(j, k, l, m);
+    vec3 topLeft = KarisAverage(a, b, d, e);
+    vec3 topRight = KarisAverage(b, c, e, f);
+    vec3 bottomLeft = KarisAverage(d, e, g, h);
+    vec3 bottomRight = KarisAverage(e, f, h, i);
+    return Prefilter(center * 0.5 + (topLeft + topRight + bottomLeft + bottomRight) * 0.125);
+  }
+
+  vec3 result = (j + k + l + m) * 0.125;
+  result += (a + c + g + i) * 0.03125;
+  result += (b + d + f + h) * 0.0625;
+  result += e * 0.125;
+  return result;
+}
+
+// 9 tap tent filter, radius scales the spread in source texels.
+vec3 Upsample()
+{
+  vec2 t = materialData.inverseScreenMapSize.xy * materialData.radius;
+  vec3 result = texture(material.screenMap.texture, TexCoords).rgb * 4.0;
+  result += texture(material.screenMap.texture, TexCoords + t * vec2(-1.0, 0.0)).rgb * 2.0;
+  result += texture(material.screenMap.texture, TexCoords + t * vec2(1.0, 0.0)).rgb * 2.0;
+  result += texture(material.screenMap.texture, TexCoords + t * vec2(0.0, -1.0)).rgb * 2.0;
+  result += texture(material.screenMap.texture, TexCoords + t * vec2(0.0, 1.0)).rgb * 2.0;
+  result += texture(material.screenMap.texture, TexCoords + t * vec2(-1.0, -1.0)).rgb;
+  result += texture(material.screenMap.texture, TexCoords + t * vec2(1.0, -1.0)).rgb;
+  result += texture(material.screenMap.texture, TexCoords + t * vec2(-1.0, 1.0)).rgb;
+  result += texture(material.screenMap.texture, TexCoords + t * vec2(1.0, 1.0)).rgb;
+  return result / 16.0;
+}
+
+void main()
+{
+  vec3 result = vec3(0.0);
+
+  if(material.screenMap.isActive)
+  {
+    if(materialData.pass == PASS_UPSAMPLE)
+    {
+      result = Upsample();
+
+      // Add the downsampled level of the same size.
+      if(material.bloomMap.isActive)
+        result += texture(material.bloomMap.texture, TexCoords).rgb;
+    }
+    else
+      result = Downsample(materialData.pass == PASS_PREFILTER);
+  }
+
+  fragColor = vec4(result, 1.0);
+}
+#endif
@@ -14,6 +14,12 @@
  * limitations under the License.
  */
 
+#pragma variant HAS_SCREENMAP material.screenMap
+#pragma variant FXAA_ENABLED material.fxaaEnabled
+#pragma variant BLOOM_ENABLED material.bloomEnabled
+#pragma variant HAS_BLOOMMAP material.bloomMap
+#pragma variant HAS_OUTLINEMAP material.outlineMap
+
 
 
 #if defined(VS_BUILD)
@@ -37,6 +43,12 @@ struct Material
   MaterialSampler2D screenMap;
   MaterialSampler2D bloomMap;
   MaterialSampler2D outlineMap;
+};
+
+uniform Material material;
+
+layout (std140) uniform MaterialData
+{
   vec3 inverseScreenMapSize;
   float exposure;
   bool bloomEnabled;
@@ -45,8 +57,7 @@ struct Material
   float fxaaReduceMin;
   float fxaaReduceMul;
   float gamma;
-};
-uniform Material material;
+} materialData;
 
 float move(float x)
 	{
@@ -55,16 +66,15 @@ float move(float x)
 	
 void main()
 {
-  if(material.screenMap.isActive)
-  {
+#if defined(HAS_SCREENMAP)
 
     vec3 hdrColor = texture(material.screenMap.texture, TexCoords).rgb;
 
-    if(material.fxaaEnabled)
+#if defined(FXAA_ENABLED)
     {
       vec3 fxaaColor = vec3(0.0);
 
-      vec2 tcOffset = material.inverseScreenMapSize.xy;
+      vec2 tcOffset = materialData.inverseScreenMapSize.xy;
 
       // Get lumas
       vec3 luma = vec3(0.299, 0.587, 0.114);
@@ -81,9 +91,9 @@ void main()
       blurDirection.y = ((lumaTL + lumaBL) - (lumaTR + lumaBR));  // Vertical sum
 
       // Scale direction vector acc to smallest component.
-      float dirReduce = max((lumaTL + lumaTR + lumaBL + lumaBR) * (material.fxaaReduceMul * 0.25), material.fxaaReduceMin);
+      float dirReduce = max((lumaTL + lumaTR + lumaBL + lumaBR) * (materialData.fxaaReduceMul * 0.25), materialData.fxaaReduceMin);
       float inverseDirAdj = 1.0 / min(abs(blurDirection.x), abs(blurDirection.y) + dirReduce);
-      blurDirection = min(vec2(material.fxaaSpanMax), max(vec2(-material.fxaaSpanMax), blurDirection * inverseDirAdj)) * tcOffset;
+      blurDirection = min(vec2(materialData.fxaaSpanMax), max(vec2(-materialData.fxaaSpanMax), blurDirection * inverseDirAdj)) * tcOffset;
 
       vec3 result1 = (1.0 / 2.0) * (
         texture(material.screenMap.texture, TexCoords.xy + (blurDirection * vec2(1.0/3.0 - 0.5))).xyz +
@@ -99,14 +109,17 @@ void main()
       float lumaResult2 = dot(luma, result2);
       hdrColor = (lumaResult2 < lumaMin || lumaResult2 > lumaMax) ? result1 : result2;
     }
+#endif
 
     // Add bloom.
-    if(material.bloomEnabled && material.bloomMap.isActive)
-      hdrColor += texture(material.bloomMap.texture, TexCoords).rgb;
+#if defined(BLOOM_ENABLED) && defined(HAS_BLOOMMAP)
+    hdrColor += texture(material.bloomMap.texture, TexCoords).rgb;
+#endif
 
     // Add outline
-    if(material.outlineMap.isActive)
-      hdrColor += texture(material.outlineMap.texture, TexCoords).rgb;
+#if defined(HAS_OUTLINEMAP)
+    hdrColor += texture(material.outlineMap.texture, TexCoords).rgb;
+#endif
 
 	float RANDSIN = 33758.5453;
 	float time = 1.0;
@@ -119,14 +132,14 @@ void main()
 	//fragColor = edges / vec4(length(edges), length(edges), length(edges), length(edges));
 	
     // tone mapping
-    vec3 result = vec3(1.0) - exp(-hdrColor * material.exposure);
+    vec3 result = vec3(1.0) - exp(-hdrColor * materialData.exposure);
     // also gamma correct while we're at it
-    result = pow(result, vec3(1.0 / material.gamma));
-	//vec3 result = pow(1.0 - exp(-material.exposure * hdrColor.rgb), vec3(material.exposure));
+    result = pow(result, vec3(1.0 / materialData.gamma));
+	//vec3 result = pow(1.0 - exp(-materialData.exposure * hdrColor.rgb), vec3(materialData.exposure));
     fragColor = vec4(result, 1.0);
-  }
-  else
-    fragColor = vec4(1.0,0.0,0.0,1.0);
+#else
+  fragColor = vec4(1.0,0.0,0.0,1.0);
+#endif
 
 
 }
@@ -17,13 +17,16 @@
 
 #if defined(VS_BUILD)
 #include <../UniformBuffers.glh>
+#include <../Utility.glh>
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec2 texCoords;
-layout (location = 5) in mat4 model;
+layout (location = 5) in vec4 modelRow0;
+layout (location = 6) in vec4 modelRow1;
+layout (location = 7) in vec4 modelRow2;
 
 void main()
 {
-    gl_Position = lightSpace * model * vec4(position, 1.0);
+    gl_Position = lightSpace * InstanceModel(modelRow0, modelRow1, modelRow2) * vec4(position, 1.0);
 }
 
 #elif defined(FS_BUILD)
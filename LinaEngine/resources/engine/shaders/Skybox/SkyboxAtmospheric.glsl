@@ -43,14 +43,12 @@ in vec3 fsun;
 layout (location = 0) out vec4 fragColor;
 layout (location = 1) out vec4 brightColor;
 
-struct Material
+layout (std140) uniform MaterialData
 {
-	float time;
-	float cirrus;
-	float cumulus;
-};
-
-uniform Material material;
+  float time;
+  float cirrus;
+  float cumulus;
+} materialData;
 
   
 float hash(float n)
@@ -98,24 +96,21 @@ void main()
 	fragColor.rgb = 3.0 / (8.0 * 3.14) * (1.0 + mu * mu) * (Kr + Km * (1.0 - g * g) / (2.0 + g * g) / pow(1.0 + g * g - 2.0 * g * mu, 1.5)) / (Br + Bm) * extinction;
 
 	// Cirrus Clouds
-	float density = smoothstep(1.0 - material.cirrus, 1.0, fbm(pos.xyz / pos.y * 2.0 + material.time * 0.05)) * 0.3;
+	float density = smoothstep(1.0 - materialData.cirrus, 1.0, fbm(pos.xyz / pos.y * 2.0 + materialData.time * 0.05)) * 0.3;
 	fragColor.rgb = mix(fragColor.rgb, extinction * 4.0, density * max(pos.y, 0.0));
 
 	// Cumulus Clouds
 	for (int i = 0; i < 3; i++)
 	{
-	float density = smoothstep(1.0 - material.cumulus, 1.0, fbm((0.7 + float(i) * 0.01) * pos.xyz / pos.y + material.time * 0.3));
+	float density = smoothstep(1.0 - materialData.cumulus, 1.0, fbm((0.7 + float(i) * 0.01) * pos.xyz / pos.y + materialData.time * 0.3));
 	fragColor.rgb = mix(fragColor.rgb, extinction * density * 5.0, min(density, 1.0) * max(pos.y, 0.0));
 	}
 
 	// Dithering Noise
 	fragColor.rgb += noise(pos * 1000) * 0.01;
 	
-	float brightness = dot(fragColor.rgb, vec3(0.2126, 0.7152, 0.0722));
-    if(brightness > 1.0)
-        brightColor = vec4(fragColor.rgb, 1.0);
-    else
-        brightColor = vec4(0.0, 0.0, 0.0, 1.0);
+	// Raw HDR color, the bloom prefilter applies the threshold.
+	brightColor = vec4(fragColor.rgb, 1.0);
 		
 	// HDR tonemap and gamma correct
 	//fragColor.xyz = fragColor.xyz / (fragColor.xyz + vec3(1.0));
@@ -26,14 +26,13 @@ void main()
 
 #elif defined(FS_BUILD)
 out vec4 fragColor;
-struct Material
+layout (std140) uniform MaterialData
 {
   vec3 color;
-};
-uniform Material material;
+} materialData;
 
 void main()
 {
-   fragColor = vec4(material.color.x, material.color.y, material.color.z, 1);
+   fragColor = vec4(materialData.color.x, materialData.color.y, materialData.color.z, 1);
 }
 #endif
@@ -34,17 +34,16 @@ void main()
 #include <../Utility.glh>
 out vec4 fragColor;
 in vec3 RawPosition;
-struct Material
+layout (std140) uniform MaterialData
 {
-	vec3 startColor;
-	vec3 endColor;
-};
-uniform Material material;
+  vec3 startColor;
+  vec3 endColor;
+} materialData;
 
 void main()
 {
 	float u = RawPosition.y;
 	u = remap(u, -1.0f, 1.0f, 0.0f, 1.0f);
-  fragColor = mix( vec4(material.startColor, 1.0), vec4(material.endColor, 1.0), u );
+  fragColor = mix( vec4(materialData.startColor, 1.0), vec4(materialData.endColor, 1.0), u );
 }
 #endif
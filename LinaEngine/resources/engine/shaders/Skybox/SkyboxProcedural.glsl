@@ -34,18 +34,17 @@ void main()
 #elif defined(FS_BUILD)
 out vec4 fragColor;
 in vec3 WorldPos;
-struct Material
+layout (std140) uniform MaterialData
 {
   vec3 startColor;
   vec3 endColor;
   vec3 sunDirection;
-};
-uniform Material material;
+} materialData;
 
 void main()
 {
-	float f = dot(normalize(WorldPos), normalize(-material.sunDirection)) * 0.5f + 0.5f;
-  fragColor = mix(vec4(material.startColor, 1.0), vec4(material.endColor, 1.0), pow(f,2)) * 1;
+	float f = dot(normalize(WorldPos), normalize(-materialData.sunDirection)) * 0.5f + 0.5f;
+  fragColor = mix(vec4(materialData.startColor, 1.0), vec4(materialData.endColor, 1.0), pow(f,2)) * 1;
 }
 
 #endif
@@ -14,21 +14,25 @@
  * limitations under the License.
  */
 
+#pragma variant HAS_DIFFUSE material.diffuse
+
 
 #if defined(VS_BUILD)
 #include <../UniformBuffers.glh>
+#include <../Utility.glh>
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec2 texCoords;
-layout (location = 2) in vec3 normal;
-layout (location = 3) in vec3 tangent;
-layout (location = 4) in vec3 biTangent;
-layout (location = 5) in mat4 model;
-layout (location = 9) in mat4 inverseTransposeModel;
+layout (location = 2) in vec2 normal;
+layout (location = 3) in vec4 tangent;
+layout (location = 5) in vec4 modelRow0;
+layout (location = 6) in vec4 modelRow1;
+layout (location = 7) in vec4 modelRow2;
 out vec2 TexCoords;
 out vec3 FragPos;
 
 void main()
 {
+  mat4 model = InstanceModel(modelRow0, modelRow1, modelRow2);
   gl_Position = projection * view * model * vec4(position, 1.0);
   FragPos = vec3(model * vec4(position,1.0));
   TexCoords = texCoords;
@@ -48,13 +52,16 @@ in vec2 TexCoords;
 struct Material
 {
   MaterialSampler2D diffuse;
-  vec3 objectColor;
-  int surfaceType;
-  
 };
 
 uniform Material material;
 
+layout (std140) uniform MaterialData
+{
+  vec3 objectColor;
+  int surfaceType;
+} materialData;
+
 
 void main()
 {
@@ -65,16 +72,18 @@ void main()
 	}
 	else
 	{
-		float alpha = material.surfaceType == 0 ? 1.0 : (material.diffuse.isActive ? texture(material.diffuse.texture, TexCoords).a : 1.0);
-
-		float brightness = dot(fragColor.rgb, vec3(0.2126, 0.7152, 0.0722));
-		if(brightness > 1.0)
-			brightColor = vec4(fragColor.rgb, 1.0);
-		else
-			brightColor = vec4(0.0, 0.0, 0.0, 1.0);
+#if defined(HAS_DIFFUSE)
+		vec4 diffuse = texture(material.diffuse.texture, TexCoords);
+#else
+		vec4 diffuse = vec4(1.0);
+#endif
+		float alpha = materialData.surfaceType == 0 ? 1.0 : diffuse.a;
 
-		vec4 color = (material.diffuse.isActive ? texture(material.diffuse.texture ,TexCoords) : vec4(1.0)) * vec4(material.objectColor, 1.0);
+		vec4 color = diffuse * vec4(materialData.objectColor, 1.0);
 		fragColor = vec4(color.rgb, alpha);
+
+		// Raw HDR color, the bloom prefilter applies the threshold.
+		brightColor = vec4(color.rgb, 1.0);
 	}
 }
 #endif
@@ -30,6 +30,7 @@ SOFTWARE.
 #include "ECS/ECS.hpp"
 #include "Core/Application.hpp"
 #include "Rendering/RenderEngine.hpp"
+#include "Rendering/StaticBatcher.hpp"
 #include "ECS/Components/TransformComponent.hpp"
 #include "ECS/Components/CameraComponent.hpp"
 #include "ECS/Components/FreeLookComponent.hpp"
@@ -46,13 +47,16 @@ namespace LinaEngine::World
 {
 	bool Level::Install(bool loadFromFile, const std::string& path, const std::string& levelName)
 	{
+		// Batches of the previous level are no longer valid.
+		LinaEngine::Application::GetRenderEngine().GetStaticBatcher().Clear();
+
 		if (loadFromFile)
 		{
 			if (LinaEngine::Utility::FileExists(path + levelName + ".linaleveldata"))
 			{
 				DeserializeLevelData(path, levelName);
 				LoadLevelResources();
-
+				BuildStaticBatches(path, levelName);
 			}
 		}
 		return true;
@@ -86,7 +90,7 @@ namespace LinaEngine::World
 							if(Utility::FileExists(it->second.m_paramsPath))
 								samplerParams = Graphics::Texture::LoadParameters(it->second.m_paramsPath);
 
-							Graphics::Texture& texture = Graphics::Texture::CreateTexture2D(it->second.m_path, samplerParams, false, false, it->second.m_paramsPath);
+							Graphics::Texture& texture = Graphics::Texture::CreateTexture2D(it->second.m_path, samplerParams, samplerParams.m_compress, false, it->second.m_paramsPath);
 						
 							mat.SetTexture(it->first, &texture, it->second.m_bindMode);
 						}
@@ -126,6 +130,54 @@ namespace LinaEngine::World
 			renderEngine.SetSkyboxMaterial(nullptr);
 	}
 
+	void Level::BuildStaticBatches(const std::string& path, const std::string& levelName)
+	{
+		ECS::ECSRegistry& ecs = Application::GetECSRegistry();
+		std::vector<Graphics::StaticBatchSource> sources;
+		std::vector<ECS::MeshRendererComponent*> batchedRenderers;
+
+		auto view = ecs.view<ECS::TransformComponent, ECS::MeshRendererComponent>();
+
+		for (ECS::ECSEntity entity : view)
+		{
+			ECS::MeshRendererComponent& mr = view.get<ECS::MeshRendererComponent>(entity);
+			mr.m_batchSource = -1;
+
+			if (!mr.m_isStatic || !mr.m_isEnabled) continue;
+			if (!Graphics::Material::MaterialExists(mr.m_materialID) || !Graphics::Mesh::MeshExists(mr.m_meshID)) continue;
+
+			// Transparent renderers need to be sorted one by one.
+			Graphics::Material& mat = Graphics::Material::GetMaterial(mr.m_materialID);
+			if (mat.GetSurfaceType() != Graphics::MaterialSurfaceType::Opaque) continue;
+
+			Graphics::Mesh& mesh = Graphics::Mesh::GetMesh(mr.m_meshID);
+			if (!Graphics::StaticBatcher::CanBatch(mesh)) continue;
+
+			Graphics::StaticBatchSource source;
+			source.m_mesh = &mesh;
+			source.m_material = &mat;
+			source.m_model = view.get<ECS::TransformComponent>(entity).transform.ToMatrix();
+			sources.push_back(source);
+			batchedRenderers.push_back(&mr);
+		}
+
+		if (sources.size() == 0) return;
+
+		// Reuse the cached batches if they were built from the same renderers.
+		Graphics::StaticBatchCache cache;
+		const std::string cachePath = path + "/" + levelName + ".linastaticbatch";
+		if (!Graphics::StaticBatcher::LoadCache(cachePath, cache) || cache.m_sourceHash != Graphics::StaticBatcher::HashSources(sources))
+		{
+			Graphics::StaticBatcher::Build(sources, cache);
+			Graphics::StaticBatcher::SaveCache(cachePath, cache);
+		}
+
+		Application::GetRenderEngine().GetStaticBatcher().Load(cache, sources);
+
+		for (size_t i = 0; i < batchedRenderers.size(); i++)
+			batchedRenderers[i]->m_batchSource = (int)i;
+	}
+
 	void Level::SetSkyboxMaterial()
 	{
 		LinaEngine::Graphics::RenderEngine& renderEngine = LinaEngine::Application::GetRenderEngine();
@@ -174,6 +226,24 @@ namespace LinaEngine::World
 			>(iarchive);
 	}
 
+	void Level::DeserializeLegacyRegistry(LinaEngine::ECS::ECSRegistry& registry, cereal::BinaryInputArchive& iarchive)
+	{
+		entt::snapshot_loader{ registry }
+			.entities(iarchive)
+			.component<
+			LinaEngine::ECS::ECSEntityData,
+			LinaEngine::ECS::CameraComponent,
+			LinaEngine::ECS::FreeLookComponent,
+			LinaEngine::ECS::PointLightComponent,
+			LinaEngine::ECS::LegacyComponent<LinaEngine::ECS::DirectionalLightComponent>,
+			LinaEngine::ECS::SpotLightComponent,
+			LinaEngine::ECS::RigidbodyComponent,
+			LinaEngine::ECS::LegacyComponent<LinaEngine::ECS::MeshRendererComponent>,
+			LinaEngine::ECS::LegacyComponent<LinaEngine::ECS::SpriteRendererComponent>,
+			LinaEngine::ECS::TransformComponent
+			>(iarchive);
+	}
+
 	void Level::SerializeLevelData(const std::string& path, const std::string& levelName)
 	{
 		LinaEngine::ECS::ECSRegistry& registry = LinaEngine::Application::GetECSRegistry();
@@ -181,6 +251,7 @@ namespace LinaEngine::World
 		
 		std::ofstream registrySnapshotStream(path + "/" + levelName + "_ecsSnapshot.linasnapshot");
 		{
+			LinaEngine::Utility::WriteVersionTag(registrySnapshotStream);
 			cereal::BinaryOutputArchive oarchive(registrySnapshotStream); // Create an output archive
 			SerializeRegistry(registry, oarchive);
 		}
@@ -210,9 +281,27 @@ namespace LinaEngine::World
 		registry.clear();
 
 		std::ifstream regSnapshotStream(path + "/" + levelName + "_ecsSnapshot.linasnapshot");
+		try
 		{
+			bool versioned = LinaEngine::Utility::ReadVersionTag(regSnapshotStream);
 			cereal::BinaryInputArchive iarchive(regSnapshotStream);
-			DeserializeRegistry(registry, iarchive);
+
+			if (versioned)
+				DeserializeRegistry(registry, iarchive);
+			else
+			{
+				// Snapshots without the tag were written before the components were versioned.
+				DeserializeLegacyRegistry(registry, iarchive);
+				registry.MigrateLegacyComponent<LinaEngine::ECS::DirectionalLightComponent>();
+				registry.MigrateLegacyComponent<LinaEngine::ECS::MeshRendererComponent>();
+				registry.MigrateLegacyComponent<LinaEngine::ECS::SpriteRendererComponent>();
+				LINA_CORE_WARN("Level snapshot of {0} is in the unversioned format, it will be upgraded when the level is saved.", levelName);
+			}
+		}
+		catch (const std::exception& e)
+		{
+			LINA_CORE_ERR("Level snapshot of {0} could not be read, the level is loaded empty. {1}", levelName, e.what());
+			registry.clear();
 		}
 
 		registry.Refresh();
@@ -43,6 +43,7 @@ Timestamp: 5/13/2019 9:00:55 PM
 #include "Utility/Math/Vector.hpp"
 #include "Utility/Math/Math.hpp"
 #include "ECS/ECSComponent.hpp"
+#include <cereal/cereal.hpp>
 
 
 namespace LinaEngine::ECS
@@ -61,7 +62,7 @@ namespace LinaEngine::ECS
 
 	struct PointLightComponent : public LightComponent
 	{
-		float m_distance = 0;
+		float m_distance = 10.0f; // 0 derives the range from the light's intensity.
 
 		template<class Archive>
 		void serialize(Archive& archive)
@@ -73,7 +74,7 @@ namespace LinaEngine::ECS
 
 	struct SpotLightComponent : public LightComponent
 	{
-		float m_distance = 0;
+		float m_distance = 10.0f; // 0 derives the range from the light's intensity.
 		float m_cutoff = Math::Cos(Math::ToRadians(12.5f));
 		float m_outerCutoff = Math::Cos(Math::ToRadians(17.5f));
 
@@ -87,17 +88,29 @@ namespace LinaEngine::ECS
 
 	struct DirectionalLightComponent : public LightComponent
 	{
-		Vector4 m_shadowOrthoProjection = Vector4(-20, 20, -20, 20);
-		float m_shadowZNear = 10.0f;
-		float m_shadowZFar = 15.0f;
+		float m_shadowDistance = 100.0f; // Shadows are drawn up to this distance from the camera.
+		float m_cascadeSplitLambda = 0.75f; // Blend between uniform (0) & logarithmic (1) cascade splits.
+		float m_shadowCasterDistance = 50.0f; // Casters this far behind a cascade towards the light still cast shadows into it.
+		int m_cascadeCount = 4; // 0 disables the shadows.
 
 		template<class Archive>
-		void serialize(Archive& archive)
+		void serialize(Archive& archive, std::uint32_t const version)
 		{
-			archive(m_shadowOrthoProjection, m_shadowZNear, m_shadowZFar, m_color, m_isEnabled); // serialize things by passing them to the archive
+			// Version 0 is the single shadow map layout read from untagged snapshots through LegacyComponent, its projection settings are dropped.
+			if (version == 0)
+			{
+				Vector4 shadowOrthoProjection;
+				float shadowZNear = 0.0f, shadowZFar = 0.0f;
+				archive(shadowOrthoProjection, shadowZNear, shadowZFar, m_color, m_isEnabled);
+				return;
+			}
+
+			archive(m_shadowDistance, m_cascadeSplitLambda, m_shadowCasterDistance, m_cascadeCount, m_color, m_isEnabled); // serialize things by passing them to the archive
 		}
 	};
 }
 
+CEREAL_CLASS_VERSION(LinaEngine::ECS::DirectionalLightComponent, 1);
+
 
 #endif
\ No newline at end of file
@@ -50,6 +50,10 @@ namespace LinaEngine::ECS
 		std::string m_meshPath = "";
 		std::string m_materialPath = "";
 		std::string m_meshParamsPath = "";
+		bool m_isStatic = false;
+
+		// Rasterized into the occlusion buffer to hide the packets behind it.
+		bool m_isOccluder = false;
 
 		// Editor properties, not inside the macro to avoid any struct size mismatch during serialization.
 		int m_selectedMeshID = -1;
@@ -57,12 +61,24 @@ namespace LinaEngine::ECS
 		std::string m_selectedMeshPath = "";
 		std::string m_selectedMatPath = "";
 
+		// Index of the static batch source while the renderer is merged into the batches & drawn by them, -1 otherwise.
+		int m_batchSource = -1;
+
+		// Level of detail selected last frame.
+		int m_lod = 0;
+
 		template<class Archive>
-		void serialize(Archive& archive)
+		void serialize(Archive& archive, std::uint32_t const version)
 		{
 			archive(m_meshID, m_materialID, m_meshPath, m_meshParamsPath, m_materialPath, m_isEnabled);
+
+			// Version 1 adds the static & occluder flags.
+			if (version > 0)
+				archive(m_isStatic, m_isOccluder);
 		}
 	};
 }
 
+CEREAL_CLASS_VERSION(LinaEngine::ECS::MeshRendererComponent, 1);
+
 #endif
\ No newline at end of file
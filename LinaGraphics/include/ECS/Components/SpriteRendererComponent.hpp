@@ -37,6 +37,7 @@ Timestamp: 10/1/2020 9:26:21 AM
 #define SpriteRendererComponent_HPP
 
 #include "ECS/ECSComponent.hpp"
+#include <cereal/cereal.hpp>
 
 namespace LinaEngine::ECS
 {
@@ -45,17 +46,26 @@ namespace LinaEngine::ECS
 		int m_materialID = -1;
 		std::string m_materialPath = "";
 
+		// Batched sprites on lower layers are drawn first.
+		int m_layer = 0;
+
 		// Editor properties, not inside the macro to avoid any struct size mismatch during serialization.
 		int m_selectedMatID = -1;
 		std::string m_selectedMatPath = "";
 
 		template<class Archive>
-		void serialize(Archive& archive)
+		void serialize(Archive& archive, std::uint32_t const version)
 		{
 			archive(m_materialID, m_materialPath, m_isEnabled); // serialize things by passing them to the archive
+
+			// Version 1 adds the sorting layer.
+			if (version > 0)
+				archive(m_layer);
 		}
 
 	};
 }
 
+CEREAL_CLASS_VERSION(LinaEngine::ECS::SpriteRendererComponent, 1);
+
 #endif
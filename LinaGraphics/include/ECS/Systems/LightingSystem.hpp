@@ -46,6 +46,7 @@ Timestamp: 5/13/2019 12:49:19 AM
 #include "ECS/Components/TransformComponent.hpp"
 #include "ECS/Components/LightComponent.hpp"
 #include "PackageManager/PAMRenderDevice.hpp"
+#include "Rendering/RenderConstants.hpp"
 
 
 namespace LinaEngine
@@ -58,6 +59,55 @@ namespace LinaEngine
 
 namespace LinaEngine::ECS
 {
+	// std140 mirrors of the light structs in LightingData.glh.
+	struct DirectionalLightData
+	{
+		float m_direction[3] = { 0.0f, 0.0f, 0.0f };
+		float m_padding0 = 0.0f;
+		float m_color[3] = { 0.0f, 0.0f, 0.0f };
+		float m_padding1 = 0.0f;
+	};
+
+	// Texel layout of a point or spot light in the light data buffer, 3 RGBA32F texels per light.
+	struct LightBufferData
+	{
+		float m_position[3];
+		float m_distance;
+		float m_color[3];
+		float m_cutoff;
+		float m_direction[3];
+		float m_outerCutoff;
+	};
+
+	// Contents of the per-frame light buffer, point & spot lights are fetched from the cluster buffers.
+	struct LightArrayData
+	{
+		DirectionalLightData m_directionalLight;
+		float m_clusterScreen[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float m_clusterDepth[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		int32 m_clusterSize[4] = { SC_CLUSTERGRIDX, SC_CLUSTERGRIDY, SC_CLUSTERGRIDZ, 0 };
+		Matrix m_shadowMatrices[SC_MAXSHADOWCASCADES];
+		float m_shadowCascadeSplits[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float m_shadowAtlasRects[SC_MAXSHADOWCASCADES][4] = {};
+		int32 m_shadowParams[4] = { 0, 0, 0, 0 };
+	};
+
+	// A slice of the camera frustum the directional light's shadows are drawn for, into a tile of the shadow atlas.
+	struct ShadowCascade
+	{
+		Matrix m_view;
+		Matrix m_projection;
+		Vector2 m_atlasOffset = Vector2::Zero;
+		Vector2 m_atlasSize = Vector2::Zero;
+		float m_splitFar = 0.0f;
+
+		// Sphere the light frustum was fitted to, kept until the slice leaves it.
+		Vector3 m_center = Vector3::Zero;
+		Vector3 m_lightDirection = Vector3::Zero;
+		float m_radius = 0.0f;
+		float m_casterDistance = 0.0f;
+	};
+
 	class LightingSystem : public BaseECSSystem
 	{
 	public:
@@ -73,13 +123,21 @@ namespace LinaEngine::ECS
 
 		DirectionalLightComponent* GetDirLight() { return std::get<1>(m_directionalLight); }
 		virtual void UpdateComponents(float delta) override;
-		void SetLightingShaderData(uint32 shaderID);
+		void PackLightData();
+		void BuildLightClusters(const Matrix& view, const Matrix& projection, float zNear, float zFar, const Vector2& viewportPos, const Vector2& viewportSize);
+		void BuildShadowCascades(const Matrix& view, const Matrix& projection, float zNear, float zFar, const Vector2& atlasResolution);
 		void ResetLightData();
-		Matrix GetDirectionalLightMatrix();
-		Matrix GetDirLightBiasMatrix();
+		const ShadowCascade& GetShadowCascade(int index) { return m_shadowCascades[index]; }
+		int GetShadowCascadeCount() { return m_shadowCascadeCount; }
 		std::vector<Matrix> GetPointLightMatrices();
 		Color& GetAmbientColor() { return m_ambientColor; }
 		const Vector3& GetDirectionalLightPos();
+		const LightArrayData& GetLightData() { return m_lightData; }
+		const std::vector<LightBufferData>& GetLightBufferData() { return m_lightBufferData; }
+		const std::vector<uint32>& GetClusterGrid() { return m_clusterGrid; }
+		const std::vector<uint32>& GetClusterLightIndices() { return m_clusterLightIndices; }
+		int GetPointLightCount() { return m_pointLightCount; }
+		int GetSpotLightCount() { return m_spotLightCount; }
 
 	private:
 
@@ -89,6 +147,15 @@ namespace LinaEngine::ECS
 		std::vector<std::tuple<TransformComponent*, PointLightComponent*>> m_pointLights;
 		std::vector<std::tuple<TransformComponent*, SpotLightComponent*>> m_spotLights;
 		Color m_ambientColor = Color(0.0f, 0.0f, 0.0f);
+		LightArrayData m_lightData;
+		std::vector<LightBufferData> m_lightBufferData;
+		std::vector<uint32> m_clusterGrid;
+		std::vector<uint32> m_clusterLightIndices;
+		std::vector<std::pair<uint32, uint32>> m_clusterAssignments;
+		ShadowCascade m_shadowCascades[SC_MAXSHADOWCASCADES];
+		int m_shadowCascadeCount = 0;
+		int m_pointLightCount = 0;
+		int m_spotLightCount = 0;
 	};
 }
 
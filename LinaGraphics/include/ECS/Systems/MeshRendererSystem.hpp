@@ -29,8 +29,8 @@ SOFTWARE.
 /*
 Class: MeshRendererSystem
 
-Responsible for adding all the mesh renderers into a pool which is then
-flushed to draw those renderers' data by the RenderEngine.
+Responsible for gathering all the mesh renderers into render packets, which are then
+used by the RenderEngine to build the draw list of each view.
 
 Timestamp: 4/27/2019 5:38:44 PM
 */
@@ -43,58 +43,31 @@ Timestamp: 4/27/2019 5:38:44 PM
 #include "ECS/ECSSystem.hpp"
 #include "PackageManager/PAMRenderDevice.hpp"
 #include "Rendering/RenderingCommon.hpp"
-#include "Rendering/RenderTarget.hpp"
-#include "Rendering/VertexArray.hpp"
-#include <queue>
+#include "Rendering/DrawList.hpp"
+#include "Rendering/OcclusionCuller.hpp"
 
 namespace LinaEngine
 {
 	namespace Graphics
 	{
 		class RenderEngine;
-		class Material;
-
-		struct BatchDrawData
-		{
-			Graphics::VertexArray* m_vertexArray;
-			Graphics::Material* m_material;
-			float m_distance;
-		};
-
-		struct BatchModelData
-		{
-			std::vector<Matrix> m_models;
-			std::vector<Matrix> m_inverseTransposeModels;
-		};
 	}
 }
 
 namespace LinaEngine::ECS
 {
+	// Triangles of the gathered packets, at full detail & at the selected levels of detail.
+	struct LODStats
+	{
+		uint32 m_fullTriangles = 0;
+		uint32 m_drawnTriangles = 0;
+	};
+
 	class MeshRendererSystem : public BaseECSSystem
 	{
 
 	public:
 
-		typedef std::tuple<Graphics::BatchDrawData, Graphics::BatchModelData>  BatchPair;
-
-		struct BatchComparison
-		{
-			bool const operator()(const BatchPair& lhs, const BatchPair& rhs) const
-			{
-				
-				return std::get<0>(lhs).m_distance < std::get<0>(rhs).m_distance;
-			}
-		};
-
-		struct BatchDrawDataComp
-		{
-			bool const operator()(const Graphics::BatchDrawData& lhs, const Graphics::BatchDrawData& rhs) const
-			{
-				return std::tie(lhs.m_vertexArray, lhs.m_material) < std::tie(rhs.m_vertexArray, rhs.m_material);
-			}
-		};
-
 		MeshRendererSystem() {};
 
 		void Construct(ECSRegistry& registry, Graphics::RenderEngine& renderEngineIn, RenderDevice& renderDeviceIn)
@@ -104,22 +77,36 @@ namespace LinaEngine::ECS
 			s_renderDevice = &renderDeviceIn;
 		}
 
-		void RenderOpaque(Graphics::VertexArray& vertexArray, Graphics::Material& material, const Matrix& transformIn);
-		void RenderTransparent(Graphics::VertexArray& vertexArray, Graphics::Material& material, const Matrix& transformIn, float priority);
-		void FlushOpaque(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial = nullptr, bool completeFlush = true);
-		void FlushTransparent(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial = nullptr, bool completeFlush = true);
-
+		// Gathers the mesh renderers into render packets, once per frame.
 		virtual void UpdateComponents(float delta) override;
 
+		const std::vector<Graphics::RenderPacket>& GetPackets() { return m_packets; }
+
+		// Static packets at full detail for the cached shadows, independent of the levels selected for the main view.
+		const std::vector<Graphics::RenderPacket>& GetStaticShadowPackets() { return m_staticShadowPackets; }
+
+		// Mesh renderers marked as occluders, gathered along w/ the packets.
+		const std::vector<Graphics::Occluder>& GetOccluders() { return m_occluders; }
+
+		// Changes whenever a static mesh renderer is added, removed, moved or its mesh changes, never w/ the camera.
+		size_t GetStaticStateHash() const { return m_staticStateHash; }
+
+		const LODStats& GetLODStats() const { return m_lodStats; }
+
+	private:
+
+		// Selects the level of detail from the projected size w/ hysteresis around the level thresholds.
+		int SelectLOD(int currentLOD, int lodCount, float screenSize);
 
 	private:
 
 		RenderDevice* s_renderDevice = nullptr;
 		Graphics::RenderEngine* m_renderEngine = nullptr;
-
-		// Map & queue to see the list of same vertex array & textures to compress them into single draw call.
-		std::map<Graphics::BatchDrawData, Graphics::BatchModelData, BatchDrawDataComp> m_opaqueRenderBatch;
-		std::priority_queue<BatchPair, std::vector<BatchPair>, BatchComparison> m_transparentRenderBatch;
+		std::vector<Graphics::RenderPacket> m_packets;
+		std::vector<Graphics::RenderPacket> m_staticShadowPackets;
+		std::vector<Graphics::Occluder> m_occluders;
+		size_t m_staticStateHash = 0;
+		LODStats m_lodStats;
 	};
 }
 
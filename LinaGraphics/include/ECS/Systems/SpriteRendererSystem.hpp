@@ -29,8 +29,9 @@ SOFTWARE.
 /*
 Class: SpriteRendererSystem
 
-Responsible for adding all the sprite renderers into a pool which is then
-flushed to draw those renderers' data by the RenderEngine.
+Responsible for gathering all the sprite renderers into render packets, which are then
+used by the RenderEngine to build the draw list of each view. Sprites whose textures fit the atlas
+are handed to the sprite batcher instead.
 
 Timestamp: 10/1/2020 9:27:40 AM
 */
@@ -44,6 +45,7 @@ Timestamp: 10/1/2020 9:27:40 AM
 #include "PackageManager/PAMRenderDevice.hpp"
 #include "Rendering/VertexArray.hpp"
 #include "Rendering/IndexedModel.hpp"
+#include "Rendering/DrawList.hpp"
 
 namespace LinaEngine
 {
@@ -59,12 +61,6 @@ namespace LinaEngine::ECS
 	class SpriteRendererSystem : public BaseECSSystem
 	{
 
-		struct BatchModelData
-		{
-			std::vector<Matrix> m_models;
-			std::vector<Matrix> m_inverseTransposeModels;
-		};
-
 	public:
 		
 		SpriteRendererSystem() {};
@@ -73,8 +69,7 @@ namespace LinaEngine::ECS
 		void Construct(ECSRegistry& registry, Graphics::RenderEngine& renderEngineIn, RenderDevice& renderDeviceIn);
 		virtual void UpdateComponents(float delta) override;
 
-		void Render(Graphics::Material& material, const Matrix& transformIn);
-		void Flush(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial = nullptr, bool completeFlush = true);
+		const std::vector<Graphics::RenderPacket>& GetPackets() { return m_packets; }
 
 	private:
 	
@@ -82,7 +77,7 @@ namespace LinaEngine::ECS
 		Graphics::VertexArray m_spriteVertexArray;
 		RenderDevice* s_renderDevice = nullptr;
 		Graphics::RenderEngine* m_renderEngine = nullptr;
-		std::map<Graphics::Material*, BatchModelData> m_renderBatch;
+		std::vector<Graphics::RenderPacket> m_packets;
 	};
 }
 
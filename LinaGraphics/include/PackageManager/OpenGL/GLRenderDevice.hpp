@@ -45,6 +45,7 @@ Timestamp: 4/27/2019 10:12:16 PM
 #include "Utility/Math/Color.hpp"
 #include "Rendering/RenderingCommon.hpp"
 #include <map>
+#include <deque>
 
 using namespace LinaEngine;
 
@@ -59,6 +60,7 @@ namespace LinaEngine::Graphics
 		uint32  numBuffers;
 		uint32  numElements;
 		uint32  instanceComponentsStartIndex;
+		bool shortIndices;
 		BufferUsage bufferUsage;
 	};
 
@@ -67,10 +69,40 @@ namespace LinaEngine::Graphics
 	{
 		std::vector<uint32> shaders;
 		std::map<std::string, int32> uniformBlockMap;
-		std::map<std::string, int32> samplerMap;
+
+		// Uniform handles reflected at link time, array elements are stored per index.
 		std::map<std::string, int32> uniformMap;
+
+		// std140 layout of the material parameter block, offsets are keyed by material parameter names.
+		int32 materialBlockSize = 0;
+		std::map<std::string, int32> materialBlockOffsets;
+	};
+
+	// Texture buffer struct for storage, the texture views the buffer's storage.
+	struct TextureBufferData
+	{
+		uint32 buffer = 0;
+		BufferUsage bufferUsage;
 	};
 
+	// Counters of the GL work issued in a frame.
+	struct RenderStats
+	{
+		uint32 m_drawCalls = 0;
+		uint32 m_instancedDrawCalls = 0;
+		uint32 m_indirectCommands = 0;
+		uint32 m_instances = 0;
+		uint32 m_triangles = 0;
+		uint32 m_shaderBinds = 0;
+		uint32 m_textureBinds = 0;
+		uint32 m_uniformCalls = 0;
+		uint32 m_fboSwitches = 0;
+		uint64 m_uploadedBytes = 0;
+	};
+
+	// Number of frames the render stats are kept for.
+	#define RENDERSTATS_HISTORY_SIZE 240
+
 
 	class GLRenderDevice
 	{
@@ -82,6 +114,15 @@ namespace LinaEngine::Graphics
 		// Initializes the devices & params.
 		void Initialize(int width, int height, DrawParams& defaultParams);
 
+		// Closes the render stats of the current frame & starts the next one.
+		void EndFrameStats();
+
+		// Stats of the last completed frame.
+		const RenderStats& GetLastFrameStats() { return m_statsHistory.empty() ? m_frameStats : m_statsHistory.back(); }
+
+		// Stats of the last RENDERSTATS_HISTORY_SIZE frames, oldest first.
+		const std::deque<RenderStats>& GetStatsHistory() { return m_statsHistory; }
+
 		// Creates a texture on GL.
 		uint32 CreateTexture2D(Vector2 size, const void* data,  SamplerParameters samplerParams ,bool compress, bool useBorder = false, Color borderColor = Color::White);
 
@@ -100,6 +141,18 @@ namespace LinaEngine::Graphics
 		// Creates an empty texture 2d
 		uint32 CreateTexture2DEmpty(Vector2 size, SamplerParameters samplerParams);
 
+		// Creates a texture 2d from block compressed levels, levels are ordered from the base level down.
+		uint32 CreateTexture2DCompressed(Vector2 size, TextureCompression compression, bool sRGB, const std::vector<const void*>& levels, const std::vector<uint32>& levelSizes, SamplerParameters samplerParams);
+
+		// Uploads 8 bit pixel data into a region of an existing texture 2d, e.g. a cell of an atlas.
+		void UpdateTexture2DRegion(uint32 texture, Vector2 offset, Vector2 size, const void* data, PixelFormat pixelFormat = PixelFormat::FORMAT_RGBA);
+
+		// Reads back a level of a float texture as half floats, cubemap faces are indexed from positive x.
+		void GetTextureLevelHalf(uint32 texture, TextureBindMode bindMode, uint32 face, uint32 mipLevel, PixelFormat pixelFormat, void* data);
+
+		// Uploads half float pixels into a level of an existing float texture, cubemap faces are indexed from positive x.
+		void UpdateTextureLevelHalf(uint32 texture, TextureBindMode bindMode, uint32 face, uint32 mipLevel, Vector2 size, const void* data, PixelFormat pixelFormat);
+
 		// Sets up texture parameters
 		void SetupTextureParameters(uint32 textureTarget, SamplerParameters samplerParams, bool useBorder = false, float* borderColor = NULL);
 
@@ -110,7 +163,10 @@ namespace LinaEngine::Graphics
 		uint32 ReleaseTexture2D(uint32 texture2D);
 
 		// Creates a vertex array on GL for mesh & model data.
-		uint32 CreateVertexArray(const float** vertexData, const uint32* vertexElementSizes, const uint32* vertexElementTypes, uint32 numVertexComponents, uint32 numInstanceComponents, uint32 numVertices, const uint32* indices, uint32 numIndices, BufferUsage bufferUsage);
+		uint32 CreateVertexArray(const float** vertexData, const uint32* vertexElementSizes, const uint32* vertexElementTypes, uint32 numVertexComponents, uint32 numInstanceComponents, uint32 numVertices, const void* indices, uint32 numIndices, bool shortIndices, BufferUsage bufferUsage);
+
+		// Creates a vertex array w/ all vertex attributes in a single buffer, instanced elements get a buffer each starting from the instance location.
+		uint32 CreateInterleavedVertexArray(const void* vertexData, uint32 vertexStride, const VertexAttribute* attributes, uint32 numAttributes, uint32 numVertices, const uint32* instanceElementSizes, uint32 numInstanceComponents, uint32 instanceLocation, const void* indices, uint32 numIndices, bool shortIndices, BufferUsage bufferUsage);
 
 		// Creates a skybox vertex array.
 		uint32 CreateSkyboxVertexArray();
@@ -139,9 +195,39 @@ namespace LinaEngine::Graphics
 		// Releases a previously created buffer from GL.
 		uint32 ReleaseUniformBuffer(uint32 buffer);
 
+		// Creates a buffer texture on GL, sampled w/ texelFetch in shaders, returns the texture.
+		uint32 CreateTextureBuffer(PixelFormat internalFormat, const void* data, uintptr dataSize, BufferUsage usage);
+
+		// Re-specifies the storage of a buffer texture, allows dynamic size change.
+		void UpdateTextureBuffer(uint32 texture, const void* data, uintptr dataSize);
+
+		// Releases a previously created buffer texture & its storage from GL.
+		uint32 ReleaseTextureBuffer(uint32 texture);
+
+		// Creates a query object on GL.
+		uint32 CreateQuery();
+
+		// Starts measuring the GPU time of the commands issued until EndTimeQuery, queries can not be nested.
+		void BeginTimeQuery(uint32 query);
+
+		// Ends the active time query.
+		void EndTimeQuery();
+
+		// Returns whether the result of a query can be read w/o waiting for the GPU.
+		bool IsQueryResultAvailable(uint32 query);
+
+		// Returns the result of a query, elapsed nanoseconds for time queries. Blocks if the result is not available.
+		uint64 GetQueryResult(uint32 query);
+
+		// Releases a previously created query object from GL.
+		uint32 ReleaseQuery(uint32 query);
+
 		// Creates a shader program based on shader text on GL.
 		uint32 CreateShaderProgram(const std::string& shaderText, bool usesGeometryShader);
 
+		// Linked programs are stored in & loaded from the directory, empty or unsupported drivers disable the cache.
+		void SetProgramBinaryCache(const std::string& directory);
+
 		// Runs glValidate on the target program.
 		bool ValidateShaderProgram(uint32 shader);
 
@@ -199,6 +285,9 @@ namespace LinaEngine::Graphics
 		// Binds a buffer object to a binding point on GL buffer, then binds the program uniform block to that points.
 		void BindUniformBuffer(uint32 buffer, uint32 bindingPoint);
 
+		// Binds a range of a buffer object to a binding point on GL buffer.
+		void BindUniformBufferRange(uint32 buffer, uint32 bindingPoint, uintptr offset, uintptr size);
+
 		// Binds a shader to unifor block binding point.
 		void BindShaderBlockToBufferPoint(uint32 shader, uint32 blockPoint, std::string& blockName);
 
@@ -214,8 +303,14 @@ namespace LinaEngine::Graphics
 		// Sets draw parameters.
 		void SetDrawParameters(const DrawParams& drawParams);
 
-		// Actual drawing process for meshes.
-		void Draw(uint32 vao, const DrawParams& drawParams, uint32 numInstances, uint32 numElements, bool drawArrays = false);
+		// Actual drawing process for meshes, first index offsets into the element buffer.
+		void Draw(uint32 vao, const DrawParams& drawParams, uint32 numInstances, uint32 numElements, bool drawArrays = false, uint32 firstIndex = 0);
+
+		// Whether multi draw indirect w/ base instances is available, requires GL 4.3.
+		bool SupportsMultiDrawIndirect();
+
+		// Submits all commands w/ a single draw, the commands are uploaded to the shared indirect buffer.
+		void MultiDrawIndirect(uint32 vao, const DrawParams& drawParams, const DrawElementsIndirectCommand* commands, uint32 numCommands);
 
 		// Draws line bw two points
 		void DrawLine(float width);
@@ -224,6 +319,24 @@ namespace LinaEngine::Graphics
 		// Clears context.
 		void Clear(bool shouldClearColor, bool shouldClearDepth, bool shouldClearStencil, const class Color& color, uint32 stencil);
 
+		// Returns the handle of a uniform reflected on link time, -1 if the uniform is not active.
+		int32 GetUniformHandle(uint32 shader, const std::string& uniform);
+
+		// Returns the std140 size of the material parameter block of a shader, 0 if the shader has none.
+		int32 GetMaterialBlockSize(uint32 shader);
+
+		// Returns the offset of a material parameter within the material block, -1 if it is not a block member.
+		int32 GetMaterialBlockOffset(uint32 shader, const std::string& uniform);
+
+		// Updates uniforms on the currently bound shader via handles returned by GetUniformHandle.
+		void UpdateShaderUniformFloat(int32 handle, const float f);
+		void UpdateShaderUniformInt(int32 handle, const int f);
+		void UpdateShaderUniformColor(int32 handle, const Color& color);
+		void UpdateShaderUniformVector2(int32 handle, const Vector2& m);
+		void UpdateShaderUniformVector3(int32 handle, const Vector3& m);
+		void UpdateShaderUniformVector4F(int32 handle, const Vector4& m);
+		void UpdateShaderUniformMatrix(int32 handle, const Matrix& m);
+
 		// Updates a float type uniform on a shader w/ given name.
 		void UpdateShaderUniformFloat(uint32 shader, const std::string& uniform, const float f);
 
@@ -279,6 +392,9 @@ namespace LinaEngine::Graphics
 		void SetStencilTest(bool enable, DrawFunc stencilFunc, uint32 stencilTestMask, uint32 stencilWriteMask, int32 stencilComparisonVal, StencilOp stencilFail, StencilOp stencilPassButDepthFail, StencilOp stencilPass);
 		void SetScissorTest(bool enable, uint32 startX = 0, uint32 startY = 0, uint32 width = 0, uint32 height = 0);
 
+		// Uploads w/o data only allocate storage & are not counted.
+		void AddUploadStats(const void* data, uint64 size) { if (data != nullptr) m_frameStats.m_uploadedBytes += size; }
+
 
 	private:
 
@@ -304,7 +420,7 @@ namespace LinaEngine::Graphics
 		uint32 m_boundRBO = 0;
 
 		// Currently bound uniform buffer
-		uint32 m_boundUBO;
+		uint32 m_boundUBO = 0;
 
 		// Currently bound texture unit
 		uint32 m_boundTextureUnit;
@@ -321,12 +437,28 @@ namespace LinaEngine::Graphics
 		// Shader program map w/ ids.
 		std::map<uint32, ShaderProgram> m_shaderProgramMap;
 
+		// Buffer texture map w/ texture ids.
+		std::map<uint32, TextureBufferData> m_textureBufferMap;
+
+		// Indirect draw commands are streamed through this buffer.
+		uint32 m_indirectBuffer = 0;
+		uintptr m_indirectBufferSize = 0;
+
 		// Storage for shader version.
 		std::string m_ShaderVersion;
 
+		// Program binaries are only valid for the driver that created them, cache files are keyed w/ its identity.
+		std::string m_programCachePath = "";
+		std::string m_driverIdentity = "";
+		bool m_programBinarySupported = false;
+
 		// Storage for gl version data.
 		uint32 m_GLVersion;
 
+		// Stats of the frame being drawn & the completed ones.
+		RenderStats m_frameStats;
+		std::deque<RenderStats> m_statsHistory;
+
 		// Current drawing parameters.
 		FaceCulling m_usedFaceCulling;
 		DrawFunc m_usedDepthFunction;
@@ -66,6 +66,7 @@ namespace LinaEngine::Graphics
 		static void SetImageFlip(bool flip);
 		static unsigned char* LoadImmediate(const char* filename, int& w, int& h,  int& nrchannels);
 		static float* LoadImmediateHDRI(const char* fileName, int& w, int& h, int& nrChannels);
+		static void FreeImmediate(void* data);
 
 		// Clr colors.
 		void Clear(int32 color);
@@ -0,0 +1,142 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: DrawList
+
+The scene is gathered once per frame into view independent render packets. Each view, main camera,
+shadow casting light or an additional camera rendering to a target, builds its own draw list from
+them, culled against the view's frustum & sorted for drawing.
+
+Timestamp: 11/2/2020 3:41:12 PM
+*/
+
+#pragma once
+
+#ifndef DrawList_HPP
+#define DrawList_HPP
+
+#include "Rendering/RenderingCommon.hpp"
+#include "PackageManager/PAMRenderDevice.hpp"
+
+namespace LinaEngine::Graphics
+{
+	class VertexArray;
+	class Material;
+	class RenderEngine;
+	class OcclusionCuller;
+
+	// Which packets of a gathered set a draw list takes.
+	enum class PacketFilter
+	{
+		All,
+		Static,
+		Dynamic
+	};
+
+	// A single drawable gathered from the scene, data that does not depend on any view.
+	struct RenderPacket
+	{
+		VertexArray* m_vertexArray = nullptr;
+		Material* m_material = nullptr;
+		Matrix m_model;
+		Vector3 m_boundsCenter = Vector3::Zero;
+		float m_boundsRadius = 0.0f;
+		uint32 m_modelBufferIndex = 0;
+
+		// Range of the vertex array's indices to draw, a zero count draws all of them. Set by the static batcher for its cells.
+		uint32 m_firstIndex = 0;
+		uint32 m_indexCount = 0;
+
+		bool m_isTransparent = false;
+		bool m_isStatic = false;
+	};
+
+	// Per instance data, the rows of the affine model matrix. Normal matrices are derived in the vertex shaders.
+	struct InstanceTransform
+	{
+		Vector4 m_rows[3];
+	};
+
+	// A camera the scene is drawn from.
+	struct RenderView
+	{
+		Matrix m_view;
+		Matrix m_projection;
+		Vector3 m_location = Vector3::Zero;
+		float m_zNear = 0.01f;
+		float m_zFar = 1000.0f;
+		Vector2 m_viewportPos = Vector2::Zero;
+		Vector2 m_viewportSize = Vector2::One;
+	};
+
+	class DrawList
+	{
+	public:
+
+		DrawList() {};
+		~DrawList() {};
+
+		// Starts a new list for the view, previous contents are cleared.
+		void Begin(const RenderView& view);
+
+		// Adds the packets that are visible from the view & pass the filter, optionally tested against the occluders.
+		void Add(const std::vector<RenderPacket>& packets, PacketFilter filter = PacketFilter::All, OcclusionCuller* occlusionCuller = nullptr);
+
+		// Sorts the list, opaque packets are grouped by material & vertex array to be drawn instanced, transparent ones back to front.
+		void End();
+
+		// Draws the list w/ the packets' own materials or the override material. Opaque packets drawing different ranges
+		// of the same vertex array w/ the same material are submitted as a single multi draw indirect when supported.
+		// Only the static batch cells share vertex arrays, other meshes are instanced per vertex array & material.
+		void Flush(RenderEngine& renderEngine, RenderDevice& renderDevice, DrawParams& drawParams, Material* overrideMaterial = nullptr);
+
+		// Sets the world space bounds of the packet from its vertex array & model matrix.
+		static void CalculatePacketBounds(RenderPacket& packet);
+
+		size_t GetOpaqueCount() const { return m_opaquePackets.size(); }
+		size_t GetTransparentCount() const { return m_transparentPackets.size(); }
+
+	private:
+
+		void DrawInstances(RenderEngine& renderEngine, RenderDevice& renderDevice, DrawParams& drawParams, Material* material, const RenderPacket* packet);
+		void UploadInstances(VertexArray* vertexArray, uint32 modelBufferIndex, size_t first, size_t count);
+
+	private:
+
+		RenderView m_view;
+		Vector4 m_frustumPlanes[6];
+		std::vector<const RenderPacket*> m_opaquePackets;
+		std::vector<std::pair<float, const RenderPacket*>> m_transparentPackets;
+		std::vector<Matrix> m_models;
+		std::vector<InstanceTransform> m_instanceTransforms;
+		std::vector<DrawElementsIndirectCommand> m_commands;
+	};
+}
+
+#endif
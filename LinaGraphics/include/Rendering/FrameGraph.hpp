@@ -0,0 +1,158 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/*
+Class: FrameGraph
+
+Collects the render passes of a frame w/ the resources they read & write. Compiling culls the passes whose
+outputs are never read & computes the lifetime of transient resources, executing binds each pass' target,
+applies the first-write clears & hands transient targets in & out of the render target pool around their lifetime.
+
+Timestamp: 10/20/2020 3:27:45 PM
+*/
+
+#pragma once
+
+#ifndef FrameGraph_HPP
+#define FrameGraph_HPP
+
+#include "Rendering/RenderTargetPool.hpp"
+#include "Utility/Math/Color.hpp"
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+#define FRAMEGRAPH_INVALIDRESOURCE -1
+
+namespace LinaEngine::Graphics
+{
+	class GPUTimer;
+
+	typedef int FrameGraphResource;
+
+	// Clear applied before the first pass writing to a resource.
+	struct FrameGraphClear
+	{
+		bool m_color = false;
+		bool m_depth = false;
+		bool m_stencil = false;
+		Color m_clearColor = Color::Black;
+	};
+
+	class FrameGraphPass
+	{
+
+	public:
+
+		void Read(FrameGraphResource resource) { if (resource != FRAMEGRAPH_INVALIDRESOURCE) m_reads.push_back(resource); }
+
+		// First written resource is the one bound for the pass.
+		void Write(FrameGraphResource resource) { if (resource != FRAMEGRAPH_INVALIDRESOURCE) m_writes.push_back(resource); }
+
+		// Passes w/ side effects, e.g. the ones writing to the screen, are never culled.
+		void SetSideEffect() { m_hasSideEffect = true; }
+
+	private:
+
+		friend class FrameGraph;
+
+		std::string m_name = "";
+		std::string m_timerName = "";
+		std::function<void()> m_execute;
+		std::vector<FrameGraphResource> m_reads;
+		std::vector<FrameGraphResource> m_writes;
+		bool m_hasSideEffect = false;
+		bool m_culled = false;
+		int m_refCount = 0;
+	};
+
+	class FrameGraph
+	{
+
+	public:
+
+		FrameGraph() {};
+		~FrameGraph() {};
+
+		void Construct(RenderDevice& renderDevice, RenderTargetPool& pool, GPUTimer& timer);
+
+		// Removes the passes & resources of the previous frame.
+		void Reset();
+
+		// Adds a target owned outside of the graph, fbo 0 is the default frame buffer.
+		FrameGraphResource Import(const std::string& name, uint32 fbo, Texture* texture, const Vector2& pos, const Vector2& size, const FrameGraphClear& clear = FrameGraphClear());
+
+		// Adds a target that is taken from the pool for the passes using it.
+		FrameGraphResource Create(const std::string& name, const Vector2& size, const SamplerParameters& params, const FrameGraphClear& clear = FrameGraphClear());
+
+		// Passes sharing a timer name in a row are timed as one, empty name is not timed.
+		FrameGraphPass& AddPass(const std::string& name, const std::string& timerName, std::function<void()> execute);
+
+		// Culls the unused passes & finds the first & last pass using each resource.
+		void Compile();
+
+		// Runs the passes that survived the compile in the order they are added.
+		void Execute();
+
+		// Only valid while the passes are executing for transient resources.
+		Texture* GetTexture(FrameGraphResource resource) { return m_resources[resource].m_texture; }
+		const Vector2& GetSize(FrameGraphResource resource) { return m_resources[resource].m_size; }
+
+		int GetCulledPassCount() const { return m_culledPassCount; }
+
+	private:
+
+		struct ResourceNode
+		{
+			std::string m_name = "";
+			uint32 m_fbo = 0;
+			Texture* m_texture = nullptr;
+			PooledRenderTarget* m_pooled = nullptr;
+			Vector2 m_pos = Vector2::Zero;
+			Vector2 m_size = Vector2::Zero;
+			SamplerParameters m_params;
+			FrameGraphClear m_clear;
+			bool m_imported = false;
+			bool m_cleared = false;
+			int m_refCount = 0;
+			int m_firstPass = -1;
+			int m_lastPass = -1;
+		};
+
+		RenderDevice* m_renderDevice = nullptr;
+		RenderTargetPool* m_pool = nullptr;
+		GPUTimer* m_timer = nullptr;
+		std::deque<FrameGraphPass> m_passes;
+		std::vector<ResourceNode> m_resources;
+		int m_culledPassCount = 0;
+	};
+}
+
+#endif
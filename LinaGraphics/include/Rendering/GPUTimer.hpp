@@ -0,0 +1,102 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/*
+Class: GPUTimer
+
+Measures the GPU time of render passes w/ timer queries. Results are read a few frames later so the CPU
+never waits on the GPU & are published through the Timer map as "[GPU] <pass>".
+
+Timestamp: 10/18/2020 5:41:12 PM
+*/
+
+#pragma once
+
+#ifndef GPUTimer_HPP
+#define GPUTimer_HPP
+
+#include "PackageManager/PAMRenderDevice.hpp"
+#include <map>
+#include <string>
+
+#ifdef LINA_ENABLE_TIMEPROFILING
+
+#define LINA_GPUTIMER_START(timer, name) (timer).Begin(name)
+#define LINA_GPUTIMER_STOP(timer) (timer).End()
+
+#else
+
+#define LINA_GPUTIMER_START(timer, name) ((void)0)
+#define LINA_GPUTIMER_STOP(timer) ((void)0)
+
+#endif
+
+// Number of frames a query is given before its result is read.
+#define GPUTIMER_FRAME_LATENCY 4
+
+namespace LinaEngine::Graphics
+{
+	class GPUTimer
+	{
+
+	public:
+
+		GPUTimer() {};
+		~GPUTimer() {};
+
+		void Construct(RenderDevice& renderDevice) { m_renderDevice = &renderDevice; }
+
+		// Starts timing a pass, passes can not be nested.
+		void Begin(const std::string& name);
+
+		// Ends the active pass.
+		void End();
+
+		// Reads the results that became available & moves on to the next frame's queries.
+		void EndFrame();
+
+		// Releases all query objects.
+		void Release();
+
+	private:
+
+		struct PassQueries
+		{
+			uint32 m_queries[GPUTIMER_FRAME_LATENCY] = {};
+			bool m_pending[GPUTIMER_FRAME_LATENCY] = {};
+		};
+
+		RenderDevice* m_renderDevice = nullptr;
+		std::map<std::string, PassQueries> m_passes;
+		uint32 m_frameIndex = 0;
+		bool m_isActive = false;
+	};
+}
+
+#endif
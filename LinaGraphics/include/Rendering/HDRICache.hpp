@@ -0,0 +1,99 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/*
+Class: HDRICache
+
+Binary container for the precomputed HDRI environment maps. Images are stored as half float levels,
+the header key identifies the source content & the resolutions they were computed with.
+
+Timestamp: 11/28/2020 2:41:37 PM
+*/
+
+#pragma once
+
+#ifndef HDRICache_HPP
+#define HDRICache_HPP
+
+#include "Core/Common.hpp"
+#include "Core/SizeDefinitions.hpp"
+#include <string>
+#include <vector>
+
+// "LENV" in little endian.
+#define HDRICACHE_MAGIC 0x564E454C
+#define HDRICACHE_VERSION 2
+#define HDRICACHE_EXTENSION ".hdricache"
+
+// Limits a cache file is checked against before anything is allocated for it.
+#define HDRICACHE_MAXIMAGES 256
+#define HDRICACHE_MAXSIZE 8192
+#define HDRICACHE_MAXCHANNELS 4
+
+namespace LinaEngine::Graphics
+{
+	enum HDRICacheMap
+	{
+		HDRIMAP_CUBEMAP = 0,
+		HDRIMAP_IRRADIANCE = 1,
+		HDRIMAP_PREFILTER = 2,
+		HDRIMAP_BRDFLUT = 3,
+		HDRIMAP_IRRADIANCESH = 4
+	};
+
+	// A single face & mip level of one of the maps.
+	struct HDRICacheImage
+	{
+		HDRICacheMap m_map = HDRICacheMap::HDRIMAP_CUBEMAP;
+		uint32 m_face = 0;
+		uint32 m_mip = 0;
+		uint32 m_width = 0;
+		uint32 m_height = 0;
+		uint32 m_channels = 0;
+		std::vector<uint16> m_pixels;
+	};
+
+	class HDRICache
+	{
+
+	public:
+
+		// FNV-1a over the given bytes, chained through the hash argument.
+		static uint64 HashBytes(const void* data, size_t size, uint64 hash = 14695981039346656037ull);
+
+		// Hashes the contents of the file, returns 0 if it can't be read.
+		static uint64 HashFile(const std::string& path);
+
+		// Fails if the file is missing, corrupt or was written for a different key.
+		static bool Read(const std::string& path, uint64 key, std::vector<HDRICacheImage>& images);
+		static bool Write(const std::string& path, uint64 key, const std::vector<HDRICacheImage>& images);
+	};
+}
+
+#endif
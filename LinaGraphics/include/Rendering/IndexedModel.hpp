@@ -53,6 +53,20 @@ namespace LinaEngine::Graphics
 		// Creates a vertex array using render renderEngine.
 		uint32 CreateVertexArray(RenderDevice& engine, BufferUsage bufferUsage) const;
 
+		// Packs the lit layout into a single quantized buffer on vertex array creation, uv as half floats, normal & tangent
+		// octahedral encoded w/ the bitangent sign. Positions are optionally stored as 16 bit values relative to the bounds.
+		void SetInterleaved(bool interleaved, bool quantizePositions) { m_interleaved = interleaved; m_quantizePositions = quantizePositions; }
+
+		// Whether the vertex array will be created interleaved, requires the positions, tex coords, normals & tangents.
+		bool IsInterleaved() const;
+
+		// Index of the first instance buffer of the created vertex array.
+		uint32 GetInstanceBufferIndex() const;
+
+		// Matrix that maps the quantized positions back to the model space.
+		bool HasQuantizedPositions() const { return m_quantizePositions && IsInterleaved(); }
+		Matrix GetPositionDequantization() const;
+
 		// Sets the element size array according to the desired size.
 		void AllocateElement(uint32 elementSize, bool isFloat);
 
@@ -70,6 +84,17 @@ namespace LinaEngine::Graphics
 
 		// Gets the element array
 		std::vector<std::vector<float>>& GetElements() { return m_elements; }
+		const std::vector<std::vector<float>>& GetElements() const { return m_elements; }
+
+		// Gets the component count of each element.
+		const std::vector<uint32>& GetElementSizes() const { return m_elementSizes; }
+
+		// Gets the index array
+		std::vector<uint32>& GetIndices() { return m_indices; }
+		const std::vector<uint32>& GetIndices() const { return m_indices; }
+
+		// Index of the first instanced element, -1 if there are none.
+		uint32 GetStartIndex() const { return m_startIndex; }
 
 		// Sets the start index for instanced elements.
 		void SetStartIndex(uint32 elementIndex) { m_startIndex = elementIndex; }
@@ -77,6 +102,9 @@ namespace LinaEngine::Graphics
 		// Accessor for num m_Indices.
 		uint32 GetIndexCount() const { return m_indices.size(); }
 
+		// Calculates a bounding sphere around the positions, which are expected to be the first element.
+		void CalculateBoundingSphere(Vector3& center, float& radius) const;
+
 	private:
 
 		// Index & element data.
@@ -88,6 +116,9 @@ namespace LinaEngine::Graphics
 		// Start index for instanced elements.
 		uint32 m_startIndex = 0;
 
+		bool m_interleaved = false;
+		bool m_quantizePositions = false;
+
 	};
 }
 
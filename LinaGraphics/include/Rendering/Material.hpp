@@ -72,6 +72,32 @@ namespace LinaEngine::Graphics
 
 	};
 
+	// Where a material parameter goes, either a std140 offset in the material block or a plain uniform.
+	struct MaterialParameterHandle
+	{
+		int32 m_location = -1;
+		int32 m_blockOffset = -1;
+	};
+
+	// Uniform handles of a material, laid out in the iteration order of its parameter maps.
+	struct MaterialUniformHandles
+	{
+		uint32 m_shaderID = 0;
+		uint32 m_parameterGeneration = 0;
+		int32 m_blockSize = 0;
+		bool m_hasLooseUniforms = false;
+		std::vector<MaterialParameterHandle> m_floats;
+		std::vector<MaterialParameterHandle> m_bools;
+		std::vector<MaterialParameterHandle> m_colors;
+		std::vector<MaterialParameterHandle> m_ints;
+		std::vector<MaterialParameterHandle> m_vector2s;
+		std::vector<MaterialParameterHandle> m_vector3s;
+		std::vector<MaterialParameterHandle> m_vector4s;
+		std::vector<MaterialParameterHandle> m_matrices;
+		std::vector<int32> m_samplerTextures;
+		std::vector<int32> m_samplerActives;
+	};
+
 	class Material
 	{
 
@@ -100,18 +126,19 @@ namespace LinaEngine::Graphics
 
 		void SetFloat(const std::string& name, float value)
 		{
-			m_floats[name] = value;
+			SetParameter(m_floats, name, value);
 		}
 
 
 		void SetBool(const std::string& name, bool value)
 		{
-			m_bools[name] = value;
+			SetParameter(m_bools, name, value);
+			m_shaderVariantDirty = true;
 		}
 
 		void SetInt(const std::string& name, int value)
 		{
-			m_ints[name] = value;
+			SetParameter(m_ints, name, value);
 
 			if (name == MAT_SURFACETYPE)
 				m_surfaceType = static_cast<MaterialSurfaceType>(value);
@@ -119,27 +146,27 @@ namespace LinaEngine::Graphics
 
 		void SetColor(const std::string& name, const Color& color)
 		{
-			m_colors[name] = color;
+			SetParameter(m_colors, name, color);
 		}
 
 		void SetVector2(const std::string& name, const Vector2& vector)
 		{
-			m_vector2s[name] = vector;
+			SetParameter(m_vector2s, name, vector);
 		}
 
 		void SetVector3(const std::string& name, const Vector3& vector)
 		{
-			m_vector3s[name] = vector;
+			SetParameter(m_vector3s, name, vector);
 		}
 
 		void SetVector4(const std::string& name, const Vector4& vector)
 		{
-			m_vector4s[name] = vector;
+			SetParameter(m_vector4s, name, vector);
 		}
 
 		void SetMatrix4(const std::string& name, const Matrix& matrix)
 		{
-			m_matrices[name] = matrix;
+			SetParameter(m_matrices, name, matrix);
 		}
 
 		float GetFloat(const std::string& name)
@@ -182,10 +209,17 @@ namespace LinaEngine::Graphics
 			return m_matrices[name];
 		}
 
+		// Flags the parameter block for re-upload & the variant for selecting again, needed when the parameter maps are edited in place.
+		void SetDirty() { m_blockDirty = true; m_shaderVariantDirty = true; }
+
+		// Flags the uniform handles for resolving again, needed when parameters are added to or removed from the maps directly.
+		void SetParametersChanged() { m_parameterGeneration++; m_blockDirty = true; }
+
 		int GetID() const { return m_materialID; }
 		const std::string& GetPath() const { return m_path; }
 		Shaders GetShaderType() { return m_shaderType; }
-		uint32 GetShaderID() { return m_shaderID; }
+		// Resolves the shader variant matching the active textures & bools, compiling it on first use.
+		uint32 GetShaderID();
 
 		void SetSurfaceType(MaterialSurfaceType type)
 		{
@@ -225,6 +259,27 @@ namespace LinaEngine::Graphics
 		static std::set<Material*> s_shadowMappedMaterials;
 		static std::set<Material*> s_hdriMaterials;
 
+	private:
+
+		// Textures are active when bound & enabled, other parameters are looked up as bools.
+		bool IsFeatureActive(const std::string& parameter);
+
+		// Handles need to be resolved again when the shader or the parameter layout changes.
+		bool UniformHandlesValid() const
+		{
+			return m_uniformHandles.m_shaderID == m_shaderID && m_uniformHandles.m_parameterGeneration == m_parameterGeneration;
+		}
+
+		// Adding a parameter changes the layout the uniform handles were resolved for.
+		template<typename T>
+		void SetParameter(std::map<std::string, T>& parameters, const std::string& name, const T& value)
+		{
+			if (parameters.insert_or_assign(name, value).second)
+				m_parameterGeneration++;
+
+			m_blockDirty = true;
+		}
+
 	private:
 
 		friend class RenderEngine;
@@ -233,6 +288,16 @@ namespace LinaEngine::Graphics
 		int m_materialID = -1;
 		std::string m_path = "";
 		uint32 m_shaderID = 0;
+		uint32 m_shaderVariant = 0;
+		bool m_shaderVariantDirty = true;
+		uint32 m_shaderGeneration = 0;
+		uint32 m_parameterGeneration = 0;
+		MaterialUniformHandles m_uniformHandles;
+
+		// CPU copy of the std140 parameter block & its uniform buffer, uploaded only when dirty.
+		std::vector<uint8> m_blockData;
+		uint32 m_blockBuffer = 0;
+		bool m_blockDirty = true;
 
 		Shaders m_shaderType = Shaders::Standard_Unlit;
 		MaterialSurfaceType m_surfaceType = MaterialSurfaceType::Opaque;
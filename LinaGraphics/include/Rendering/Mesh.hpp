@@ -43,6 +43,8 @@ Timestamp: 5/6/2019 4:23:45 PM
 
 #include "Rendering/Texture.hpp"
 #include "Rendering/IndexedModel.hpp"
+#include "Rendering/MeshOptimizer.hpp"
+#include "Rendering/OcclusionCuller.hpp"
 #include "Rendering/Material.hpp"
 
 namespace LinaEngine::Graphics
@@ -84,6 +86,24 @@ namespace LinaEngine::Graphics
 			return m_vertexArrays;
 		}
 
+		// Vertex array of the sub-mesh at the level of detail, level 0 is the full detail mesh.
+		VertexArray* GetLODVertexArray(uint32 lod, uint32 index)
+		{
+			if (lod == 0 || lod > m_lodVertexArrays.size())
+				return GetVertexArray(index);
+
+			return m_lodVertexArrays[lod - 1][index];
+		}
+
+		// Number of levels of detail including the full detail mesh.
+		uint32 GetLODCount() const { return (uint32)m_lodVertexArrays.size() + 1; }
+
+		// Cache efficiency of each indexed model before & after the import optimization, empty if it is disabled.
+		const std::vector<MeshOptimizationReport>& GetOptimizationReports() const { return m_optimizationReports; }
+
+		// Geometry of each sub mesh rasterized when the mesh is an occluder, taken from the coarsest level of detail.
+		const std::vector<OccluderGeometry>& GetOccluderGeometry() const { return m_occluderGeometry; }
+
 		std::vector<IndexedModel>& GetIndexedModels()
 		{
 			return m_indexedModelArray;
@@ -119,7 +139,10 @@ namespace LinaEngine::Graphics
 
 		MeshParameters m_parameters;
 		std::vector<VertexArray*> m_vertexArrays;
+		std::vector<std::vector<VertexArray*>> m_lodVertexArrays;
 		std::vector<IndexedModel> m_indexedModelArray;
+		std::vector<MeshOptimizationReport> m_optimizationReports;
+		std::vector<OccluderGeometry> m_occluderGeometry;
 		std::vector<ModelMaterial> m_materialSpecArray;
 		std::vector<uint32> m_materialIndexArray;
 
@@ -0,0 +1,86 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/*
+Class: MeshOptimizer
+
+Post-import optimization of indexed models. Triangles are reordered for the post-transform vertex cache,
+clusters of them are ordered outside in to reduce overdraw & vertices are reordered by first use for fetch
+locality. Cache efficiency is measured before & after.
+
+Timestamp: 10/23/2020 4:05:52 PM
+*/
+
+#pragma once
+
+#ifndef MeshOptimizer_HPP
+#define MeshOptimizer_HPP
+
+#include "Rendering/IndexedModel.hpp"
+
+// Cache size the triangle order is optimized for.
+#define MESHOPT_CACHESIZE 32
+
+// FIFO cache size the efficiency is measured with, close to the post-transform caches of actual hardware.
+#define MESHOPT_ANALYZECACHESIZE 16
+
+namespace LinaEngine::Graphics
+{
+	// Average cache miss ratio per triangle & per vertex, before & after optimizing.
+	struct MeshOptimizationReport
+	{
+		float m_acmrBefore = 0.0f;
+		float m_atvrBefore = 0.0f;
+		float m_acmrAfter = 0.0f;
+		float m_atvrAfter = 0.0f;
+	};
+
+	class MeshOptimizer
+	{
+
+	public:
+
+		// Runs all stages on the model in place.
+		static MeshOptimizationReport Optimize(IndexedModel& model);
+
+		// Reorders the triangles to maximize post-transform cache hits, w/ Forsyth's linear speed algorithm.
+		static void OptimizeVertexCache(std::vector<uint32>& indices, uint32 vertexCount);
+
+		// Splits the cache optimized order into clusters at cache flushes & sorts them to draw the outer facing ones first.
+		static void OptimizeOverdraw(std::vector<uint32>& indices, const std::vector<float>& positions, uint32 vertexCount);
+
+		// Reorders the vertices in the order the triangles first reference them.
+		static void OptimizeVertexFetch(IndexedModel& model);
+
+		// Simulates a FIFO cache, ACMR is misses per triangle, ATVR misses per referenced vertex.
+		static void AnalyzeVertexCache(const std::vector<uint32>& indices, uint32 vertexCount, float& acmr, float& atvr);
+	};
+}
+
+#endif
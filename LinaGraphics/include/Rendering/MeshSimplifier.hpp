@@ -0,0 +1,63 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/*
+Class: MeshSimplifier
+
+Reduces the triangle count of indexed models for levels of detail. Vertices w/ identical attributes are welded
+first, then edges are collapsed in the order of the least quadric error. Vertices on open borders & attribute seams
+are kept in place so the silhouette and texture mapping are preserved.
+
+Timestamp: 10/22/2020 10:41:26 AM
+*/
+
+#pragma once
+
+#ifndef MeshSimplifier_HPP
+#define MeshSimplifier_HPP
+
+#include "Rendering/IndexedModel.hpp"
+
+// Levels are not reduced below this many triangles.
+#define LOD_MINTRIANGLES 32
+
+namespace LinaEngine::Graphics
+{
+	class MeshSimplifier
+	{
+
+	public:
+
+		// Simplifies the source into the target until it has at most the target index count or no edge can be collapsed.
+		// Target keeps the source layout w/ the unused vertices removed, returns the largest collapse error.
+		static float Simplify(const IndexedModel& source, IndexedModel& target, uint32 targetIndexCount);
+	};
+}
+
+#endif
@@ -0,0 +1,148 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/*
+Class: OcclusionCuller
+
+Software occlusion culling for the main view. Occluder meshes are rasterized on the CPU into a low resolution
+depth buffer, split into horizontal bands that are cleared & rasterized by worker threads 4 pixels at a time.
+A hierarchy of max depths is built on top of it & the bounds of the gathered packets are tested against it
+before they are added to the draw list.
+
+Timestamp: 11/24/2020 2:18:36 PM
+*/
+
+#pragma once
+
+#ifndef OcclusionCuller_HPP
+#define OcclusionCuller_HPP
+
+#include "Rendering/DrawList.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Resolution of the occlusion depth buffer, both must be powers of two & the width a multiple of 4.
+#define OCCLUSION_BUFFERWIDTH 256
+#define OCCLUSION_BUFFERHEIGHT 128
+
+// Number of threads rasterizing the occluders, each takes an equal band of rows.
+#define OCCLUSION_WORKERCOUNT 4
+
+namespace LinaEngine::Graphics
+{
+	// Model space positions & triangle indices an occluder is rasterized from.
+	struct OccluderGeometry
+	{
+		std::vector<float> m_positions;
+		std::vector<uint32> m_indices;
+	};
+
+	// An occluder gathered from the scene.
+	struct Occluder
+	{
+		const OccluderGeometry* m_geometry = nullptr;
+		Matrix m_model;
+	};
+
+	struct OcclusionStats
+	{
+		uint32 m_occluderTriangles = 0;
+		uint32 m_testedBounds = 0;
+		uint32 m_occludedBounds = 0;
+	};
+
+	class OcclusionCuller
+	{
+
+	public:
+
+		OcclusionCuller() {};
+		~OcclusionCuller() { Release(); };
+
+		// Starts the worker threads.
+		void Construct();
+
+		// Stops & joins the worker threads.
+		void Release();
+
+		// Starts a new frame for the view, previous occluders are dropped.
+		void Begin(const RenderView& view);
+
+		// Transforms & clips the occluder's triangles to the screen.
+		void AddOccluder(const OccluderGeometry& geometry, const Matrix& model);
+
+		// Rasterizes the added occluders on the workers & builds the depth hierarchy.
+		void End();
+
+		// Whether the world space box is completely behind the occluders.
+		bool IsOccluded(const Vector3& boundsMin, const Vector3& boundsMax);
+
+		// Whether the box around the bounding sphere is completely behind the occluders.
+		bool IsOccluded(const Vector3& center, float radius);
+
+		const OcclusionStats& GetStats() const { return m_stats; }
+
+		// Depth of the nearest occluder per pixel, 1 where there is none.
+		const std::vector<float>& GetDepthBuffer() const { return m_depthLevels[0]; }
+
+	private:
+
+		void WorkerLoop(uint32 band);
+		void RasterizeBand(uint32 band);
+		void BuildHierarchy();
+		void AddClippedTriangle(const Vector4& v0, const Vector4& v1, const Vector4& v2);
+
+	private:
+
+		Matrix m_viewProjection;
+		bool m_hasOccluders = false;
+		OcclusionStats m_stats;
+
+		// Clip space positions of the occluder being added.
+		std::vector<Vector4> m_clipPositions;
+
+		// Screen space x, y & depth of each triangle corner.
+		std::vector<float> m_triangles;
+
+		// Full resolution depth followed by the max depth levels.
+		std::vector<std::vector<float>> m_depthLevels;
+
+		std::vector<std::thread> m_workers;
+		std::mutex m_mutex;
+		std::condition_variable m_workCondition;
+		std::condition_variable m_doneCondition;
+		uint32 m_generation = 0;
+		uint32 m_pendingWorkers = 0;
+		bool m_exit = false;
+	};
+}
+
+#endif
@@ -55,7 +55,28 @@ namespace LinaEngine::Graphics
 #define SC_DIRECTIONALLIGHT std::string("directionalLight")
 #define SC_POINTLIGHTS std::string("pointLights")
 #define SC_SPOTLIGHTS std::string("spotLights")
-
+#define SC_MAXLIGHTS 16384
+#define SC_LIGHTMININTENSITY (1.0f / 256.0f)
+#define SC_MAXLIGHTSPERCLUSTER 256
+#define SC_CLUSTERGRIDX 16
+#define SC_CLUSTERGRIDY 9
+#define SC_CLUSTERGRIDZ 24
+#define SC_MAXSHADOWCASCADES 4
+#define SC_SHADOWCASCADEMARGIN 0.2f
+#define SC_MAXBLOOMMIPS 8
+#define SC_BLOOMMINMIPSIZE 8
+#define SC_LODSCREENSIZE 0.5f
+#define SC_LODHYSTERESIS 0.1f
+#define SC_PROGRAMCACHEPATH "cache/shaders/"
+#define SC_HDRICUBEMAPRESOLUTION 512
+#define SC_HDRIIRRADIANCERESOLUTION 32
+#define SC_HDRIPREFILTERRESOLUTION 128
+#define SC_HDRIPREFILTERMIPS 5
+#define SC_HDRIBRDFLUTRESOLUTION 512
+#define SC_HDRIBRDFLUTPATH "resources/engine/textures/BRDFLUT.hdricache"
+
+#define MAT_BLOCKNAME "MaterialData"
+#define MAT_BLOCKPREFIX std::string("material.")
 #define MAT_COLOR "material.color"
 #define MAT_STARTCOLOR "material.startColor"
 #define MAT_ENDCOLOR "material.endColor"
@@ -67,6 +88,7 @@ namespace LinaEngine::Graphics
 #define MAT_TEXTURE2D_METALLICMAP "material.metallicMap"
 #define MAT_TEXTURE2D_AOMAP "material.aoMap"
 #define MAT_TEXTURE2D_IRRADIANCEMAP "material.irradianceMap"
+#define MAT_IRRADIANCESH "material.irradianceSH"
 #define MAT_TEXTURE2D_PREFILTERMAP "material.prefilterMap"
 #define MAT_TEXTURE2D_BRDFLUTMAP "material.brdfLUTMap"
 #define MAT_TEXTURE2D_SHADOWMAP "material.shadowMap"
@@ -82,7 +104,9 @@ namespace LinaEngine::Graphics
 #define MAT_WORKFLOW "material.workflow"
 #define MAT_SURFACETYPE "material.surfaceType"
 #define MAT_TILING "material.tiling"
-#define MAT_ISHORIZONTAL "material.horizontal"
+#define MAT_BLOOMTHRESHOLD "material.threshold"
+#define MAT_BLOOMRADIUS "material.radius"
+#define MAT_BLOOMPASS "material.pass"
 #define MAT_BLOOMENABLED "material.bloomEnabled"
 #define MAT_FXAAENABLED "material.fxaaEnabled"
 #define MAT_FXAASPANMAX "material.fxaaSpanMax"
@@ -50,8 +50,18 @@ Timestamp: 4/15/2019 12:26:31 PM
 #include "Rendering/ModelLoader.hpp"
 #include "Rendering/VertexArray.hpp"
 #include "Rendering/RenderBuffer.hpp"
+#include "Rendering/RenderTarget.hpp"
+#include "Rendering/RenderTargetPool.hpp"
+#include "Rendering/FrameGraph.hpp"
+#include "Rendering/StaticBatcher.hpp"
+#include "Rendering/OcclusionCuller.hpp"
+#include "Rendering/SpriteBatcher.hpp"
+#include "Rendering/SphericalHarmonics.hpp"
 #include "Mesh.hpp"
 #include "UniformBuffer.hpp"
+#include "TextureBuffer.hpp"
+#include "DrawList.hpp"
+#include "GPUTimer.hpp"
 #include "Window.hpp"
 #include "RenderContext.hpp"
 #include "Utility/Math/Color.hpp"
@@ -112,18 +122,26 @@ namespace LinaEngine::Graphics
 		void SetPostSceneDrawCallback(std::function<void()>& cb) { m_postSceneDrawCallback = cb; }
 		Vector2 GetViewportSize() { return m_viewportSize; }
 		ECS::CameraSystem* GetCameraSystem() { return &m_cameraSystem; }
+		ECS::MeshRendererSystem* GetMeshRendererSystem() { return &m_meshRendererSystem; }
 		Texture& GetHDRICubemap() { return m_hdriCubemap; }
 		static RenderDevice& GetRenderDevice() { return s_renderDevice; }
 		static Texture& GetDefaultTexture() { return s_defaultTexture; }
 		static Material& GetDefaultUnlitMaterial() { return s_defaultUnlit; }
 		RenderSettings& GetRenderSettings() { return m_renderSettings; }
 		DrawParams GetMainDrawParams() { return m_defaultDrawParams; }
+		StaticBatcher& GetStaticBatcher() { return m_staticBatcher; }
+		OcclusionCuller& GetOcclusionCuller() { return m_occlusionCuller; }
+		SpriteBatcher& GetSpriteBatcher() { return m_spriteBatcher; }
 		void SetCurrentPLightCount(int count) { m_currentPointLightCount = count; }
 		void SetCurrentSLightCount(int count) { m_currentSpotLightCount = count; }
 		void SetPreDrawCallback(const std::function<void()>& cb) { m_preDrawCallback = cb; };
 		void SetPostDrawCallback(const std::function<void()>& cb) { m_postDrawCallback = cb; };
 		void DrawSceneObjects(DrawParams& drawpParams, Material* overrideMaterial = nullptr, bool drawSkybox = true);
 
+		// Draws the gathered scene from an additional view into the currently bound target, e.g. a portal camera.
+		void DrawSceneView(const RenderView& view, DrawParams& drawParams, Material* overrideMaterial = nullptr, bool drawSkybox = true);
+		RenderView GetMainView();
+
 	private:
 
 		void ConstructEngineShaders();
@@ -137,13 +155,36 @@ namespace LinaEngine::Graphics
 		void DrawOperationsDefault();
 		void DrawSkybox();
 		void UpdateUniformBuffers();
+		void UpdateViewData(const RenderView& view);
+		void UpdateLightClusters(const RenderView& view);
+		void DrawView(const RenderView& view, DrawList& drawList, DrawParams& drawParams, Material* overrideMaterial, PacketFilter filter = PacketFilter::All, OcclusionCuller* occlusionCuller = nullptr);
+		void UpdateOcclusion();
+		void DrawShadowCascades(DrawList& drawList, PacketFilter filter);
+		void BuildFrameGraph();
+		FrameGraphResource AddBloomPasses(FrameGraphResource source);
+		void DrawBloomPass(int pass, FrameGraphResource source, FrameGraphResource base);
+		void DrawFinal(FrameGraphResource scene, FrameGraphResource bloom);
+		void UpdateRenderTargetSize();
+		void ResizeRenderTargets(const Vector2& size);
+		void ResolveUniformHandles(Material* mat);
+		void UpdateMaterialBlock(Material* mat);
+		void UpdateLooseUniforms(Material* mat);
 		
 		// Generating necessary maps for HDRI specular highlighting
+		void ConstructHDRIMaps();
 		void CalculateHDRICubemap(Texture& hdriTexture, glm::mat4& captureProjection, glm::mat4 views[6]);
 		void CalculateHDRIIrradiance(Matrix& captureProjection, Matrix views[6]);
+		bool CalculateHDRIIrradianceSH(const std::string& hdriPath);
+		void UploadHDRIIrradianceSH();
 		void CalculateHDRIPrefilter(Matrix& captureProjection, Matrix views[6]);
 		void CalculateHDRIBRDF(Matrix& captureProjection, Matrix views[6]);
 
+		// Computed maps are read back & cached, the cubemap's mips are regenerated on load.
+		bool LoadHDRIMaps(const std::string& path, uint64 key);
+		void SaveHDRIMaps(const std::string& path, uint64 key);
+		bool LoadHDRIBRDF();
+		void SaveHDRIBRDF();
+
 
 	private:
 
@@ -151,11 +192,10 @@ namespace LinaEngine::Graphics
 		Window* m_appWindow;
 
 		RenderTarget m_primaryRenderTarget;
-		RenderTarget m_pingPongRenderTarget1;
-		RenderTarget m_pingPongRenderTarget2;
 		RenderTarget m_outlineRenderTarget;
 		RenderTarget m_hdriCaptureRenderTarget;
 		RenderTarget m_shadowMapTarget;
+		RenderTarget m_staticShadowMapTarget;
 
 #ifdef LINA_EDITOR
 		RenderTarget m_secondaryRenderTarget;
@@ -169,11 +209,11 @@ namespace LinaEngine::Graphics
 		// Frame buffer texture parameters
 		SamplerParameters m_mainRTParams;
 		SamplerParameters m_primaryRTParams;
-		SamplerParameters m_pingPongRTParams;
+		SamplerParameters m_bloomRTParams;
 		SamplerParameters m_shadowsRTParams;
 
 		Material m_screenQuadFinalMaterial;
-		Material m_screenQuadBlurMaterial;
+		Material m_screenQuadBloomMaterial;
 		Material m_screenQuadOutlineMaterial;
 		Material* m_skyboxMaterial = nullptr;
 		Material m_debugDrawMaterial;
@@ -184,14 +224,13 @@ namespace LinaEngine::Graphics
 
 		Texture m_primaryRTTexture0;
 		Texture m_primaryRTTexture1;
-		Texture m_pingPongRTTexture1;
-		Texture m_pingPongRTTexture2;
 		Texture m_outlineRTTexture;
 		Texture m_hdriCubemap;
 		Texture m_hdriIrradianceMap;
 		Texture m_hdriPrefilterMap;
 		Texture m_HDRILutMap;
 		Texture m_shadowMapRTTexture;
+		Texture m_staticShadowMapRTTexture;
 		static Texture s_defaultTexture;
 		Texture m_defaultCubemapTexture;
 
@@ -202,7 +241,22 @@ namespace LinaEngine::Graphics
 
 		UniformBuffer m_globalDataBuffer;
 		UniformBuffer m_globalLightBuffer;
+		UniformBuffer m_globalLightArrayBuffer;
 		UniformBuffer m_globalDebugBuffer;
+		TextureBuffer m_lightDataBuffer;
+		TextureBuffer m_lightGridBuffer;
+		TextureBuffer m_lightIndexBuffer;
+
+		DrawList m_mainDrawList;
+		DrawList m_shadowDrawList;
+		DrawList m_staticShadowDrawList;
+		DrawList m_auxiliaryDrawList;
+		GPUTimer m_gpuTimer;
+		RenderTargetPool m_renderTargetPool;
+		FrameGraph m_frameGraph;
+		StaticBatcher m_staticBatcher;
+		OcclusionCuller m_occlusionCuller;
+		SpriteBatcher m_spriteBatcher;
 
 		LayerStack m_guiLayerStack;
 		RenderingDebugData m_debugData;
@@ -227,12 +281,25 @@ namespace LinaEngine::Graphics
 		int m_currentSpotLightCount = 0;
 		int m_currentPointLightCount = 0;
 		bool m_hdriDataCaptured = false;
+		bool m_hdriUsesIrradianceSH = false;
+		Vector3 m_hdriIrradianceSH[SH_COEFFICIENTCOUNT];
+
+		// State the cached static shadow atlas was rendered with.
+		bool m_staticShadowMapValid = false;
+		size_t m_staticShadowStateHash = 0;
+		int m_staticShadowCascadeCount = 0;
+		Matrix m_staticShadowMatrices[SC_MAXSHADOWCASCADES];
 
 		Vector2 m_hdriResolution = Vector2(512, 512);
 		Vector2 m_shadowMapResolution = Vector2(2048, 2048);
 		Vector2 m_viewportPos = Vector2::Zero;
 		Vector2 m_viewportSize = Vector2::Zero;
 
+		// Size the persistent targets are allocated with, follows the viewport once it stops changing.
+		Vector2 m_renderTargetSize = Vector2::Zero;
+		int m_renderTargetStableFrames = 0;
+		bool m_renderTargetsConstructed = false;
+
 		std::function<void()> m_postSceneDrawCallback;
 		std::function<void()> m_preDrawCallback;
 		std::function<void()> m_postDrawCallback;
@@ -40,6 +40,7 @@ Timestamp: 10/30/2020 9:17:05 AM
 #define RenderSettings_HPP
 
 #include <string>
+#include <cereal/cereal.hpp>
 
 namespace LinaEngine::Graphics
 {
@@ -55,9 +56,13 @@ namespace LinaEngine::Graphics
 		static RenderSettings DeserializeRenderSettings(const std::string& path, const std::string& fileName);
 		
 		template<class Archive>
-		void serialize(Archive& archive)
+		void serialize(Archive& archive, std::uint32_t const version)
 		{
 			archive(m_bloomEnabled, m_fxaaEnabled, m_fxaaReduceMin, m_fxaaReduceMul, m_fxaaSpanMax, m_gamma, m_exposure);
+
+			// Version 1 adds the bloom filter & occlusion culling settings.
+			if (version > 0)
+				archive(m_bloomThreshold, m_bloomRadius, m_occlusionCullingEnabled);
 		}
 		
 		bool m_bloomEnabled = false;
@@ -67,7 +72,16 @@ namespace LinaEngine::Graphics
 		float m_fxaaSpanMax = 8.0f;
 		float m_gamma = 2.2f;
 		float m_exposure = 1.0f;
+
+		// Brightness bloom starts from & spread of the upsample filter in texels of each mip.
+		float m_bloomThreshold = 1.0f;
+		float m_bloomRadius = 1.0f;
+
+		// Hides the packets behind the occluder mesh renderers in the main view.
+		bool m_occlusionCullingEnabled = true;
 	};
 }
 
+CEREAL_CLASS_VERSION(LinaEngine::Graphics::RenderSettings, 1);
+
 #endif
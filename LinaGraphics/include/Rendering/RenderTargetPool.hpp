@@ -0,0 +1,94 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/*
+Class: RenderTargetPool
+
+Hands out transient color targets keyed by size & format. Targets released during a frame are handed out again
+to later passes of the same size & format, targets that stay unused for a few frames are destroyed.
+
+Timestamp: 10/19/2020 11:02:37 AM
+*/
+
+#pragma once
+
+#ifndef RenderTargetPool_HPP
+#define RenderTargetPool_HPP
+
+#include "Rendering/RenderTarget.hpp"
+#include <vector>
+
+// Number of frames an unused pooled target is kept for.
+#define RTPOOL_MAXIDLEFRAMES 8
+
+namespace LinaEngine::Graphics
+{
+	struct PooledRenderTarget
+	{
+		Texture m_texture;
+		RenderTarget m_target;
+		Vector2 m_size = Vector2::Zero;
+		SamplerParameters m_params;
+		uint64 m_lastUsedFrame = 0;
+		bool m_inUse = false;
+	};
+
+	class RenderTargetPool
+	{
+
+	public:
+
+		RenderTargetPool() {};
+		~RenderTargetPool() {};
+
+		void Construct(RenderDevice& renderDevice) { m_renderDevice = &renderDevice; }
+
+		// Returns a free target w/ matching size & format, creates one if none is free.
+		PooledRenderTarget* Acquire(const Vector2& size, const SamplerParameters& params);
+
+		// Gives the target back, passes acquiring after this point may write to its memory.
+		void Release(PooledRenderTarget* target);
+
+		// Destroys the targets that were not used for RTPOOL_MAXIDLEFRAMES frames.
+		void EndFrame();
+
+		// Destroys all pooled targets.
+		void Clear();
+
+		size_t GetPooledCount() const { return m_targets.size(); }
+
+	private:
+
+		RenderDevice* m_renderDevice = nullptr;
+		std::vector<PooledRenderTarget*> m_targets;
+		uint64 m_frame = 0;
+	};
+}
+
+#endif
@@ -39,6 +39,7 @@ Timestamp: 4/14/2019 11:59:32 AM
 
 #include "Core/SizeDefinitions.hpp"
 #include <string>
+#include <cereal/cereal.hpp>
 
 namespace LinaEngine::Graphics
 {
@@ -94,7 +95,8 @@ namespace LinaEngine::Graphics
 		BINDTEXTURE_TEXTURE2D = LINA_GRAPHICS_BINDTEXTURE_TEXTURE2D,
 		BINDTEXTURE_CUBEMAP = LINA_GRAPHICS_BINDTEXTURE_CUBEMAP,
 		BINDTEXTURE_CUBEMAP_POSITIVE_X = LINA_GRAPHICS_BINDTEXTURE_CUBEMAP_POSITIVE_X,
-		BINDTEXTURE_TEXTURE2D_MULTISAMPLE = LINA_GRAPHICS_BINDTEXTURE_TEXTURE2D_MULTISAMPLE
+		BINDTEXTURE_TEXTURE2D_MULTISAMPLE = LINA_GRAPHICS_BINDTEXTURE_TEXTURE2D_MULTISAMPLE,
+		BINDTEXTURE_TEXTUREBUFFER = LINA_GRAPHICS_BINDTEXTURE_TEXTUREBUFFER
 	};
 
 	enum PixelFormat
@@ -109,7 +111,19 @@ namespace LinaEngine::Graphics
 		FORMAT_DEPTH_AND_STENCIL = 7,
 		FORMAT_SRGB = 8,
 		FORMAT_SRGBA = 9,
-		FORMAT_DEPTH16 = 10
+		FORMAT_DEPTH16 = 10,
+		FORMAT_R32UI = 11,
+		FORMAT_RG32UI = 12,
+		FORMAT_RGBA32F = 13
+	};
+
+	enum TextureCompression
+	{
+		COMPRESSION_NONE = 0,
+		COMPRESSION_BC1 = 1,
+		COMPRESSION_BC3 = 2,
+		COMPRESSION_BC4 = 3,
+		COMPRESSION_BC5 = 4
 	};
 
 
@@ -202,6 +216,32 @@ namespace LinaEngine::Graphics
 		UT_Int
 	};
 
+	enum VertexAttributeType
+	{
+		ATTRIB_FLOAT = 0,
+		ATTRIB_HALF_FLOAT = 1,
+		ATTRIB_SHORT_NORMALIZED = 2
+	};
+
+	// Attribute inside an interleaved vertex buffer.
+	struct VertexAttribute
+	{
+		uint32 m_location = 0;
+		uint32 m_components = 0;
+		VertexAttributeType m_type = VertexAttributeType::ATTRIB_FLOAT;
+		uint32 m_offset = 0;
+	};
+
+	// Record of an indirect draw, laid out as GL reads it from the indirect buffer.
+	struct DrawElementsIndirectCommand
+	{
+		uint32 m_count = 0;
+		uint32 m_instanceCount = 0;
+		uint32 m_firstIndex = 0;
+		uint32 m_baseVertex = 0;
+		uint32 m_baseInstance = 0;
+	};
+
 	struct SamplerData
 	{
 		SamplerFilter m_minFilter = SamplerFilter::FILTER_NEAREST_MIPMAP_LINEAR;
@@ -249,15 +289,16 @@ namespace LinaEngine::Graphics
 		HDRI_Prefilter = 9,
 		HDRI_BRDF = 10,
 		ScreenQuad_Final = 11,
-		ScreenQuad_Blur = 12,
+		ScreenQuad_Bloom = 12,
 		ScreenQuad_Outline = 13,
 		ScreenQuad_Shadowmap = 14,
 		Debug_Line = 15,
 		Standard_Sprite = 16,
-		Skybox_Atmospheric = 17
+		Skybox_Atmospheric = 17,
+		Standard_SpriteBatch = 18
 	};
 
-	extern char* g_shadersStr[18];
+	extern char* g_shadersStr[19];
 
 
 	struct RenderingDebugData
@@ -291,10 +332,24 @@ namespace LinaEngine::Graphics
 		bool m_smoothNormals = true;
 		bool m_calculateTangentSpace = true;
 
+		// Number of simplified levels generated in addition to the full detail mesh & the ratio of triangles each keeps from the previous one.
+		int m_lodCount = 3;
+		float m_lodReduction = 0.5f;
+
+		// Stores positions as 16 bit values relative to the mesh bounds.
+		bool m_quantizePositions = false;
+
+		// Welds identical vertices & reorders triangles & vertices for the caches after import.
+		bool m_optimizeMesh = true;
+
 		template<class Archive>
-		void serialize(Archive& archive)
+		void serialize(Archive& archive, std::uint32_t const version)
 		{
 			archive(m_triangulate, m_smoothNormals, m_calculateTangentSpace);
+
+			// Version 1 adds the levels of detail, quantization & optimization settings.
+			if (version > 0)
+				archive(m_lodCount, m_lodReduction, m_quantizePositions, m_optimizeMesh);
 		}
 	};
 
@@ -321,10 +376,17 @@ namespace LinaEngine::Graphics
 		TextureParameters m_textureParams = TextureParameters();
 		int m_anisotropy = 0.0f;
 
+		// Textures loaded from files are cooked into block compressed mip chains, see TextureCooker.
+		bool m_compress = false;
+
 		template<class Archive>
-		void serialize(Archive& archive)
+		void serialize(Archive& archive, std::uint32_t const version)
 		{
 			archive(m_anisotropy, m_textureParams);
+
+			// Version 1 adds compression.
+			if (version > 0)
+				archive(m_compress);
 		}
 	};
 
@@ -366,5 +428,7 @@ namespace LinaEngine::Graphics
 
 }
 
+CEREAL_CLASS_VERSION(LinaEngine::Graphics::MeshParameters, 1);
+CEREAL_CLASS_VERSION(LinaEngine::Graphics::SamplerParameters, 1);
 
 #endif
\ No newline at end of file
@@ -30,7 +30,8 @@ SOFTWARE.
 Class: Shader
 
 Wrapper for shader functionalities, responsible for creating shaders, binding uniform buffers
-and all related shader operations.
+and all related shader operations. Shaders can be created deferred, compiling on first use.
+Keyword permutations declared in the source are compiled as variants on demand.
 
 Timestamp: 2/16/2019 1:47:28 AM
 */
@@ -42,8 +43,14 @@ Timestamp: 2/16/2019 1:47:28 AM
 
 #include "Core/Common.hpp"
 #include "PackageManager/PAMRenderDevice.hpp"
+#include "Rendering/ShaderSourceCache.hpp"
 #include "UniformBuffer.hpp"
+#include <map>
 #include <string>
+#include <vector>
+
+// Keywords beyond this count are ignored, variant masks are 32 bits.
+#define SHADER_MAX_KEYWORDS 32
 
 namespace LinaEngine::Graphics
 {
@@ -54,43 +61,80 @@ namespace LinaEngine::Graphics
 
 		Shader() {};
 
-		~Shader() { m_engineBoundID = s_renderDevice->ReleaseShaderProgram(m_engineBoundID); }
+		~Shader() { ReleaseVariants(); }
 
-		Shader& Construct(RenderDevice& renderDeviceIn, const std::string& text, bool usesGeometryShader)
+		// Only stores the source path, the program is compiled the first time its id is requested.
+		Shader& ConstructDeferred(RenderDevice& renderDeviceIn, const std::string& path, bool usesGeometryShader)
 		{
 			s_renderDevice = &renderDeviceIn;
-			m_engineBoundID = s_renderDevice->CreateShaderProgram(text, usesGeometryShader);
+			m_path = path;
+			m_usesGeometryShader = usesGeometryShader;
 			return *this;
 		}
 
 		// Set uniform buffer through render engine.
 		void SetUniformBuffer(const std::string& name, UniformBuffer& buffer) 
 		{ 
-			s_renderDevice->SetShaderUniformBuffer(m_engineBoundID, name, buffer.GetID()); 
+			s_renderDevice->SetShaderUniformBuffer(GetID(), name, buffer.GetID()); 
 		}
 
+		// Bindings are kept & applied to every variant compiled.
 		void BindBlockToBuffer(uint32 bindingPoint, std::string blockName)
 		{
-			s_renderDevice->BindShaderBlockToBufferPoint(m_engineBoundID, bindingPoint, blockName);
+			m_blockBindings.push_back(std::make_pair(bindingPoint, blockName));
+
+			for (std::map<uint32, uint32>::iterator it = m_variants.begin(); it != m_variants.end(); ++it)
+				s_renderDevice->BindShaderBlockToBufferPoint(it->second, bindingPoint, blockName);
 		}
 
-		// Get shader id, this gets matched w/ program id on render engine.
-		uint32 GetID() { return m_engineBoundID; }
+		// Constant int uniforms, e.g. fixed sampler units, are kept & applied to every variant compiled.
+		void SetUniformInt(const std::string& name, int value);
+
+		// Get shader id, this gets matched w/ program id on render engine. Returns the variant w/o keywords.
+		uint32 GetID() { return GetVariant(0); }
+
+		// Returns the program for the keyword mask, compiling it the first time it is requested.
+		uint32 GetVariant(uint32 keywordMask);
+
+		// Keywords in declaration order, bit i of a variant mask enables keyword i.
+		const std::vector<ShaderKeyword>& GetKeywords();
+
+		bool IsCompiled() const { return !m_variants.empty(); }
+		const std::map<uint32, uint32>& GetVariants() const { return m_variants; }
+		void ReleaseVariants();
 
-		static Shader& CreateShader(Shaders shader, const std::string& path, bool usesGeometryShader = false);
+		static Shader& CreateShader(Shaders shader, const std::string& path, bool usesGeometryShader = false, bool deferCompile = false);
 		static Shader& GetShader(Shaders shader);
 		static bool ShaderExists(Shaders shader);
 		static std::map<int, Shader>& GetLoadedShaders() { return s_loadedShaders; }
 
+		// Drops the cached source of the file, variants of every shader including it are recompiled on next use.
+		static void ReloadSource(const std::string& path);
+
+		// Incremented on each reload, materials compare it to re-resolve their programs.
+		static uint32 GetGeneration() { return s_generation; }
+
+	private:
+
+		bool LoadSource();
+
 	private:
 
 		RenderDevice* s_renderDevice = nullptr;
-		uint32 m_engineBoundID = 0;
+		std::string m_path = "";
+		std::string m_source = "";
+		bool m_sourceLoaded = false;
+		bool m_usesGeometryShader = false;
+		std::vector<ShaderKeyword> m_keywords;
+		std::map<uint32, uint32> m_variants;
+		std::vector<std::pair<uint32, std::string>> m_blockBindings;
+		std::vector<std::pair<std::string, int>> m_intUniforms;
 		static std::map<int, Shader> s_loadedShaders;
+		static uint32 s_generation;
 
 	
 	};
 }
 
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,104 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/*
+Class: ShaderSourceCache
+
+Keeps the shader sources & their includes in memory so each file is read from disk once. Files remember
+which files include them, invalidating a file reports every file depending on it so only the shaders
+built from those need to be recompiled. Variant keywords declared in the sources are collected as well.
+
+Timestamp: 11/27/2020 11:08:14 AM
+*/
+
+#pragma once
+
+#ifndef ShaderSourceCache_HPP
+#define ShaderSourceCache_HPP
+
+#include "Core/Common.hpp"
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Declares a variant keyword, followed by the define & the material parameter enabling it.
+#define SHADER_VARIANT_PRAGMA "#pragma variant"
+
+namespace LinaEngine::Graphics
+{
+	// Defined for a variant when the material parameter, a texture or a bool, is active.
+	struct ShaderKeyword
+	{
+		std::string m_define = "";
+		std::string m_parameter = "";
+	};
+
+	class ShaderSourceCache
+	{
+
+	public:
+
+		// Assembles the file w/ all of its includes, keywords of the file & its includes are appended.
+		static bool Resolve(const std::string& path, std::string& output, std::vector<ShaderKeyword>& keywords);
+
+		// Drops the file from the cache, the file & every file including it directly or indirectly are reported.
+		static void Invalidate(const std::string& path, std::set<std::string>& affected);
+
+		// Paths are compared in their normal form, include paths are relative to the including file.
+		static std::string NormalizePath(const std::string& path);
+
+		static void Clear();
+
+	private:
+
+		// A line of a file, include lines only hold the path of the included file.
+		struct SourceLine
+		{
+			std::string m_text = "";
+			bool m_isInclude = false;
+		};
+
+		struct SourceFile
+		{
+			std::vector<SourceLine> m_lines;
+			std::vector<ShaderKeyword> m_keywords;
+		};
+
+		static SourceFile* Load(const std::string& path);
+		static bool Append(const std::string& path, std::string& output, std::vector<ShaderKeyword>& keywords, std::vector<std::string>& includeStack);
+
+	private:
+
+		static std::map<std::string, SourceFile> s_files;
+		static std::map<std::string, std::set<std::string>> s_includedBy;
+	};
+}
+
+#endif
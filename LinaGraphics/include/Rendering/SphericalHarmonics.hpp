@@ -0,0 +1,71 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/*
+Class: SphericalHarmonics
+
+Projects equirectangular HDR radiance onto the 9 coefficients of the first three spherical harmonics bands
+on the CPU. Rows of the image are split between threads, each accumulating 4 pixels at a time w/ SSE.
+Once convolved w/ the cosine lobe the coefficients replace the irradiance cubemap.
+
+Timestamp: 11/29/2020 4:12:51 PM
+*/
+
+#pragma once
+
+#ifndef SphericalHarmonics_HPP
+#define SphericalHarmonics_HPP
+
+#include "Utility/Math/Vector.hpp"
+
+#define SH_COEFFICIENTCOUNT 9
+
+namespace LinaEngine::Graphics
+{
+	class SphericalHarmonics
+	{
+
+	public:
+
+		// Solid angle weighted projection, the layout matches the one HDRIEquirectangular.glsl samples.
+		static void ProjectEquirectangular(const float* pixels, int width, int height, int channels, Vector3 coefficients[SH_COEFFICIENTCOUNT]);
+
+		// Folds the cosine lobe & 1 / PI in, evaluating then yields the values the irradiance map would hold.
+		static void ConvolveLambert(Vector3 coefficients[SH_COEFFICIENTCOUNT]);
+
+		// CPU evaluation of the coefficients for a unit direction, e.g. to check against the GPU convolution.
+		static Vector3 Evaluate(const Vector3 coefficients[SH_COEFFICIENTCOUNT], const Vector3& direction);
+
+	private:
+
+		static void ProjectRows(const float* pixels, int width, int height, int channels, int rowBegin, int rowEnd, const float* cosPhi, const float* sinPhi, double* sums);
+	};
+}
+
+#endif
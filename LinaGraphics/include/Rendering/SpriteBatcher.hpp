@@ -0,0 +1,158 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/*
+Class: SpriteBatcher
+
+Packs the textures of the sprite renderers into atlas pages & draws them w/o per sprite state changes. Every
+frame the gathered sprites are sorted by their layer & page, expanded into world space quads & streamed into
+a single vertex buffer. Consecutive sprites on the same page are drawn w/ a single call. Batches are drawn in the
+main view after its sorted packets, so they are not depth sorted against the transparent meshes.
+
+Timestamp: 11/26/2020 4:12:51 PM
+*/
+
+#pragma once
+
+#ifndef SpriteBatcher_HPP
+#define SpriteBatcher_HPP
+
+#include "Rendering/Material.hpp"
+#include "Rendering/Texture.hpp"
+#include "Utility/stb/stb_rect_pack.h"
+#include <map>
+#include <vector>
+
+// Width & height of the atlas pages, textures that do not fit a page are not batched.
+#define SPRITEATLAS_PAGESIZE 2048
+
+// Empty texels left around each texture so filtering does not bleed into the neighbours.
+#define SPRITEATLAS_PADDING 1
+
+// Sprites that fit the streaming buffer per frame, 4 vertices each so 16 bit indices can address all.
+#define SPRITEBATCH_MAXSPRITES 16384
+
+namespace LinaEngine::Graphics
+{
+	class RenderEngine;
+
+	// Location of a texture inside the atlas, uv rect is min xy & max zw.
+	struct SpriteAtlasEntry
+	{
+		int m_page = -1;
+		Vector4 m_uvRect = Vector4(0.0f, 0.0f, 1.0f, 1.0f);
+	};
+
+	// Layout of the streamed vertices.
+	struct SpriteVertex
+	{
+		float m_position[3];
+		float m_texCoords[2];
+		float m_color[4];
+	};
+
+	// Sprites of a single page drawn w/ one call.
+	struct SpriteBatch
+	{
+		int m_page = -1;
+		uint32 m_firstIndex = 0;
+		uint32 m_indexCount = 0;
+	};
+
+	struct SpriteBatchStats
+	{
+		uint32 m_sprites = 0;
+		uint32 m_batches = 0;
+		uint32 m_pages = 0;
+	};
+
+	class SpriteBatcher
+	{
+
+	public:
+
+		SpriteBatcher() {};
+		~SpriteBatcher() { Release(); };
+
+		// Creates the streaming vertex array & the quad indices.
+		void Construct(RenderDevice& renderDevice);
+		void Release();
+
+		// Finds the texture in the atlas or packs it in, returns false if it can not be batched.
+		bool GetAtlasEntry(Texture* texture, SpriteAtlasEntry& entry);
+
+		// Gathers the sprites of a frame, sorts & uploads them at the end.
+		void Begin();
+
+		// Returns false if the buffer is full, the sprite then needs to be drawn separately.
+		bool Add(const Matrix& model, const Color& color, int layer, const SpriteAtlasEntry& entry);
+		void End();
+
+		// Draws the batches of the frame into the currently bound target.
+		void Draw(RenderEngine& renderEngine, DrawParams& drawParams);
+
+		const SpriteBatchStats& GetStats() const { return m_stats; }
+
+	private:
+
+		// Atlas page w/ the packing state of its free space.
+		struct AtlasPage
+		{
+			Texture m_texture;
+			Material m_material;
+			stbrp_context m_context;
+			std::vector<stbrp_node> m_nodes;
+		};
+
+		// A sprite gathered for the frame.
+		struct Sprite
+		{
+			Matrix m_model;
+			Color m_color;
+			int m_layer = 0;
+			SpriteAtlasEntry m_entry;
+		};
+
+		int AddPage();
+
+	private:
+
+		RenderDevice* m_renderDevice = nullptr;
+		uint32 m_vertexArray = 0;
+		std::vector<AtlasPage*> m_pages;
+		std::map<uint32, SpriteAtlasEntry> m_entries;
+		std::vector<Sprite> m_sprites;
+		std::vector<uint32> m_order;
+		std::vector<SpriteVertex> m_vertices;
+		std::vector<SpriteBatch> m_batches;
+		SpriteBatchStats m_stats;
+	};
+}
+
+#endif
@@ -0,0 +1,145 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/*
+Class: StaticBatcher
+
+Merges static mesh renderers that share a material into a single vertex array per spatial cell. Vertices are
+pre-transformed to world space, so each batch is drawn w/ an identity transform. Merged data is cached next to
+the level file & reused as long as the static renderers it was built from do not change. Renderers that change
+after the batches are loaded are dropped from them & the batches are rebuilt from the remaining sources.
+
+Timestamp: 10/21/2020 2:14:09 PM
+*/
+
+#pragma once
+
+#ifndef StaticBatcher_HPP
+#define StaticBatcher_HPP
+
+#include "Rendering/DrawList.hpp"
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+#include <vector>
+
+// World space size of the cubic cells batches are split into.
+#define STATICBATCH_CELLSIZE 32.0f
+
+namespace LinaEngine::Graphics
+{
+	class Mesh;
+
+	// A static renderer to be merged.
+	struct StaticBatchSource
+	{
+		Mesh* m_mesh = nullptr;
+		Material* m_material = nullptr;
+		Matrix m_model;
+	};
+
+	// Merged world space geometry of a single material & cell.
+	struct StaticBatchData
+	{
+		std::string m_materialPath = "";
+		int m_cellX = 0;
+		int m_cellY = 0;
+		int m_cellZ = 0;
+		std::vector<float> m_positions;
+		std::vector<float> m_texCoords;
+		std::vector<float> m_normals;
+		std::vector<float> m_tangents;
+		std::vector<float> m_bitangents;
+		std::vector<uint32> m_indices;
+
+		template<class Archive>
+		void serialize(Archive& archive)
+		{
+			archive(m_materialPath, m_cellX, m_cellY, m_cellZ, m_positions, m_texCoords, m_normals, m_tangents, m_bitangents, m_indices);
+		}
+	};
+
+	// All batches of a level along w/ the hash of the sources they were built from.
+	struct StaticBatchCache
+	{
+		uint64 m_sourceHash = 0;
+		std::vector<StaticBatchData> m_batches;
+
+		template<class Archive>
+		void serialize(Archive& archive)
+		{
+			archive(m_sourceHash, m_batches);
+		}
+	};
+
+	class StaticBatcher
+	{
+
+	public:
+
+		StaticBatcher() {};
+		~StaticBatcher() { Clear(); };
+
+		void Construct(RenderDevice& renderDevice) { m_renderDevice = &renderDevice; }
+
+		// Only meshes whose sub-meshes all use the lit vertex layout can be merged.
+		static bool CanBatch(Mesh& mesh);
+
+		// Hash identifying the sources & their mesh data, a cache is only valid for the sources it was built from.
+		static uint64 HashSources(const std::vector<StaticBatchSource>& sources);
+
+		// Merges the sources per material & cell.
+		static void Build(const std::vector<StaticBatchSource>& sources, StaticBatchCache& cache);
+
+		static bool LoadCache(const std::string& path, StaticBatchCache& cache);
+		static void SaveCache(const std::string& path, const StaticBatchCache& cache);
+
+		// Creates a vertex array per material holding all of its cells & a render packet per cell, previous batches are released.
+		void Load(const StaticBatchCache& cache, const std::vector<StaticBatchSource>& sources);
+
+		// Merges & loads the sources again, used once some of the loaded sources are no longer valid.
+		void Rebuild(const std::vector<StaticBatchSource>& sources);
+
+		// Releases all batches.
+		void Clear();
+
+		const std::vector<RenderPacket>& GetPackets() const { return m_packets; }
+
+		// Sources the loaded batches were built from.
+		const std::vector<StaticBatchSource>& GetSources() const { return m_sources; }
+
+	private:
+
+		RenderDevice* m_renderDevice = nullptr;
+		std::vector<VertexArray*> m_vertexArrays;
+		std::vector<RenderPacket> m_packets;
+		std::vector<StaticBatchSource> m_sources;
+	};
+}
+
+#endif
@@ -61,6 +61,7 @@ namespace LinaEngine::Graphics
 
 		Texture& Construct(RenderDevice& deviceIn, const class ArrayBitmap& data, SamplerParameters samplerParams, bool shouldCompress, const std::string& path = "");
 		Texture& ConstructCubemap(RenderDevice& deviceIn, SamplerParameters samplerParams, const std::vector<class ArrayBitmap*>& data, bool compress, const std::string& path = "");
+		Texture& ConstructCompressed(RenderDevice& deviceIn, const struct CookedTexture& data, SamplerParameters samplerParams, const std::string& path = "");
 		Texture& ConstructHDRI(RenderDevice& deviceIn, SamplerParameters samplerParams, Vector2 size, float* data, const std::string& path = "");
 		Texture& ConstructRTCubemapTexture(RenderDevice& deviceIn, Vector2 size, SamplerParameters samplerParams, const std::string& path = "");
 		Texture& ConstructRTTexture(RenderDevice& deviceIn, Vector2 size, SamplerParameters samplerParams, bool useBorder = false, const std::string& path = "");
@@ -78,6 +79,7 @@ namespace LinaEngine::Graphics
 		const std::string& GetPath() const { return m_path; }
 		const std::string& GetParamsPath() const { return m_paramsPath; }
 
+		// Compressed textures are cooked into block compressed mip chains & cached next to the source.
 		static Texture& CreateTexture2D(const std::string& filePath, SamplerParameters samplerParams = SamplerParameters(), bool compress = false, bool useDefaultFormats = false, const std::string& paramsPath = "");
 		static Texture& CreateTextureHDRI(const std::string filePath);
 		static Texture& GetTexture(int id);
@@ -0,0 +1,90 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: TextureBuffer
+
+Represents a buffer texture in the shaders, used for data too large for uniform buffers. It creates,
+updates and binds the buffer data.
+
+Timestamp: 10/18/2020 2:14:05 PM
+*/
+
+#pragma once
+
+#ifndef TextureBuffer_HPP
+#define TextureBuffer_HPP
+
+#include "PackageManager/PAMRenderDevice.hpp"
+
+namespace LinaEngine::Graphics
+{
+	class TextureBuffer
+	{
+	public:
+
+		TextureBuffer() {}
+		~TextureBuffer()
+		{
+			if (m_isConstructed)
+				m_engineBoundID = s_renderDevice->ReleaseTextureBuffer(m_engineBoundID);
+		}
+
+		void Construct(RenderDevice& renderDeviceIn, PixelFormat internalFormat, uintptr dataSize, BufferUsage usage, const void* data = nullptr)
+		{
+			s_renderDevice = &renderDeviceIn;
+			m_bufferSize = dataSize;
+			m_engineBoundID = s_renderDevice->CreateTextureBuffer(internalFormat, data, dataSize, usage);
+			m_isConstructed = true;
+		}
+
+		// Binds the buffer texture to the given texture unit.
+		void Bind(uint32 unit)
+		{
+			s_renderDevice->SetTexture(m_engineBoundID, 0, unit, TextureBindMode::BINDTEXTURE_TEXTUREBUFFER);
+		}
+
+		void Update(const void* data, uintptr dataSize)
+		{
+			m_bufferSize = dataSize;
+			s_renderDevice->UpdateTextureBuffer(m_engineBoundID, data, dataSize);
+		}
+
+		uint32 GetID() { return m_engineBoundID; }
+
+	private:
+
+		RenderDevice* s_renderDevice = nullptr;
+		uint32 m_engineBoundID = 0;
+		uintptr m_bufferSize = 0;
+		bool m_isConstructed = false;
+	};
+}
+
+
+#endif
@@ -0,0 +1,106 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/*
+Class: TextureCooker
+
+Cooks 8 bit source images into block compressed textures with a precomputed mip chain & caches them
+next to the source, so the runtime uploads the blocks directly instead of decoding & compressing on the driver.
+
+Timestamp: 12/2/2020 4:18:52 PM
+*/
+
+#pragma once
+
+#ifndef TextureCooker_HPP
+#define TextureCooker_HPP
+
+#include "Rendering/RenderingCommon.hpp"
+#include "Core/SizeDefinitions.hpp"
+#include <string>
+#include <vector>
+
+// "LTEX" in little endian.
+#define TEXTURECOOKER_MAGIC 0x5845544C
+#define TEXTURECOOKER_VERSION 2
+#define TEXTURECOOKER_EXTENSION ".ltex"
+
+// Largest width or height read from a cooked file & the levels of its full mip chain.
+#define TEXTURECOOKER_MAXSIZE 16384
+#define TEXTURECOOKER_MAXLEVELS 15
+
+namespace LinaEngine::Graphics
+{
+	struct CookedTextureLevel
+	{
+		uint32 m_width = 0;
+		uint32 m_height = 0;
+		std::vector<uint8> m_blocks;
+	};
+
+	struct CookedTexture
+	{
+		TextureCompression m_compression = TextureCompression::COMPRESSION_NONE;
+		bool m_sRGB = false;
+		std::vector<CookedTextureLevel> m_levels;
+	};
+
+	class TextureCooker
+	{
+
+	public:
+
+		// Reads the cooked file next to the source, cooks & writes it if it is missing or stale.
+		static bool LoadOrCook(const std::string& sourcePath, bool sRGB, CookedTexture& cooked);
+
+		// Builds the mip chain of an RGBA image & compresses every level, sRGB levels are filtered in linear space.
+		static void Cook(const uint8* rgba, uint32 width, uint32 height, TextureCompression compression, bool sRGB, bool normalMap, CookedTexture& cooked);
+
+		// BC4 for linear grey & BC5 for linear grey alpha sources, sampled back as grey through the swizzle.
+		// BC1 for the rest unless the alpha channel is actually used, grey sRGB sources included as BC4/BC5 have no sRGB formats.
+		static TextureCompression ChooseCompression(const uint8* rgba, uint32 pixelCount, int channels, bool sRGB);
+
+		// Tangent space normal maps decode to unit vectors facing away from the surface.
+		static bool IsNormalMap(const uint8* rgba, uint32 pixelCount);
+
+		// Size of a compressed level in bytes.
+		static uint32 GetLevelSize(TextureCompression compression, uint32 width, uint32 height);
+
+		// Fails if the file is missing, corrupt or was cooked from a different source.
+		static bool Read(const std::string& path, uint64 key, CookedTexture& cooked);
+		static bool Write(const std::string& path, uint64 key, const CookedTexture& cooked);
+
+	private:
+
+		static uint64 GetSourceKey(const std::string& sourcePath, bool sRGB);
+		static void CompressLevel(const uint8* rgba, uint32 width, uint32 height, TextureCompression compression, std::vector<uint8>& blocks);
+	};
+}
+
+#endif
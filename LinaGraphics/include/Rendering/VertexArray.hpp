@@ -62,6 +62,10 @@ namespace LinaEngine::Graphics
 			s_renderDevice = &deviceIn;
 			m_engineBoundID = model.CreateVertexArray(deviceIn, bufferUsage);
 			m_IndexCount = model.GetIndexCount();
+			m_instanceBufferIndex = model.GetInstanceBufferIndex();
+			m_hasQuantizedPositions = model.HasQuantizedPositions();
+			m_positionDequantization = model.GetPositionDequantization();
+			model.CalculateBoundingSphere(m_boundsCenter, m_boundsRadius);
 		}
 
 		void UpdateBuffer(uint32 bufferIndex, const void* data, uintptr dataSize)
@@ -79,11 +83,27 @@ namespace LinaEngine::Graphics
 			return m_IndexCount;  
 		}
 
+		// Local space bounding sphere of the vertices.
+		const Vector3& GetBoundsCenter() const { return m_boundsCenter; }
+		float GetBoundsRadius() const { return m_boundsRadius; }
+
+		// Buffer index the instance model matrices are uploaded to.
+		uint32 GetInstanceBufferIndex() const { return m_instanceBufferIndex; }
+
+		// Quantized positions are mapped back to model space by the instance matrices.
+		bool HasQuantizedPositions() const { return m_hasQuantizedPositions; }
+		const Matrix& GetPositionDequantization() const { return m_positionDequantization; }
+
 	private:
 
 		RenderDevice* s_renderDevice = nullptr;
 		uint32 m_engineBoundID = 0;
 		uint32 m_IndexCount = 0;
+		Vector3 m_boundsCenter = Vector3::Zero;
+		float m_boundsRadius = 0.0f;
+		uint32 m_instanceBufferIndex = 0;
+		bool m_hasQuantizedPositions = false;
+		Matrix m_positionDequantization;
 		
 	};
 
@@ -28,6 +28,7 @@ SOFTWARE.
 
 #include "ECS/Systems/LightingSystem.hpp"  
 #include "Rendering/RenderEngine.hpp"
+#include <emmintrin.h>
 
 namespace LinaEngine::ECS
 {
@@ -65,7 +66,7 @@ namespace LinaEngine::ECS
 		for (auto it = pointLightView.begin(); it != pointLightView.end(); ++it)
 		{
 			PointLightComponent* pLight = &pointLightView.get<PointLightComponent>(*it);
-			if (!pLight->m_isEnabled) return;
+			if (!pLight->m_isEnabled) continue;
 
 			m_pointLights.push_back(std::make_pair(&pointLightView.get<TransformComponent>(*it), pLight));
 		}
@@ -75,114 +76,395 @@ namespace LinaEngine::ECS
 		for (auto it = spotLightView.begin(); it != spotLightView.end(); ++it)
 		{
 			SpotLightComponent* sLight = &spotLightView.get<SpotLightComponent>(*it);
-			if (!sLight->m_isEnabled) return;
+			if (!sLight->m_isEnabled) continue;
 
 			m_spotLights.push_back(std::make_pair(&spotLightView.get<TransformComponent>(*it), sLight));
 		}
 	}
 
-	void LightingSystem::SetLightingShaderData(uint32 shaderID)
+	static void CopyVector(float* dest, const Vector3& v)
 	{
-		// When this function is called it means a shader is activated in the
-		// gpu pipeline, so we go through our available lights and update the shader
-		// data according to their states.
+		dest[0] = v.x;
+		dest[1] = v.y;
+		dest[2] = v.z;
+	}
+
+	static void CopyColor(float* dest, const Color& c)
+	{
+		dest[0] = c.r;
+		dest[1] = c.g;
+		dest[2] = c.b;
+	}
+
+	// Lights w/o a range reach as far as their inverse square falloff stays visible.
+	static float GetLightRange(const Color& color, float distance)
+	{
+		if (distance > 0.0f) return distance;
+		const float intensity = Math::Max(color.r, Math::Max(color.g, color.b));
+		return Math::Max(Math::Sqrt(intensity / SC_LIGHTMININTENSITY), 0.01f);
+	}
+
+	static const uint32 CLUSTER_COUNT = SC_CLUSTERGRIDX * SC_CLUSTERGRIDY * SC_CLUSTERGRIDZ;
+
+	// Conservative tile range covered by [center - radius, center + radius] on one screen axis, for view depths in [zMin, zMax].
+	static void GetClusterTileRange(float center, float radius, float zMin, float zMax, float tanHalfFov, int tileCount, int& first, int& last)
+	{
+		const float low = center - radius;
+		const float high = center + radius;
+		const float ndcMin = Math::Clamp(low / ((low < 0.0f ? zMin : zMax) * tanHalfFov), -2.0f, 2.0f);
+		const float ndcMax = Math::Clamp(high / ((high > 0.0f ? zMin : zMax) * tanHalfFov), -2.0f, 2.0f);
+		first = Math::Max(Math::FloorToInt((ndcMin * 0.5f + 0.5f) * tileCount), 0);
+		last = Math::Min(Math::FloorToInt((ndcMax * 0.5f + 0.5f) * tileCount), tileCount - 1);
+	}
+
+	// Distance from the value to the [min, max] range, 0 inside it.
+	static float DistanceToRange(float value, float min, float max)
+	{
+		return Math::Max(min - value, 0.0f) + Math::Max(value - max, 0.0f);
+	}
+
+	// Cells are tested 4 at a time along the tile rows.
+	static_assert(SC_CLUSTERGRIDX % 4 == 0, "Cluster grid width must be a multiple of 4.");
+
+	void LightingSystem::PackLightData()
+	{
+		// Called once per frame, packs the directional light into the light array buffer & the point and
+		// spot lights into the light data buffer, which is shared by every lit shader. Binding a lit material
+		// does not touch lights anymore.
 
-		// Update directional light data.
+		// Pack directional light data.
 		TransformComponent* dirLightTransform = std::get<0>(m_directionalLight);
 		DirectionalLightComponent* dirLight = std::get<1>(m_directionalLight);
 		if (dirLightTransform != nullptr && dirLight != nullptr)
 		{
 			Vector3 direction = Vector3::Zero - dirLightTransform->transform.GetLocation();
-			s_renderDevice->UpdateShaderUniformColor(shaderID, SC_DIRECTIONALLIGHT + SC_LIGHTCOLOR, dirLight->m_color);
-			s_renderDevice->UpdateShaderUniformVector3(shaderID, SC_DIRECTIONALLIGHT + SC_LIGHTDIRECTION, direction.Normalized());
+			CopyVector(m_lightData.m_directionalLight.m_direction, direction.Normalized());
+			CopyColor(m_lightData.m_directionalLight.m_color, dirLight->m_color);
 		}
 		else
-		{
-			s_renderDevice->UpdateShaderUniformColor(shaderID, SC_DIRECTIONALLIGHT + SC_LIGHTCOLOR, Color::Black);
-		}
+			CopyColor(m_lightData.m_directionalLight.m_color, Color::Black);
 
-		// Iterate point lights.
-		int currentPointLightCount = 0;
+		m_lightBufferData.clear();
 
-		for (std::vector<std::tuple<TransformComponent*, PointLightComponent*>>::iterator it = m_pointLights.begin(); it != m_pointLights.end(); ++it)
+		// Pack point lights, they come first in the buffer.
+		for (std::vector<std::tuple<TransformComponent*, PointLightComponent*>>::iterator it = m_pointLights.begin(); it != m_pointLights.end() && m_lightBufferData.size() < SC_MAXLIGHTS; ++it)
 		{
 			TransformComponent* transform = std::get<0>(*it);
 			PointLightComponent* pointLight = std::get<1>(*it);
-			s_renderDevice->UpdateShaderUniformVector3(shaderID, SC_POINTLIGHTS + "[" + std::to_string(currentPointLightCount) + "]" + SC_LIGHTPOSITION, transform->transform.GetLocation());
-			s_renderDevice->UpdateShaderUniformColor(shaderID, SC_POINTLIGHTS + "[" + std::to_string(currentPointLightCount) + "]" + SC_LIGHTCOLOR, pointLight->m_color);
-			//m_RenderDevice->UpdateShaderUniformFloat(shaderID, SC_POINTLIGHTS + "[" + std::to_string(currentPointLightCount) + "]" + SC_LIGHTDISTANCE, pointLight->distance);
-			currentPointLightCount++;
+			LightBufferData data = {};
+			CopyVector(data.m_position, transform->transform.GetLocation());
+			CopyColor(data.m_color, pointLight->m_color);
+			data.m_distance = GetLightRange(pointLight->m_color, pointLight->m_distance);
+			m_lightBufferData.push_back(data);
 		}
 
-		// Iterate Spot lights.
-		int currentSpotLightCount = 0;
+		m_pointLightCount = (int)m_lightBufferData.size();
 
-		for (std::vector<std::tuple<TransformComponent*, SpotLightComponent*>>::iterator it = m_spotLights.begin(); it != m_spotLights.end(); ++it)
+		// Pack spot lights.
+		for (std::vector<std::tuple<TransformComponent*, SpotLightComponent*>>::iterator it = m_spotLights.begin(); it != m_spotLights.end() && m_lightBufferData.size() < SC_MAXLIGHTS; ++it)
 		{
 			TransformComponent* transform = std::get<0>(*it);
 			SpotLightComponent* spotLight = std::get<1>(*it);
-
-			s_renderDevice->UpdateShaderUniformVector3(shaderID, SC_SPOTLIGHTS + "[" + std::to_string(currentSpotLightCount) + "]" + SC_LIGHTPOSITION, transform->transform.GetLocation());
-			s_renderDevice->UpdateShaderUniformColor(shaderID, SC_SPOTLIGHTS + "[" + std::to_string(currentSpotLightCount) + "]" + SC_LIGHTCOLOR, spotLight->m_color);
-			s_renderDevice->UpdateShaderUniformVector3(shaderID, SC_SPOTLIGHTS + "[" + std::to_string(currentSpotLightCount) + "]" + SC_LIGHTDIRECTION, transform->transform.GetRotation().GetForward());
-			s_renderDevice->UpdateShaderUniformFloat(shaderID, SC_SPOTLIGHTS + "[" + std::to_string(currentSpotLightCount) + "]" + SC_LIGHTCUTOFF, spotLight->m_cutoff);
-			s_renderDevice->UpdateShaderUniformFloat(shaderID, SC_SPOTLIGHTS + "[" + std::to_string(currentSpotLightCount) + "]" + SC_LIGHTOUTERCUTOFF, spotLight->m_outerCutoff);
-			//m_RenderDevice->UpdateShaderUniformFloat(shaderID, SC_SPOTLIGHTS + "[" + std::to_string(currentSpotLightCount) + "]" + SC_LIGHTDISTANCE, spotLight->distance);
-			currentSpotLightCount++;
+			LightBufferData data = {};
+			CopyVector(data.m_position, transform->transform.GetLocation());
+			CopyVector(data.m_direction, transform->transform.GetRotation().GetForward());
+			CopyColor(data.m_color, spotLight->m_color);
+			data.m_cutoff = spotLight->m_cutoff;
+			data.m_outerCutoff = spotLight->m_outerCutoff;
+			data.m_distance = GetLightRange(spotLight->m_color, spotLight->m_distance);
+			m_lightBufferData.push_back(data);
 		}
 
-		m_renderEngine->SetCurrentPLightCount(currentPointLightCount);
-		m_renderEngine->SetCurrentSLightCount(currentSpotLightCount);
-	}
+		m_spotLightCount = (int)m_lightBufferData.size() - m_pointLightCount;
 
-	void LightingSystem::ResetLightData()
-	{
-		m_renderEngine->SetCurrentPLightCount(0);
-		m_renderEngine->SetCurrentSLightCount(0);
+		// GL does not allow zero sized buffer storage.
+		if (m_lightBufferData.empty())
+			m_lightBufferData.push_back(LightBufferData());
+
+		m_renderEngine->SetCurrentPLightCount(m_pointLightCount);
+		m_renderEngine->SetCurrentSLightCount(m_spotLightCount);
 	}
 
-	Matrix LightingSystem::GetDirectionalLightMatrix()
+	void LightingSystem::BuildLightClusters(const Matrix& view, const Matrix& projection, float zNear, float zFar, const Vector2& viewportPos, const Vector2& viewportSize)
 	{
-		// Used for directional shadow mapping.
+		// The view frustum is split into a screen space tile grid & exponential depth slices, each cell is
+		// a view space box. Every light's range sphere is tested against the cells it might overlap, and the
+		// resulting compact index lists let the lit shaders iterate only the lights that can reach a fragment.
+		// Expects PackLightData to be called first.
+
+		const float tanHalfX = 1.0f / projection[0][0];
+		const float tanHalfY = 1.0f / projection[1][1];
+		const float logDepthRatio = Math::Ln(zFar / zNear);
+		const float sliceScale = (float)SC_CLUSTERGRIDZ / logDepthRatio;
+		const float sliceBias = (float)SC_CLUSTERGRIDZ * Math::Ln(zNear) / logDepthRatio;
+
+		float sliceDepths[SC_CLUSTERGRIDZ + 1];
+		for (int k = 0; k <= SC_CLUSTERGRIDZ; k++)
+			sliceDepths[k] = zNear * Math::Pow(zFar / zNear, (float)k / (float)SC_CLUSTERGRIDZ);
+
+		// View space bounds of the cells, x & y bounds only depend on the slice. The x bounds of each slice
+		// are laid out in rows so 4 neighbouring cells are loaded at once.
+		alignas(16) float cellMinX[SC_CLUSTERGRIDZ][SC_CLUSTERGRIDX];
+		alignas(16) float cellMaxX[SC_CLUSTERGRIDZ][SC_CLUSTERGRIDX];
+		float cellMinY[SC_CLUSTERGRIDZ][SC_CLUSTERGRIDY];
+		float cellMaxY[SC_CLUSTERGRIDZ][SC_CLUSTERGRIDY];
+		for (int z = 0; z < SC_CLUSTERGRIDZ; z++)
+		{
+			const float sliceNear = sliceDepths[z];
+			const float sliceFar = sliceDepths[z + 1];
+
+			for (int x = 0; x < SC_CLUSTERGRIDX; x++)
+			{
+				const float ndcMinX = -1.0f + 2.0f * (float)x / (float)SC_CLUSTERGRIDX;
+				const float ndcMaxX = -1.0f + 2.0f * (float)(x + 1) / (float)SC_CLUSTERGRIDX;
+				cellMinX[z][x] = Math::Min(ndcMinX * tanHalfX * sliceNear, ndcMinX * tanHalfX * sliceFar);
+				cellMaxX[z][x] = Math::Max(ndcMaxX * tanHalfX * sliceNear, ndcMaxX * tanHalfX * sliceFar);
+			}
+
+			for (int y = 0; y < SC_CLUSTERGRIDY; y++)
+			{
+				const float ndcMinY = -1.0f + 2.0f * (float)y / (float)SC_CLUSTERGRIDY;
+				const float ndcMaxY = -1.0f + 2.0f * (float)(y + 1) / (float)SC_CLUSTERGRIDY;
+				cellMinY[z][y] = Math::Min(ndcMinY * tanHalfY * sliceNear, ndcMinY * tanHalfY * sliceFar);
+				cellMaxY[z][y] = Math::Max(ndcMaxY * tanHalfY * sliceNear, ndcMaxY * tanHalfY * sliceFar);
+			}
+		}
 
-		TransformComponent* directionalLightTransform = std::get<0>(m_directionalLight);
-		DirectionalLightComponent* light = std::get<1>(m_directionalLight);
+		m_clusterAssignments.clear();
 
-		if (directionalLightTransform == nullptr || light == nullptr) return Matrix();
+		const uint32 lightCount = (uint32)(m_pointLightCount + m_spotLightCount);
+		for (uint32 i = 0; i < lightCount; i++)
+		{
+			const LightBufferData& light = m_lightBufferData[i];
+			// Always positive, ranges are resolved while packing.
+			float radius = light.m_distance;
+
+			Vector3 center = Vector3(light.m_position[0], light.m_position[1], light.m_position[2]);
+
+			// Bound spot lights w/ the sphere around their cone instead of their full range.
+			const bool isSpot = i >= (uint32)m_pointLightCount;
+			if (isSpot && light.m_outerCutoff > 0.0f)
+			{
+				const Vector3 direction = Vector3(light.m_direction[0], light.m_direction[1], light.m_direction[2]);
+				const float cosAngle = light.m_outerCutoff;
+
+				if (cosAngle < 0.70710678f)
+				{
+					center = center + direction * (radius * cosAngle);
+					radius = radius * Math::Sqrt(1.0f - cosAngle * cosAngle);
+				}
+				else
+				{
+					radius = radius / (2.0f * cosAngle);
+					center = center + direction * radius;
+				}
+			}
+
+			const Vector4 viewCenter = view * Vector4(center.x, center.y, center.z, 1.0f);
+			const float zMin = viewCenter.z - radius;
+			const float zMax = viewCenter.z + radius;
+			if (zMax < zNear || zMin > zFar) continue;
+
+			const int firstSlice = Math::Clamp(Math::FloorToInt(Math::Ln(Math::Max(zMin, zNear)) * sliceScale - sliceBias), 0, SC_CLUSTERGRIDZ - 1);
+			const int lastSlice = Math::Clamp(Math::FloorToInt(Math::Ln(Math::Min(zMax, zFar)) * sliceScale - sliceBias), 0, SC_CLUSTERGRIDZ - 1);
+
+			// Screen bounds of the sphere, the whole screen if it crosses the near plane.
+			int firstX = 0, lastX = SC_CLUSTERGRIDX - 1, firstY = 0, lastY = SC_CLUSTERGRIDY - 1;
+			if (zMin > zNear)
+			{
+				GetClusterTileRange(viewCenter.x, radius, zMin, zMax, tanHalfX, SC_CLUSTERGRIDX, firstX, lastX);
+				GetClusterTileRange(viewCenter.y, radius, zMin, zMax, tanHalfY, SC_CLUSTERGRIDY, firstY, lastY);
+			}
+
+			// Sphere to box test, the squared z & y distances are shared by a row & the x distances are found for 4 cells at once.
+			const float radiusSqr = radius * radius;
+			const __m128 centerX = _mm_set1_ps(viewCenter.x);
+			const __m128 radiusSqrX4 = _mm_set1_ps(radiusSqr);
+			const __m128 zero = _mm_setzero_ps();
+
+			for (int z = firstSlice; z <= lastSlice; z++)
+			{
+				const float distanceSqrZ = Math::Square(DistanceToRange(viewCenter.z, sliceDepths[z], sliceDepths[z + 1]));
+				if (distanceSqrZ > radiusSqr) continue;
+
+				for (int y = firstY; y <= lastY; y++)
+				{
+					const float distanceSqrYZ = distanceSqrZ + Math::Square(DistanceToRange(viewCenter.y, cellMinY[z][y], cellMaxY[z][y]));
+					if (distanceSqrYZ > radiusSqr) continue;
+
+					const __m128 distanceSqrYZX4 = _mm_set1_ps(distanceSqrYZ);
+					for (int x = firstX & ~3; x <= lastX; x += 4)
+					{
+						const __m128 below = _mm_max_ps(_mm_sub_ps(_mm_load_ps(&cellMinX[z][x]), centerX), zero);
+						const __m128 above = _mm_max_ps(_mm_sub_ps(centerX, _mm_load_ps(&cellMaxX[z][x])), zero);
+						const __m128 distanceX = _mm_add_ps(below, above);
+						const __m128 distanceSqr = _mm_add_ps(_mm_mul_ps(distanceX, distanceX), distanceSqrYZX4);
+						int hits = _mm_movemask_ps(_mm_cmple_ps(distanceSqr, radiusSqrX4));
+
+						// Drop the lanes outside the light's tile range.
+						if (x < firstX) hits &= 0xF << (firstX - x);
+						if (x + 3 > lastX) hits &= 0xF >> (x + 3 - lastX);
+
+						for (int lane = 0; lane < 4; lane++)
+						{
+							if (hits & (1 << lane))
+								m_clusterAssignments.push_back(std::make_pair((uint32)(x + lane + SC_CLUSTERGRIDX * (y + SC_CLUSTERGRIDY * z)), i));
+						}
+					}
+				}
+			}
+		}
 
-		Matrix lightProjection = Matrix::Orthographic(light->m_shadowOrthoProjection.x, light->m_shadowOrthoProjection.y, light->m_shadowOrthoProjection.z, light->m_shadowOrthoProjection.w, light->m_shadowZNear, light->m_shadowZFar);
-	//	Matrix lightView = Matrix::TransformMatrix(directionalLightTransform->transform.GetLocation(), directionalLightTransform->transform.GetRotation(), Vector3::One);
-		Matrix lightView = glm::lookAt(directionalLightTransform->transform.GetLocation(), glm::vec3(0.0f), glm::vec3(0.0, 1.0, 0.0));
+		// Compact the assignments into per cluster (offset, count) pairs & a single index list, lights keep
+		// their buffer order within a cluster.
+		m_clusterGrid.assign(CLUSTER_COUNT * 2, 0);
 
+		for (std::vector<std::pair<uint32, uint32>>::iterator it = m_clusterAssignments.begin(); it != m_clusterAssignments.end(); ++it)
+		{
+			uint32& count = m_clusterGrid[it->first * 2 + 1];
+			if (count < SC_MAXLIGHTSPERCLUSTER)
+				count++;
+		}
 
+		uint32 offset = 0;
+		for (uint32 cluster = 0; cluster < CLUSTER_COUNT; cluster++)
+		{
+			m_clusterGrid[cluster * 2] = offset;
+			offset += m_clusterGrid[cluster * 2 + 1];
+			m_clusterGrid[cluster * 2 + 1] = 0;
+		}
+
+		// GL does not allow zero sized buffer storage.
+		m_clusterLightIndices.resize(Math::Max(offset, 1u));
+
+		for (std::vector<std::pair<uint32, uint32>>::iterator it = m_clusterAssignments.begin(); it != m_clusterAssignments.end(); ++it)
+		{
+			uint32& count = m_clusterGrid[it->first * 2 + 1];
+			if (count < SC_MAXLIGHTSPERCLUSTER)
+				m_clusterLightIndices[m_clusterGrid[it->first * 2] + count++] = it->second;
+		}
 
-		//Matrix lightProjection = Matrix::Orthographic(light->m_shadowOrthoProjection.x, light->m_shadowOrthoProjection.y, light->m_shadowOrthoProjection.z, light->m_shadowOrthoProjection.w, 
-			//light->m_shadowZNear, light->m_shadowZFar);
-		Vector3 location = directionalLightTransform->transform.GetLocation();
-		Quaternion rotation = directionalLightTransform->transform.GetRotation();
-		//Matrix lightView = Matrix::InitLookAt(location, location + rotation.GetForward().Normalized(), Vector3::Up);
-		return lightProjection * lightView;
-		//Matrix lightView = Matrix::InitRotationFromDirection(directionalLightTransform->transform.rotation.GetForward(), directionalLightTransform->transform.rotation.GetUp());
-		//Matrix lightView = Matrix::InitLookAt(directionalLightTransform == nullptr ? Vector3::Zero : directionalLightTransform->transform.location, Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
-		//Matrix lightView = glm::lookAt(directionalLightTransform->transform.location, glm::vec3(0.0f), glm::vec3(0.0, 1.0, 0.0));
-		//Matrix lightView = Matrix::InitRotationFromDirection(directionalLightTransform->transform.rotation.GetForward(), directionalLightTransform->transform.rotation.GetUp());
-		//Matrix lightView = glm::lookAt(directionalLightTransform->transform.location, glm::vec3(0.0f), glm::vec3(0.0, 1.0, 0.0));
-		//glm::mat4 lightView = glm::lookAt(directionalLightTransform->transform.location,
-		//	glm::vec3(0.0f, 0.0f, 0.0f),
-		//	glm::vec3(0.0f, 1.0f, 0.0f));
+		// Parameters the shaders use to find the cluster of a fragment.
+		m_lightData.m_clusterScreen[0] = viewportPos.x;
+		m_lightData.m_clusterScreen[1] = viewportPos.y;
+		m_lightData.m_clusterScreen[2] = (float)SC_CLUSTERGRIDX / Math::Max(viewportSize.x, 1.0f);
+		m_lightData.m_clusterScreen[3] = (float)SC_CLUSTERGRIDY / Math::Max(viewportSize.y, 1.0f);
+		m_lightData.m_clusterDepth[0] = sliceScale;
+		m_lightData.m_clusterDepth[1] = sliceBias;
+		m_lightData.m_clusterDepth[2] = zNear;
+		m_lightData.m_clusterDepth[3] = zFar;
+	}
 
-	//	return lightView * lightProjection;
+	void LightingSystem::ResetLightData()
+	{
+		m_pointLightCount = m_spotLightCount = 0;
+		m_renderEngine->SetCurrentPLightCount(0);
+		m_renderEngine->SetCurrentSLightCount(0);
 	}
 
-	Matrix LightingSystem::GetDirLightBiasMatrix()
+	void LightingSystem::BuildShadowCascades(const Matrix& view, const Matrix& projection, float zNear, float zFar, const Vector2& atlasResolution)
 	{
-		glm::mat4 biasMatrix(
-			0.5, 0.0, 0.0, 0.0,
-			0.0, 0.5, 0.0, 0.0,
-			0.0, 0.0, 0.5, 0.0,
-			0.5, 0.5, 0.5, 1.0
-		);
-		return GetDirectionalLightMatrix() * biasMatrix;
+		// Splits the camera frustum into slices & fits an orthographic light frustum around each one, every cascade
+		// is drawn into its own tile of the shadow atlas.
+		TransformComponent* dirLightTransform = std::get<0>(m_directionalLight);
+		DirectionalLightComponent* dirLight = std::get<1>(m_directionalLight);
+		m_shadowCascadeCount = dirLightTransform != nullptr && dirLight != nullptr ? Math::Clamp(dirLight->m_cascadeCount, 0, SC_MAXSHADOWCASCADES) : 0;
+		m_lightData.m_shadowParams[0] = m_shadowCascadeCount;
+		if (m_shadowCascadeCount == 0) return;
+
+		Vector3 lightDirection = (Vector3::Zero - dirLightTransform->transform.GetLocation()).Normalized();
+		Vector3 up = Math::Abs(lightDirection.y) > 0.99f ? Vector3(0.0f, 0.0f, 1.0f) : Vector3(0.0f, 1.0f, 0.0f);
+		float shadowFar = Math::Min(zFar, Math::Max(dirLight->m_shadowDistance, zNear));
+
+		// View space rays through the frustum corners, scaled so that their z is 1.
+		Matrix inverseProjection = projection.Inverse();
+		Matrix inverseView = view.Inverse();
+		Vector3 cornerRays[4];
+		for (int i = 0; i < 4; i++)
+		{
+			Vector4 corner = inverseProjection * Vector4(i % 2 == 0 ? -1.0f : 1.0f, i < 2 ? -1.0f : 1.0f, 1.0f, 1.0f);
+			cornerRays[i] = Vector3(corner.x / corner.z, corner.y / corner.z, 1.0f);
+		}
+
+		// Cascades are laid out in a 2x2 grid in the atlas.
+		Vector2 tileResolution = atlasResolution * 0.5f;
+		float splitNear = zNear;
+
+		for (int i = 0; i < m_shadowCascadeCount; i++)
+		{
+			ShadowCascade& cascade = m_shadowCascades[i];
+
+			// Practical split scheme, blends logarithmic & uniform splits.
+			float ratio = (float)(i + 1) / (float)m_shadowCascadeCount;
+			float logSplit = zNear * Math::Pow(shadowFar / zNear, ratio);
+			float uniformSplit = zNear + (shadowFar - zNear) * ratio;
+			cascade.m_splitFar = Math::Lerp(uniformSplit, logSplit, dirLight->m_cascadeSplitLambda);
+
+			// Bounding sphere of the slice, its size does not change w/ camera rotation.
+			Vector3 corners[8];
+			Vector3 center = Vector3::Zero;
+			for (int j = 0; j < 8; j++)
+			{
+				Vector3 viewCorner = cornerRays[j % 4] * (j < 4 ? splitNear : cascade.m_splitFar);
+				Vector4 worldCorner = inverseView * Vector4(viewCorner.x, viewCorner.y, viewCorner.z, 1.0f);
+				corners[j] = Vector3(worldCorner.x, worldCorner.y, worldCorner.z);
+				center += corners[j];
+			}
+			center /= 8.0f;
+
+			float radius = 0.0f;
+			for (int j = 0; j < 8; j++)
+				radius = Math::Max(radius, (corners[j] - center).Magnitude());
+
+			// The light frustum is fitted w/ a margin & stays in place while the slice remains inside it, so the
+			// cascade matrices & the cached static shadows only change once the camera moves past the margin.
+			float casterDistance = Math::Max(dirLight->m_shadowCasterDistance, 0.0f);
+			float paddedRadius = Math::CeilToFloat(radius * (1.0f + SC_SHADOWCASCADEMARGIN) * 16.0f) / 16.0f;
+			bool outside = (center - cascade.m_center).Magnitude() + radius > cascade.m_radius;
+			bool oversized = cascade.m_radius > paddedRadius * (1.0f + SC_SHADOWCASCADEMARGIN);
+			bool lightChanged = cascade.m_lightDirection != lightDirection || cascade.m_casterDistance != casterDistance;
+
+			if (outside || oversized || lightChanged)
+			{
+				cascade.m_center = center;
+				cascade.m_radius = paddedRadius;
+				cascade.m_lightDirection = lightDirection;
+				cascade.m_casterDistance = casterDistance;
+
+				// Pull the light back so the casters in front of the slice are included.
+				cascade.m_view = Matrix::InitLookAt(center - lightDirection * (paddedRadius + casterDistance), center, up);
+				cascade.m_projection = Matrix::Orthographic(-paddedRadius, paddedRadius, -paddedRadius, paddedRadius, 0.0f, paddedRadius * 2.0f + casterDistance);
+
+				// Snap the projection to whole texels so the shadow edges do not crawl when the cascade moves.
+				Vector4 origin = (cascade.m_projection * cascade.m_view) * Vector4(0.0f, 0.0f, 0.0f, 1.0f);
+				float texelX = origin.x * tileResolution.x * 0.5f;
+				float texelY = origin.y * tileResolution.y * 0.5f;
+				cascade.m_projection[3][0] += (Math::RoundToFloat(texelX) - texelX) * 2.0f / tileResolution.x;
+				cascade.m_projection[3][1] += (Math::RoundToFloat(texelY) - texelY) * 2.0f / tileResolution.y;
+			}
+
+			cascade.m_atlasSize = tileResolution;
+			cascade.m_atlasOffset = Vector2((float)(i % 2) * tileResolution.x, (float)(i / 2) * tileResolution.y);
+
+			// Maps world positions directly to the atlas tile & the [0, 1] depth range.
+			float tileX = (float)(i % 2) * 0.5f;
+			float tileY = (float)(i / 2) * 0.5f;
+			Matrix atlasBias = Matrix::Identity();
+			atlasBias[0][0] = 0.25f;
+			atlasBias[1][1] = 0.25f;
+			atlasBias[2][2] = 0.5f;
+			atlasBias[3][0] = tileX + 0.25f;
+			atlasBias[3][1] = tileY + 0.25f;
+			atlasBias[3][2] = 0.5f;
+			m_lightData.m_shadowMatrices[i] = atlasBias * cascade.m_projection * cascade.m_view;
+			m_lightData.m_shadowCascadeSplits[i] = cascade.m_splitFar;
+			m_lightData.m_shadowAtlasRects[i][0] = tileX;
+			m_lightData.m_shadowAtlasRects[i][1] = tileY;
+			m_lightData.m_shadowAtlasRects[i][2] = 0.5f;
+			m_lightData.m_shadowAtlasRects[i][3] = 0.5f;
+
+			splitNear = cascade.m_splitFar;
+		}
 	}
 
 	const Vector3& LightingSystem::GetDirectionalLightPos()
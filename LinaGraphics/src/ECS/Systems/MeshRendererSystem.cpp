@@ -32,150 +32,187 @@ SOFTWARE.
 #include "Rendering/Mesh.hpp"
 #include "Rendering/RenderEngine.hpp"
 #include "Rendering/Material.hpp"
+#include <functional>
 
 namespace LinaEngine::ECS
 {
-
-
-	void MeshRendererSystem::UpdateComponents(float delta)
+	static void HashCombine(size_t& seed, size_t value)
 	{
-		auto view = m_ecs->view<TransformComponent, MeshRendererComponent>();
-
-		for (auto entity : view)
-		{
-			MeshRendererComponent& renderer = view.get<MeshRendererComponent>(entity);
-			if (!renderer.m_isEnabled) return;
+		seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	}
 
-			TransformComponent& transform = view.get<TransformComponent>(entity);
+	// Ratio of the screen height covered by the bounding sphere.
+	static float GetProjectedSize(const Graphics::RenderView& view, Vector3 center, float radius)
+	{
+		if (view.m_projection[3][3] == 1.0f)
+			return radius * view.m_projection[1][1];
 
-			// Dont draw if mesh or material does not exist.
-			if (renderer.m_materialID < 0 || renderer.m_meshID < 0) continue;
+		float distance = (center - view.m_location).Magnitude();
+		if (distance <= radius) return 1.0f;
 
-			// We get the materials, then according to their surface types we add the mesh
-			// data into either opaque queue or the transparent queue.
-			Graphics::Material& mat = LinaEngine::Graphics::Material::GetMaterial(renderer.m_materialID);
-			Graphics::Mesh& mesh = LinaEngine::Graphics::Mesh::GetMesh(renderer.m_meshID);
+		return radius * view.m_projection[1][1] / distance;
+	}
 
-			if (mat.GetSurfaceType() == Graphics::MaterialSurfaceType::Opaque)
-			{
-				for (int i = 0; i < mesh.GetVertexArrays().size(); i++)
-					RenderOpaque(*mesh.GetVertexArray(i), mat, transform.transform.ToMatrix());
-			}
-			else
-			{
-				// Transparent queue is a priority queue unlike the opaque one, so we set the priority as distance to the camera.
-				float priority = (m_renderEngine->GetCameraSystem()->GetCameraLocation() - transform.transform.GetLocation()).MagnitudeSqrt();
+	// Whether the renderer is still in the state its static batch source was built from.
+	static bool IsBatchSourceValid(const MeshRendererComponent& renderer, const Matrix& model, const Graphics::StaticBatchSource& source)
+	{
+		if (!renderer.m_isEnabled || !renderer.m_isStatic) return false;
+		if (!Graphics::Material::MaterialExists(renderer.m_materialID) || !Graphics::Mesh::MeshExists(renderer.m_meshID)) return false;
 
-				for (int i = 0; i < mesh.GetVertexArrays().size(); i++)
-					RenderTransparent(*mesh.GetVertexArray(i), mat, transform.transform.ToMatrix(), priority);
-			}
-		}
+		Graphics::Material& mat = Graphics::Material::GetMaterial(renderer.m_materialID);
+		if (&mat != source.m_material || mat.GetSurfaceType() != Graphics::MaterialSurfaceType::Opaque) return false;
+		if (&Graphics::Mesh::GetMesh(renderer.m_meshID) != source.m_mesh) return false;
 
+		return model == source.m_model;
 	}
 
-	void MeshRendererSystem::RenderOpaque(Graphics::VertexArray& vertexArray, Graphics::Material& material, const Matrix& transformIn)
+	int MeshRendererSystem::SelectLOD(int currentLOD, int lodCount, float screenSize)
 	{
-		// Render commands basically add the necessary
-		// draw data into the maps/lists etc.
-		Graphics::BatchDrawData drawData;
-		drawData.m_vertexArray = &vertexArray;
-		drawData.m_material = &material;
-		m_opaqueRenderBatch[drawData].m_models.push_back(transformIn);
-		m_opaqueRenderBatch[drawData].m_inverseTransposeModels.push_back(transformIn.Transpose().Inverse());
-	}
+		int lod = Math::Min(Math::Max(currentLOD, 0), lodCount - 1);
 
-	void MeshRendererSystem::RenderTransparent(Graphics::VertexArray& vertexArray, Graphics::Material& material, const Matrix& transformIn,float priority)
-	{
-		// Render commands basically add the necessary
-		// draw data into the maps/lists etc.
-		Graphics::BatchDrawData drawData;
-		drawData.m_vertexArray = &vertexArray;
-		drawData.m_material = &material;
-		drawData.m_distance = priority;
-
-		Graphics::BatchModelData modelData;
-		modelData.m_models.push_back(transformIn);
-		modelData.m_inverseTransposeModels.push_back(transformIn.Transpose().Inverse());
-		m_transparentRenderBatch.emplace(std::make_pair(drawData, modelData));	
+		// Level 1 is used below SC_LODSCREENSIZE, each next level at half the size of the previous one.
+		auto threshold = [](int level) { return SC_LODSCREENSIZE / (float)(1 << (level - 1)); };
+
+		// Switch only once the size is clearly past the threshold, so objects near it do not pop back & forth.
+		while (lod < lodCount - 1 && screenSize < threshold(lod + 1) * (1.0f - SC_LODHYSTERESIS))
+			lod++;
+
+		while (lod > 0 && screenSize > threshold(lod) * (1.0f + SC_LODHYSTERESIS))
+			lod--;
+
+		return lod;
 	}
 
-	void MeshRendererSystem::FlushOpaque(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial, bool completeFlush)
+	void MeshRendererSystem::UpdateComponents(float delta)
 	{
-		// When flushed, all the data is delegated to the render device to do the actual
-		// drawing. Then the data is cleared if complete flush is requested.
+		// Packets hold everything that does not depend on a view, so the matrices & bounds are
+		// calculated once per frame no matter how many views draw them.
+		m_packets.clear();
+		m_staticShadowPackets.clear();
+		m_occluders.clear();
+		m_staticStateHash = 0;
+		m_lodStats = LODStats();
+
+		// Levels of detail are selected from the main view & shared by every view drawing the packets.
+		Graphics::RenderView mainView = m_renderEngine->GetMainView();
+
+		// Renderers still drawn by the static batches, each source can only be claimed once as copies keep the index.
+		Graphics::StaticBatcher& batcher = m_renderEngine->GetStaticBatcher();
+		const std::vector<Graphics::StaticBatchSource>& batchSources = batcher.GetSources();
+		std::vector<MeshRendererComponent*> batchedRenderers;
+		std::vector<bool> claimedSources(batchSources.size(), false);
+		bool batchesChanged = false;
 
-		for (std::map<Graphics::BatchDrawData, Graphics::BatchModelData>::iterator it = m_opaqueRenderBatch.begin(); it != m_opaqueRenderBatch.end(); ++it)
+		auto view = m_ecs->view<TransformComponent, MeshRendererComponent>();
+
+		for (auto entity : view)
 		{
-			// Get references.
-			Graphics::BatchDrawData drawData = it->first;
-			Graphics::BatchModelData& modelData = it->second;
-			size_t numTransforms = modelData.m_models.size();
-			if (numTransforms == 0) continue;
+			MeshRendererComponent& renderer = view.get<MeshRendererComponent>(entity);
+			TransformComponent& transform = view.get<TransformComponent>(entity);
+			Matrix model = transform.transform.ToMatrix();
 
-			Graphics::VertexArray* vertexArray = drawData.m_vertexArray;
-			Matrix* models = &modelData.m_models[0];
-			Matrix* inverseTransposeModels = &modelData.m_inverseTransposeModels[0];
+			// Renderers moved, disabled, re-materialed or no longer static are dropped from the batches & drawn on their own.
+			if (renderer.m_batchSource >= 0)
+			{
+				int source = renderer.m_batchSource;
+				if (source < (int)batchSources.size() && !claimedSources[source] && IsBatchSourceValid(renderer, model, batchSources[source]))
+				{
+					claimedSources[source] = true;
+					batchedRenderers.push_back(&renderer);
+				}
+				else
+				{
+					renderer.m_batchSource = -1;
+					batchesChanged = true;
+				}
+			}
 
-			// Get the material for drawing, object's own material or overriden material.
-			Graphics::Material* mat = overrideMaterial == nullptr ? drawData.m_material : overrideMaterial;
+			if (!renderer.m_isEnabled) continue;
 
-			// Draw call.
-			// Update the buffer w/ each transform.
-			vertexArray->UpdateBuffer(5, models, numTransforms * sizeof(Matrix));
-			vertexArray->UpdateBuffer(6, inverseTransposeModels, numTransforms * sizeof(Matrix));
+			// Dont draw if mesh or material does not exist.
+			if (renderer.m_materialID < 0 || renderer.m_meshID < 0) continue;
 
-			m_renderEngine->UpdateShaderData(mat);
-			s_renderDevice->Draw(vertexArray->GetID(), drawParams, numTransforms, vertexArray->GetIndexCount(), false);
+			Graphics::Material& mat = LinaEngine::Graphics::Material::GetMaterial(renderer.m_materialID);
+			Graphics::Mesh& mesh = LinaEngine::Graphics::Mesh::GetMesh(renderer.m_meshID);
 
-			// Clear the buffer.
-			if (completeFlush)
+			// Occluders still hide the others when they are drawn by a static batch.
+			if (renderer.m_isOccluder && mat.GetSurfaceType() == Graphics::MaterialSurfaceType::Opaque)
 			{
-				modelData.m_models.clear();
-				modelData.m_inverseTransposeModels.clear();
+				for (const Graphics::OccluderGeometry& geometry : mesh.GetOccluderGeometry())
+				{
+					Graphics::Occluder occluder;
+					occluder.m_geometry = &geometry;
+					occluder.m_model = model;
+					m_occluders.push_back(occluder);
+				}
 			}
-		}
-	}
 
-	void MeshRendererSystem::FlushTransparent(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial, bool completeFlush)
-	{
-		// When flushed, all the data is delegated to the render device to do the actual
-		// drawing. Then the data is cleared if complete flush is requested.
+			// Batched renderers are drawn by their static batch.
+			if (renderer.m_batchSource >= 0) continue;
 
-		// Empty out the queue
-		while (!m_transparentRenderBatch.empty())
-		{
-			BatchPair pair = m_transparentRenderBatch.top();
-
-			Graphics::BatchDrawData& drawData = std::get<0>(pair);
-			Graphics::BatchModelData& modelData = std::get<1>(pair);
-			size_t numTransforms = modelData.m_models.size();
-			if (numTransforms == 0) continue;
+			Graphics::RenderPacket packet;
+			packet.m_material = &mat;
+			packet.m_model = model;
+			packet.m_isTransparent = mat.GetSurfaceType() != Graphics::MaterialSurfaceType::Opaque;
+			packet.m_isStatic = renderer.m_isStatic;
 
-			Graphics::VertexArray* vertexArray = drawData.m_vertexArray;
-			Matrix* models = &modelData.m_models[0];
-			Matrix* inverseTransposeModels = &modelData.m_inverseTransposeModels[0];
-
-			// Get the material for drawing, object's own material or overriden material.
-			Graphics::Material* mat = overrideMaterial == nullptr ? drawData.m_material : overrideMaterial;
+			// Bounds are taken from the full detail sub-meshes, the largest one on screen selects the level for all.
+			size_t firstPacket = m_packets.size();
+			float screenSize = 0.0f;
+			for (int i = 0; i < mesh.GetVertexArrays().size(); i++)
+			{
+				packet.m_vertexArray = mesh.GetVertexArray(i);
+				Graphics::DrawList::CalculatePacketBounds(packet);
+				m_packets.push_back(packet);
+				screenSize = Math::Max(screenSize, GetProjectedSize(mainView, packet.m_boundsCenter, packet.m_boundsRadius));
+			}
 
-			// Draw call.
-			// Update the buffer w/ each transform.
-			vertexArray->UpdateBuffer(5, models, numTransforms * sizeof(Matrix));
-			vertexArray->UpdateBuffer(6, inverseTransposeModels, numTransforms * sizeof(Matrix));
+			renderer.m_lod = SelectLOD(renderer.m_lod, (int)mesh.GetLODCount(), screenSize);
 
-			m_renderEngine->UpdateShaderData(mat);
-			s_renderDevice->Draw(vertexArray->GetID(), drawParams, numTransforms, vertexArray->GetIndexCount(), false);
+			for (size_t i = firstPacket; i < m_packets.size(); i++)
+			{
+				Graphics::RenderPacket& lodPacket = m_packets[i];
+				m_lodStats.m_fullTriangles += lodPacket.m_vertexArray->GetIndexCount() / 3;
+
+				// Static casters are cached in the shadows at full detail, so the static state does not depend on the main view.
+				if (lodPacket.m_isStatic)
+				{
+					lodPacket.m_modelBufferIndex = lodPacket.m_vertexArray->GetInstanceBufferIndex();
+					m_staticShadowPackets.push_back(lodPacket);
+
+					HashCombine(m_staticStateHash, std::hash<const void*>()(lodPacket.m_vertexArray));
+					const float* model = &lodPacket.m_model[0][0];
+					for (int j = 0; j < 16; j++)
+						HashCombine(m_staticStateHash, std::hash<float>()(model[j]));
+				}
+
+				lodPacket.m_vertexArray = mesh.GetLODVertexArray(renderer.m_lod, (uint32)(i - firstPacket));
+				lodPacket.m_modelBufferIndex = lodPacket.m_vertexArray->GetInstanceBufferIndex();
+				m_lodStats.m_drawnTriangles += lodPacket.m_vertexArray->GetIndexCount() / 3;
+			}
+		}
 
-			// Clear the buffer.
-			if (completeFlush)
+		// Rebuild the batches w/o the dropped or deleted renderers.
+		if (batchesChanged || batchedRenderers.size() != batchSources.size())
+		{
+			std::vector<Graphics::StaticBatchSource> sources;
+			for (size_t i = 0; i < batchedRenderers.size(); i++)
 			{
-				modelData.m_models.clear();
-				modelData.m_inverseTransposeModels.clear();
+				sources.push_back(batchSources[batchedRenderers[i]->m_batchSource]);
+				batchedRenderers[i]->m_batchSource = (int)i;
 			}
 
-			m_transparentRenderBatch.pop();
+			batcher.Rebuild(sources);
 		}
-		
-	}
 
-}
\ No newline at end of file
+		// Merged static batches, already in world space.
+		const std::vector<Graphics::RenderPacket>& batchPackets = batcher.GetPackets();
+		for (const Graphics::RenderPacket& packet : batchPackets)
+		{
+			m_packets.push_back(packet);
+			m_staticShadowPackets.push_back(packet);
+			HashCombine(m_staticStateHash, std::hash<const void*>()(packet.m_vertexArray));
+			HashCombine(m_staticStateHash, packet.m_firstIndex);
+		}
+	}
+}
@@ -30,6 +30,7 @@ SOFTWARE.
 #include "ECS/Components/TransformComponent.hpp"
 #include "ECS/Components/SpriteRendererComponent.hpp"
 #include "Rendering/RenderEngine.hpp"
+#include "Rendering/Material.hpp"
 
 namespace LinaEngine::ECS
 {
@@ -44,62 +45,45 @@ namespace LinaEngine::ECS
 
 	void SpriteRendererSystem::UpdateComponents(float delta)
 	{
+		m_packets.clear();
+
+		Graphics::SpriteBatcher& batcher = m_renderEngine->GetSpriteBatcher();
+		batcher.Begin();
+
 		auto view = m_ecs->view<TransformComponent, SpriteRendererComponent>();
 
-		// Find the sprites and add them to the render queue.
+		// Find the sprites and gather them into packets.
 		for (auto entity : view)
 		{
 			SpriteRendererComponent& renderer = view.get<SpriteRendererComponent>(entity);
-			if (!renderer.m_isEnabled) return;
+			if (!renderer.m_isEnabled) continue;
 
 			TransformComponent& transform = view.get<TransformComponent>(entity);
 
 			// Dont draw if mesh or material does not exist.
 			if (renderer.m_materialID < 0) continue;
 
-			Graphics::Material& mat = LinaEngine::Graphics::Material::GetMaterial(renderer.m_materialID);
-			Render(mat, transform.transform.ToMatrix());
-		}
-	}
-
-	void SpriteRendererSystem::Render(Graphics::Material& material, const Matrix& transformIn)
-	{
-		m_renderBatch[&material].m_models.push_back(transformIn);
-		m_renderBatch[&material].m_inverseTransposeModels.push_back(transformIn.Transpose().Inverse());
-	}
-
-	void SpriteRendererSystem::Flush(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial, bool completeFlush)
-	{
-		// When flushed, all the data is delegated to the render device to do the actual
-		// drawing. Then the data is cleared if complete flush is requested.
+			Graphics::Material* material = &LinaEngine::Graphics::Material::GetMaterial(renderer.m_materialID);
 
-		for (std::map<Graphics::Material*, BatchModelData>::iterator it = m_renderBatch.begin(); it != m_renderBatch.end(); ++it)
-		{
-			// Get references.
-			BatchModelData& modelData = it->second;
-			size_t numTransforms = modelData.m_models.size();
-			if (numTransforms == 0) continue;
-
-			Matrix* models = &modelData.m_models[0];
-			Matrix* inverseTransposeModels = &modelData.m_inverseTransposeModels[0];
-
-			// Get the material for drawing, object's own material or overriden material.
-			Graphics::Material* mat = overrideMaterial == nullptr ? it->first : overrideMaterial;
-
-			// Draw call.
-			// Update the buffer w/ each transform.
-			m_spriteVertexArray.UpdateBuffer(2, models, numTransforms * sizeof(Matrix));
-			m_spriteVertexArray.UpdateBuffer(3, inverseTransposeModels, numTransforms * sizeof(Matrix));
-
-			m_renderEngine->UpdateShaderData(mat);
-			s_renderDevice->Draw(m_spriteVertexArray.GetID(), drawParams, numTransforms, m_spriteVertexArray.GetIndexCount(), false);
-
-			// Clear the buffer.
-			if (completeFlush)
+			// Textured sprites of the standard shader are drawn from the atlas, the rest w/ their own materials.
+			if (material->GetShaderType() == Graphics::Shaders::Standard_Sprite)
 			{
-				modelData.m_models.clear();
-				modelData.m_inverseTransposeModels.clear();
+				Graphics::MaterialSampler2D& diffuse = material->m_sampler2Ds[MAT_TEXTURE2D_DIFFUSE];
+				Graphics::SpriteAtlasEntry entry;
+				if (diffuse.m_isActive && batcher.GetAtlasEntry(diffuse.m_boundTexture, entry) && batcher.Add(transform.transform.ToMatrix(), material->GetColor(MAT_OBJECTCOLORPROPERTY), renderer.m_layer, entry))
+					continue;
 			}
+
+			Graphics::RenderPacket packet;
+			packet.m_vertexArray = &m_spriteVertexArray;
+			packet.m_material = material;
+			packet.m_model = transform.transform.ToMatrix();
+			packet.m_modelBufferIndex = 2;
+			packet.m_isTransparent = packet.m_material->GetSurfaceType() != Graphics::MaterialSurfaceType::Opaque;
+			Graphics::DrawList::CalculatePacketBounds(packet);
+			m_packets.push_back(packet);
 		}
+
+		batcher.End();
 	}
-}
\ No newline at end of file
+}
@@ -27,9 +27,13 @@ SOFTWARE.
 */
 
 #include "PackageManager/OpenGL/GLRenderDevice.hpp"  
+#include "Rendering/RenderConstants.hpp"
 #include "Utility/Math/Color.hpp"
 #include "PackageManager/Generic/GenericMemory.hpp"
 #include "glad/glad.h"
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
 
 namespace LinaEngine::Graphics
 {
@@ -49,6 +53,14 @@ namespace LinaEngine::Graphics
 #define FOURCC_DXT4 MAKEFOURCCDXT('4')
 #define FOURCC_DXT5 MAKEFOURCCDXT('5')
 
+// EXT_texture_sRGB, not part of the generated loader.
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
 
 	// ---------------------------------------------------------------------
 	// ---------------------------------------------------------------------
@@ -188,7 +200,10 @@ namespace LinaEngine::Graphics
 	static bool AddShader(GLuint shaderProgram, const std::string& text, GLenum type, std::vector<GLuint>* shaders);
 	static void AddAllAttributes(GLuint program, const std::string& vertexShaderText, uint32 version);
 	static bool CheckShaderError(GLuint shader, int flag, bool isProgram, const std::string& errorMessage);
-	static void AddShaderUniforms(GLuint shaderProgram, const std::string& shaderText, std::map<std::string, GLint>& uniformBlockMap, std::map<std::string, GLint>& uniformMap, std::map<std::string, GLint>& samplerMap);
+	static void AddShaderUniforms(GLuint shaderProgram, ShaderProgram& programData);
+	static uint64 GetTextureUploadSize(const Vector2& size, GLint format, uint64 bytesPerChannel);
+	static bool LoadProgramBinary(GLuint program, const std::string& path);
+	static void SaveProgramBinary(GLuint program, const std::string& path);
 
 	GLRenderDevice::GLRenderDevice()
 	{
@@ -198,7 +213,8 @@ namespace LinaEngine::Graphics
 
 	GLRenderDevice::~GLRenderDevice()
 	{
-
+		if (m_indirectBuffer != 0)
+			glDeleteBuffers(1, &m_indirectBuffer);
 	}
 
 
@@ -208,6 +224,16 @@ namespace LinaEngine::Graphics
 		const GLubyte* renderer = glGetString(GL_RENDERER); // Returns a hint to the model
 		LINA_CORE_TRACE("Graphics Information: {0}, {1}", vendor, renderer);
 
+		// Program binaries are core since 4.1, the driver needs to expose at least one format.
+		const GLubyte* glVersion = glGetString(GL_VERSION);
+		m_driverIdentity = std::string((const char*)vendor) + "|" + std::string((const char*)renderer) + "|" + std::string((const char*)glVersion);
+		if (glProgramBinary != nullptr && glGetProgramBinary != nullptr)
+		{
+			GLint binaryFormats = 0;
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormats);
+			m_programBinarySupported = binaryFormats > 0;
+		}
+
 		m_isStencilTestEnabled = defaultParams.useStencilTest;
 		m_isDepthTestEnabled = defaultParams.useDepthTest;
 		m_isBlendingEnabled = (defaultParams.sourceBlend != BlendFunc::BLEND_FUNC_NONE || defaultParams.destBlend != BlendFunc::BLEND_FUNC_NONE);
@@ -243,6 +269,16 @@ namespace LinaEngine::Graphics
 
 	}
 
+	void GLRenderDevice::EndFrameStats()
+	{
+		// Store the finished frame & drop the oldest one.
+		m_statsHistory.push_back(m_frameStats);
+		if (m_statsHistory.size() > RENDERSTATS_HISTORY_SIZE)
+			m_statsHistory.pop_front();
+
+		m_frameStats = RenderStats();
+	}
+
 
 	// ---------------------------------------------------------------------
 	// ---------------------------------------------------------------------
@@ -263,6 +299,7 @@ namespace LinaEngine::Graphics
 		glBindTexture(textureTarget, textureHandle);
 
 		glTexImage2D(textureTarget, 0, internalFormat, size.x, size.y, 0, format, GL_UNSIGNED_BYTE, data);
+		AddUploadStats(data, GetTextureUploadSize(size, format, sizeof(GLubyte)));
 
 		// OpenGL texture params.
 		SetupTextureParameters(textureTarget, samplerParams, useBorder, &borderColor.r);
@@ -281,6 +318,60 @@ namespace LinaEngine::Graphics
 		return textureHandle;
 	}
 
+	uint32 GLRenderDevice::CreateTexture2DCompressed(Vector2 size, TextureCompression compression, bool sRGB, const std::vector<const void*>& levels, const std::vector<uint32>& levelSizes, SamplerParameters samplerParams)
+	{
+		GLenum internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+		switch (compression)
+		{
+		case TextureCompression::COMPRESSION_BC1: internalFormat = sRGB ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT; break;
+		case TextureCompression::COMPRESSION_BC3: internalFormat = sRGB ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; break;
+		case TextureCompression::COMPRESSION_BC4: internalFormat = GL_COMPRESSED_RED_RGTC1; break;
+		case TextureCompression::COMPRESSION_BC5: internalFormat = GL_COMPRESSED_RG_RGTC2; break;
+		default:
+		{
+			LINA_CORE_ERR("Compressed texture can not be created without a block compression format!");
+			return 0;
+		}
+		}
+
+		GLenum textureTarget = GL_TEXTURE_2D;
+		GLuint textureHandle;
+
+		// Generate texture & bind to program.
+		glGenTextures(1, &textureHandle);
+		glBindTexture(textureTarget, textureHandle);
+
+		// Mips are precomputed, upload every level as is.
+		for (uint32 i = 0; i < (uint32)levels.size(); i++)
+		{
+			GLsizei width = std::max((GLsizei)size.x >> i, 1);
+			GLsizei height = std::max((GLsizei)size.y >> i, 1);
+			glCompressedTexImage2D(textureTarget, i, internalFormat, width, height, 0, levelSizes[i], levels[i]);
+			AddUploadStats(levels[i], levelSizes[i]);
+		}
+
+		// OpenGL texture params.
+		SetupTextureParameters(textureTarget, samplerParams);
+		glTexParameteri(textureTarget, GL_TEXTURE_BASE_LEVEL, 0);
+		glTexParameteri(textureTarget, GL_TEXTURE_MAX_LEVEL, levels.empty() ? 0 : (GLint)levels.size() - 1);
+
+		// BC4 & BC5 hold grey & grey alpha sources, expand them back to grey.
+		if (compression == TextureCompression::COMPRESSION_BC4)
+		{
+			GLint swizzle[4] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+			glTexParameteriv(textureTarget, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+		}
+		else if (compression == TextureCompression::COMPRESSION_BC5)
+		{
+			GLint swizzle[4] = { GL_RED, GL_RED, GL_RED, GL_GREEN };
+			glTexParameteriv(textureTarget, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+		}
+
+		glBindTexture(textureTarget, 0);
+
+		return textureHandle;
+	}
+
 	uint32 GLRenderDevice::CreateTextureHDRI(Vector2 size, float* data, SamplerParameters samplerParams)
 	{
 		// Declare formats, target & handle for the texture.
@@ -295,6 +386,7 @@ namespace LinaEngine::Graphics
 
 
 		glTexImage2D(textureTarget, 0, internalFormat, size.x, size.y, 0, format, GL_FLOAT, data);
+		AddUploadStats(data, GetTextureUploadSize(size, format, sizeof(GLfloat)));
 
 		// OpenGL texture params.
 		SetupTextureParameters(textureTarget, samplerParams);
@@ -328,6 +420,7 @@ namespace LinaEngine::Graphics
 		for (GLuint i = 0; i < dataSize; i++)
 		{
 			glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, internalFormat, size.x, size.y, 0, format, GL_UNSIGNED_BYTE, data[i]);
+			AddUploadStats(data[i], GetTextureUploadSize(size, format, sizeof(GLubyte)));
 		}
 
 		// Specify wrapping & filtering
@@ -421,6 +514,7 @@ namespace LinaEngine::Graphics
 
 		GLubyte texData[] = { 255, 255, 255, 255 };
 		glTexImage2D(textureTarget, 0, internalFormat, size.x, size.y, 0, format, GL_UNSIGNED_BYTE, texData);
+		AddUploadStats(texData, GetTextureUploadSize(size, format, sizeof(GLubyte)));
 
 		// Setup parameters.
 		SetupTextureParameters(textureTarget, samplerParams);
@@ -438,6 +532,44 @@ namespace LinaEngine::Graphics
 		return textureHandle;
 	}
 
+	void GLRenderDevice::UpdateTexture2DRegion(uint32 texture, Vector2 offset, Vector2 size, const void* data, PixelFormat pixelFormat)
+	{
+		GLint format = GetOpenGLFormat(pixelFormat);
+
+		// Rows of the source are tightly packed.
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, (GLint)offset.x, (GLint)offset.y, (GLsizei)size.x, (GLsizei)size.y, format, GL_UNSIGNED_BYTE, data);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		AddUploadStats(data, GetTextureUploadSize(size, format, sizeof(GLubyte)));
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	void GLRenderDevice::GetTextureLevelHalf(uint32 texture, TextureBindMode bindMode, uint32 face, uint32 mipLevel, PixelFormat pixelFormat, void* data)
+	{
+		GLenum target = bindMode == TextureBindMode::BINDTEXTURE_CUBEMAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : bindMode;
+
+		// Small mips of 3 channel halfs are not 4 byte aligned.
+		glBindTexture(bindMode, texture);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glGetTexImage(target, mipLevel, GetOpenGLFormat(pixelFormat), GL_HALF_FLOAT, data);
+		glPixelStorei(GL_PACK_ALIGNMENT, 4);
+		glBindTexture(bindMode, 0);
+	}
+
+	void GLRenderDevice::UpdateTextureLevelHalf(uint32 texture, TextureBindMode bindMode, uint32 face, uint32 mipLevel, Vector2 size, const void* data, PixelFormat pixelFormat)
+	{
+		GLenum target = bindMode == TextureBindMode::BINDTEXTURE_CUBEMAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : bindMode;
+		GLint format = GetOpenGLFormat(pixelFormat);
+
+		glBindTexture(bindMode, texture);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexSubImage2D(target, mipLevel, 0, 0, (GLsizei)size.x, (GLsizei)size.y, format, GL_HALF_FLOAT, data);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		AddUploadStats(data, GetTextureUploadSize(size, format, sizeof(GLhalf)));
+		glBindTexture(bindMode, 0);
+	}
+
 	void GLRenderDevice::SetupTextureParameters(uint32 textureTarget, SamplerParameters samplerParams, bool useBorder, float* borderColor)
 	{
 		// OpenGL texture params.
@@ -489,7 +621,7 @@ namespace LinaEngine::Graphics
 	// ---------------------------------------------------------------------
 	// ---------------------------------------------------------------------
 
-	uint32 GLRenderDevice::CreateVertexArray(const float** vertexData, const uint32* vertexElementSizes, const uint32* vertexElementTypes, uint32 numVertexComponents, uint32 numInstanceComponents, uint32 numVertices, const uint32* indices, uint32 numIndices, BufferUsage bufferUsage)
+	uint32 GLRenderDevice::CreateVertexArray(const float** vertexData, const uint32* vertexElementSizes, const uint32* vertexElementTypes, uint32 numVertexComponents, uint32 numInstanceComponents, uint32 numVertices, const void* indices, uint32 numIndices, bool shortIndices, BufferUsage bufferUsage)
 	{
 		// Define vertex array object, buffers, buffer count & their sizes.
 		unsigned int numBuffers = numVertexComponents + numInstanceComponents + 1;
@@ -523,6 +655,7 @@ namespace LinaEngine::Graphics
 			// Bind the current array buffer & set the data.
 			glBindBuffer(GL_ARRAY_BUFFER, buffers[i]);
 			glBufferData(GL_ARRAY_BUFFER, dataSize, bufferData, attribUsage);
+			AddUploadStats(bufferData, dataSize);
 			bufferSizes[i] = dataSize;
 
 			// Define element sizes to pass the required part of the array to the attrib pointer call.
@@ -563,9 +696,10 @@ namespace LinaEngine::Graphics
 		}
 
 		// Finally bind the element array buffer.
-		uintptr indicesSize = numIndices * sizeof(uint32);
+		uintptr indicesSize = numIndices * (shortIndices ? sizeof(uint16) : sizeof(uint32));
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[numBuffers - 1]);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indicesSize, indices, bufferUsage);
+		AddUploadStats(indices, indicesSize);
 		bufferSizes[numBuffers - 1] = indicesSize;
 
 		// Create vertex array based on our calculated data.
@@ -574,6 +708,7 @@ namespace LinaEngine::Graphics
 		vaoData.bufferSizes = bufferSizes;
 		vaoData.numBuffers = numBuffers;
 		vaoData.numElements = numIndices;
+		vaoData.shortIndices = shortIndices;
 		vaoData.bufferUsage = bufferUsage;
 		vaoData.instanceComponentsStartIndex = numVertexComponents;
 
@@ -583,6 +718,78 @@ namespace LinaEngine::Graphics
 	}
 
 
+	uint32 GLRenderDevice::CreateInterleavedVertexArray(const void* vertexData, uint32 vertexStride, const VertexAttribute* attributes, uint32 numAttributes, uint32 numVertices, const uint32* instanceElementSizes, uint32 numInstanceComponents, uint32 instanceLocation, const void* indices, uint32 numIndices, bool shortIndices, BufferUsage bufferUsage)
+	{
+		// Single vertex buffer, a buffer per instanced element & the element buffer.
+		unsigned int numBuffers = numInstanceComponents + 2;
+		GLuint VAO;
+		GLuint* buffers = new GLuint[numBuffers];
+		uintptr* bufferSizes = new uintptr[numBuffers];
+
+		glGenVertexArrays(1, &VAO);
+		SetVAO(VAO);
+		glGenBuffers(numBuffers, buffers);
+
+		// Upload the vertices.
+		uintptr vertexDataSize = (uintptr)vertexStride * numVertices;
+		glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+		glBufferData(GL_ARRAY_BUFFER, vertexDataSize, vertexData, bufferUsage);
+		AddUploadStats(vertexData, vertexDataSize);
+		bufferSizes[0] = vertexDataSize;
+
+		// Attribute pointer for each attribute inside the vertex.
+		for (uint32 i = 0; i < numAttributes; i++)
+		{
+			const VertexAttribute& attribute = attributes[i];
+			const GLvoid* offset = (const GLvoid*)(uintptr)attribute.m_offset;
+			glEnableVertexAttribArray(attribute.m_location);
+
+			if (attribute.m_type == VertexAttributeType::ATTRIB_HALF_FLOAT)
+				glVertexAttribPointer(attribute.m_location, attribute.m_components, GL_HALF_FLOAT, GL_FALSE, vertexStride, offset);
+			else if (attribute.m_type == VertexAttributeType::ATTRIB_SHORT_NORMALIZED)
+				glVertexAttribPointer(attribute.m_location, attribute.m_components, GL_SHORT, GL_TRUE, vertexStride, offset);
+			else
+				glVertexAttribPointer(attribute.m_location, attribute.m_components, GL_FLOAT, GL_FALSE, vertexStride, offset);
+		}
+
+		// Instanced elements, filled per draw.
+		for (uint32 i = 0, attribute = instanceLocation; i < numInstanceComponents; i++)
+		{
+			uint32 elementSize = instanceElementSizes[i];
+			uintptr dataSize = elementSize * sizeof(float);
+			glBindBuffer(GL_ARRAY_BUFFER, buffers[i + 1]);
+			glBufferData(GL_ARRAY_BUFFER, dataSize, nullptr, BufferUsage::USAGE_DYNAMIC_DRAW);
+			bufferSizes[i + 1] = dataSize;
+
+			for (uint32 j = 0; j < elementSize; j += 4)
+			{
+				glEnableVertexAttribArray(attribute);
+				glVertexAttribPointer(attribute, elementSize - j < 4 ? elementSize - j : 4, GL_FLOAT, GL_FALSE, elementSize * sizeof(GLfloat), (const GLvoid*)(sizeof(GLfloat) * j));
+				glVertexAttribDivisor(attribute, 1);
+				attribute++;
+			}
+		}
+
+		// Finally bind the element array buffer.
+		uintptr indicesSize = numIndices * (shortIndices ? sizeof(uint16) : sizeof(uint32));
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[numBuffers - 1]);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indicesSize, indices, bufferUsage);
+		AddUploadStats(indices, indicesSize);
+		bufferSizes[numBuffers - 1] = indicesSize;
+
+		struct VertexArrayData vaoData;
+		vaoData.buffers = buffers;
+		vaoData.bufferSizes = bufferSizes;
+		vaoData.numBuffers = numBuffers;
+		vaoData.numElements = numIndices;
+		vaoData.shortIndices = shortIndices;
+		vaoData.bufferUsage = bufferUsage;
+		vaoData.instanceComponentsStartIndex = 1;
+
+		m_vaoMap[VAO] = vaoData;
+		return VAO;
+	}
+
 	uint32 GLRenderDevice::ReleaseVertexArray(uint32 vao, bool checkMap)
 	{
 		if (!checkMap)
@@ -717,7 +924,9 @@ namespace LinaEngine::Graphics
 		glGenBuffers(1, &ubo);
 		glBindBuffer(GL_UNIFORM_BUFFER, ubo);
 		glBufferData(GL_UNIFORM_BUFFER, dataSize, data, usage);
+		AddUploadStats(data, dataSize);
 		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		m_boundUBO = 0;
 		return ubo;
 	}
 
@@ -729,6 +938,108 @@ namespace LinaEngine::Graphics
 		return 0;
 	}
 
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+	// TEXTURE BUFFER OPERATIONS
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+
+	uint32 GLRenderDevice::CreateTextureBuffer(PixelFormat internalFormat, const void* data, uintptr dataSize, BufferUsage usage)
+	{
+		// Create the storage.
+		uint32 tbo;
+		glGenBuffers(1, &tbo);
+		glBindBuffer(GL_TEXTURE_BUFFER, tbo);
+		glBufferData(GL_TEXTURE_BUFFER, dataSize, data, usage);
+		AddUploadStats(data, dataSize);
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+		// Create the texture that views the storage.
+		uint32 texture;
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_BUFFER, texture);
+		glTexBuffer(GL_TEXTURE_BUFFER, GetOpenGLInternalFormat(internalFormat, false), tbo);
+		glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+		TextureBufferData& bufferData = m_textureBufferMap[texture];
+		bufferData.buffer = tbo;
+		bufferData.bufferUsage = usage;
+		return texture;
+	}
+
+	void GLRenderDevice::UpdateTextureBuffer(uint32 texture, const void* data, uintptr dataSize)
+	{
+		std::map<uint32, TextureBufferData>::iterator it = m_textureBufferMap.find(texture);
+
+		if (it == m_textureBufferMap.end())
+		{
+			LINA_CORE_ERR("Texture buffer {0} is not created, returning...", texture);
+			return;
+		}
+
+		// Re-specify the whole storage, this orphans the previous one so draws still reading it do not stall the upload.
+		glBindBuffer(GL_TEXTURE_BUFFER, it->second.buffer);
+		glBufferData(GL_TEXTURE_BUFFER, dataSize, data, it->second.bufferUsage);
+		AddUploadStats(data, dataSize);
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+	}
+
+	uint32 GLRenderDevice::ReleaseTextureBuffer(uint32 texture)
+	{
+		// Delete the texture & its storage if exists.
+		std::map<uint32, TextureBufferData>::iterator it = m_textureBufferMap.find(texture);
+		if (it == m_textureBufferMap.end()) return 0;
+
+		glDeleteTextures(1, &texture);
+		glDeleteBuffers(1, &it->second.buffer);
+		m_textureBufferMap.erase(it);
+		return 0;
+	}
+
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+	// QUERY OPERATIONS
+	// ---------------------------------------------------------------------
+	// ---------------------------------------------------------------------
+
+	uint32 GLRenderDevice::CreateQuery()
+	{
+		uint32 query;
+		glGenQueries(1, &query);
+		return query;
+	}
+
+	void GLRenderDevice::BeginTimeQuery(uint32 query)
+	{
+		glBeginQuery(GL_TIME_ELAPSED, query);
+	}
+
+	void GLRenderDevice::EndTimeQuery()
+	{
+		glEndQuery(GL_TIME_ELAPSED);
+	}
+
+	bool GLRenderDevice::IsQueryResultAvailable(uint32 query)
+	{
+		GLint available = 0;
+		glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+		return available != 0;
+	}
+
+	uint64 GLRenderDevice::GetQueryResult(uint32 query)
+	{
+		GLuint64 result = 0;
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &result);
+		return (uint64)result;
+	}
+
+	uint32 GLRenderDevice::ReleaseQuery(uint32 query)
+	{
+		if (query == 0) return 0;
+		glDeleteQueries(1, &query);
+		return 0;
+	}
+
 	// ---------------------------------------------------------------------
 	// ---------------------------------------------------------------------
 	// SHADER PROGRAM OPERATIONS
@@ -751,8 +1062,36 @@ namespace LinaEngine::Graphics
 		std::string vertexShaderText = "#version " + version + "\n#define VS_BUILD\n#define GLSL_VERSION " + version + "\n" + shaderText;
 		std::string fragmentShaderText = "#version " + version + "\n#define FS_BUILD\n#define GLSL_VERSION " + version + "\n" + shaderText;
 
-		// Add the shader program, terminate if fails.
+		// Key the cached binary w/ the final sources & the driver, any change builds a new binary.
 		ShaderProgram programData;
+		std::string cachePath = "";
+		if (m_programBinarySupported && !m_programCachePath.empty())
+		{
+			uint64 hash = 14695981039346656037ull;
+			std::string key = m_driverIdentity + (usesGeometryShader ? "|GS|" : "|") + vertexShaderText;
+			for (char c : key)
+			{
+				hash ^= (uint8)c;
+				hash *= 1099511628211ull;
+			}
+
+			char fileName[32];
+			snprintf(fileName, sizeof(fileName), "%016llx.bin", (unsigned long long)hash);
+			cachePath = m_programCachePath + fileName;
+
+			if (LoadProgramBinary(shaderProgram, cachePath))
+			{
+				AddAllAttributes(shaderProgram, vertexShaderText, GetVersion());
+				AddShaderUniforms(shaderProgram, programData);
+				m_shaderProgramMap[shaderProgram] = programData;
+				return shaderProgram;
+			}
+
+			// Binaries may be retrieved only if requested before linking.
+			glProgramParameteri(shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
+
+		// Add the shader program, terminate if fails.
 		if (!AddShader(shaderProgram, vertexShaderText, GL_VERTEX_SHADER, &programData.shaders))
 			return (uint32)-1;
 
@@ -772,15 +1111,34 @@ namespace LinaEngine::Graphics
 		if (CheckShaderError(shaderProgram, GL_LINK_STATUS, true, "Error linking shader program"))
 			return (uint32)-1;
 
+		if (!cachePath.empty())
+			SaveProgramBinary(shaderProgram, cachePath);
+
 		// Bind attributes for GL & add shader uniforms.
 		AddAllAttributes(shaderProgram, vertexShaderText, GetVersion());
-		AddShaderUniforms(shaderProgram, shaderText, programData.uniformBlockMap, programData.uniformMap, programData.samplerMap);
+		AddShaderUniforms(shaderProgram, programData);
 
 		// Store the program in our map & return it.
 		m_shaderProgramMap[shaderProgram] = programData;
 		return shaderProgram;
 	}
 
+	void GLRenderDevice::SetProgramBinaryCache(const std::string& directory)
+	{
+		m_programCachePath = "";
+		if (directory.empty() || !m_programBinarySupported) return;
+
+		std::error_code error;
+		std::filesystem::create_directories(directory, error);
+		if (error)
+		{
+			LINA_CORE_WARN("Could not create the program binary cache at {0}, shaders will be compiled from source.", directory);
+			return;
+		}
+
+		m_programCachePath = directory.back() == '/' ? directory : directory + "/";
+	}
+
 	bool GLRenderDevice::ValidateShaderProgram(uint32 shader)
 	{
 		// Validate program & check validation errors.
@@ -951,12 +1309,14 @@ namespace LinaEngine::Graphics
 		{
 			m_boundReadFBO = readFBO;
 			glBindFramebuffer(GL_READ_FRAMEBUFFER, readFBO);
+			m_frameStats.m_fboSwitches++;
 		}
 
 		if (m_boundWriteFBO != writeFBO)
 		{
 			m_boundWriteFBO = writeFBO;
 			glBindFramebuffer(GL_DRAW_FRAMEBUFFER, writeFBO);
+			m_frameStats.m_fboSwitches++;
 		}
 		glBlitFramebuffer(0, 0, readWidth, readHeight, 0, 0, writeWidth, writeHeight, mask, filter);
 	}
@@ -1011,6 +1371,8 @@ namespace LinaEngine::Graphics
 			glBufferData(GL_ARRAY_BUFFER, dataSize, data, usage);
 			vaoData->bufferSizes[bufferIndex] = dataSize;
 		}
+
+		AddUploadStats(data, dataSize);
 	}
 
 	// ---------------------------------------------------------------------
@@ -1025,12 +1387,14 @@ namespace LinaEngine::Graphics
 		if (shader == m_boundShader) return;
 		glUseProgram(shader);
 		m_boundShader = shader;
+		m_frameStats.m_shaderBinds++;
 	}
 
 	void GLRenderDevice::SetTexture(uint32 texture, uint32 sampler, uint32 unit, TextureBindMode bindTextureMode, bool setSampler)
 	{
 		glActiveTexture(GL_TEXTURE0 + unit);
 		glBindTexture(bindTextureMode, texture);
+		m_frameStats.m_textureBinds++;
 
 		if (setSampler)
 			glBindSampler(unit, sampler);
@@ -1047,8 +1411,15 @@ namespace LinaEngine::Graphics
 
 	void GLRenderDevice::BindUniformBuffer(uint32 bufferObject, uint32 point)
 	{
-		// Bind the buffer object to the point.
+		// Bind the buffer object to the point, this also binds it to the generic target.
 		glBindBufferBase(GL_UNIFORM_BUFFER, point, bufferObject);
+		m_boundUBO = bufferObject;
+	}
+
+	void GLRenderDevice::BindUniformBufferRange(uint32 buffer, uint32 bindingPoint, uintptr offset, uintptr size)
+	{
+		glBindBufferRange(GL_UNIFORM_BUFFER, bindingPoint, buffer, offset, size);
+		m_boundUBO = buffer;
 	}
 
 	void GLRenderDevice::BindShaderBlockToBufferPoint(uint32 shader, uint32 blockPoint, std::string& blockName)
@@ -1093,6 +1464,8 @@ namespace LinaEngine::Graphics
 			glBufferData(GL_ARRAY_BUFFER, dataSize, data, usage);
 			vaoData->bufferSizes[bufferIndex] = dataSize;
 		}
+
+		AddUploadStats(data, dataSize);
 	}
 
 	void GLRenderDevice::UpdateUniformBuffer(uint32 buffer, const void* data, uintptr offset, uintptr dataSize)
@@ -1105,6 +1478,7 @@ namespace LinaEngine::Graphics
 		}
 
 		glBufferSubData(GL_UNIFORM_BUFFER, offset, dataSize, data);
+		AddUploadStats(data, dataSize);
 	}
 
 	void GLRenderDevice::UpdateUniformBuffer(uint32 buffer, const void* data, uintptr dataSize)
@@ -1112,6 +1486,7 @@ namespace LinaEngine::Graphics
 		void* dest = glMapBuffer(GL_UNIFORM_BUFFER, GL_WRITE_ONLY);
 		GenericMemory::memcpy(dest, data, dataSize);
 		glUnmapBuffer(GL_UNIFORM_BUFFER);
+		AddUploadStats(data, dataSize);
 	}
 
 
@@ -1141,7 +1516,7 @@ namespace LinaEngine::Graphics
 	}
 
 
-	void GLRenderDevice::Draw(uint32 vao, const DrawParams& drawParams, uint32 numInstances, uint32 numElements, bool drawArrays)
+	void GLRenderDevice::Draw(uint32 vao, const DrawParams& drawParams, uint32 numInstances, uint32 numElements, bool drawArrays, uint32 firstIndex)
 	{
 		// No need to draw nothin dude.
 		if (!drawArrays && numInstances == 0) return;
@@ -1152,18 +1527,75 @@ namespace LinaEngine::Graphics
 		// Set vao & draw
 		SetVAO(vao);
 
+		uint32 drawnInstances = 1;
 		if (drawArrays)
 			glDrawArrays(drawParams.primitiveType, 0, numElements);
 		else
 		{
+			// Meshes w/ less than 65536 vertices are uploaded w/ 16 bit indices.
+			std::map<uint32, VertexArrayData>::iterator it = m_vaoMap.find(vao);
+			bool shortIndices = it != m_vaoMap.end() && it->second.shortIndices;
+			GLenum indexType = shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+			const void* indexOffset = (const void*)(uintptr)(firstIndex * (shortIndices ? sizeof(uint16) : sizeof(uint32)));
+
 			// 1 object or instanced draw calls?
 			if (numInstances == 1)
-				glDrawElements(drawParams.primitiveType, (GLsizei)numElements, GL_UNSIGNED_INT, 0);
+				glDrawElements(drawParams.primitiveType, (GLsizei)numElements, indexType, indexOffset);
 			else
-				glDrawElementsInstanced(drawParams.primitiveType, (GLsizei)numElements, GL_UNSIGNED_INT, 0, numInstances);
+			{
+				glDrawElementsInstanced(drawParams.primitiveType, (GLsizei)numElements, indexType, indexOffset, numInstances);
+				drawnInstances = numInstances;
+				m_frameStats.m_instancedDrawCalls++;
+			}
+		}
+
+		m_frameStats.m_drawCalls++;
+		m_frameStats.m_instances += drawnInstances;
+		if (drawParams.primitiveType == PrimitiveType::PRIMITIVE_TRIANGLES)
+			m_frameStats.m_triangles += numElements / 3 * drawnInstances;
+
+	}
+
+	bool GLRenderDevice::SupportsMultiDrawIndirect()
+	{
+		return GetVersion() >= 430;
+	}
+
+	void GLRenderDevice::MultiDrawIndirect(uint32 vao, const DrawParams& drawParams, const DrawElementsIndirectCommand* commands, uint32 numCommands)
+	{
+		if (numCommands == 0) return;
+
+		SetDrawParameters(drawParams);
+		SetVAO(vao);
+
+		// Upload the commands, the buffer only grows.
+		uintptr commandsSize = numCommands * sizeof(DrawElementsIndirectCommand);
+		if (m_indirectBuffer == 0)
+			glGenBuffers(1, &m_indirectBuffer);
+
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer);
+		if (m_indirectBufferSize >= commandsSize)
+			glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commandsSize, commands);
+		else
+		{
+			glBufferData(GL_DRAW_INDIRECT_BUFFER, commandsSize, commands, GL_STREAM_DRAW);
+			m_indirectBufferSize = commandsSize;
 		}
 
+		AddUploadStats(commands, commandsSize);
+
+		std::map<uint32, VertexArrayData>::iterator it = m_vaoMap.find(vao);
+		GLenum indexType = it != m_vaoMap.end() && it->second.shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+		glMultiDrawElementsIndirect(drawParams.primitiveType, indexType, 0, (GLsizei)numCommands, 0);
 
+		m_frameStats.m_drawCalls++;
+		m_frameStats.m_indirectCommands += numCommands;
+		for (uint32 i = 0; i < numCommands; i++)
+		{
+			m_frameStats.m_instances += commands[i].m_instanceCount;
+			if (drawParams.primitiveType == PrimitiveType::PRIMITIVE_TRIANGLES)
+				m_frameStats.m_triangles += commands[i].m_count / 3 * commands[i].m_instanceCount;
+		}
 	}
 
 	void GLRenderDevice::DrawLine(float width)
@@ -1171,6 +1603,8 @@ namespace LinaEngine::Graphics
 		// This function requires you to set model matrix in the debuglines shader.
 		glLineWidth(width);
 		glDrawArrays(GL_LINES, 0, 2);
+		m_frameStats.m_drawCalls++;
+		m_frameStats.m_instances++;
 	}
 
 	void GLRenderDevice::DrawLine(uint32 shader, const Matrix& model, const Vector3& from, const Vector3& to, float width)
@@ -1192,6 +1626,7 @@ namespace LinaEngine::Graphics
 		glBindBuffer(GL_ARRAY_BUFFER, vbo);
 		glBufferData(GL_ARRAY_BUFFER,
 			sizeof(GLfloat) * 6, lines.vertices, GL_STATIC_DRAW);
+		AddUploadStats(lines.vertices, sizeof(GLfloat) * 6);
 
 		// Enable position.
 		glEnableVertexAttribArray(0);
@@ -1203,6 +1638,8 @@ namespace LinaEngine::Graphics
 		glBindVertexArray(vao);
 		glDrawArrays(GL_LINES, 0, 2);
 		glBindVertexArray(0);
+		m_frameStats.m_drawCalls++;
+		m_frameStats.m_instances++;
 
 		//delete buffers
 		glDeleteVertexArrays(1, &vao);
@@ -1239,46 +1676,112 @@ namespace LinaEngine::Graphics
 
 
 
+	int32 GLRenderDevice::GetUniformHandle(uint32 shader, const std::string& uniform)
+	{
+		std::map<uint32, ShaderProgram>::iterator programIt = m_shaderProgramMap.find(shader);
+		if (programIt == m_shaderProgramMap.end()) return -1;
+
+		std::map<std::string, int32>::iterator uniformIt = programIt->second.uniformMap.find(uniform);
+		return uniformIt == programIt->second.uniformMap.end() ? -1 : uniformIt->second;
+	}
+
+	int32 GLRenderDevice::GetMaterialBlockSize(uint32 shader)
+	{
+		std::map<uint32, ShaderProgram>::iterator programIt = m_shaderProgramMap.find(shader);
+		return programIt == m_shaderProgramMap.end() ? 0 : programIt->second.materialBlockSize;
+	}
+
+	int32 GLRenderDevice::GetMaterialBlockOffset(uint32 shader, const std::string& uniform)
+	{
+		std::map<uint32, ShaderProgram>::iterator programIt = m_shaderProgramMap.find(shader);
+		if (programIt == m_shaderProgramMap.end()) return -1;
+
+		std::map<std::string, int32>::iterator offsetIt = programIt->second.materialBlockOffsets.find(uniform);
+		return offsetIt == programIt->second.materialBlockOffsets.end() ? -1 : offsetIt->second;
+	}
+
+	void GLRenderDevice::UpdateShaderUniformFloat(int32 handle, const float f)
+	{
+		glUniform1f(handle, (GLfloat)f);
+		m_frameStats.m_uniformCalls++;
+	}
+
+	void GLRenderDevice::UpdateShaderUniformInt(int32 handle, const int f)
+	{
+		glUniform1i(handle, (GLint)f);
+		m_frameStats.m_uniformCalls++;
+	}
+
+	void GLRenderDevice::UpdateShaderUniformColor(int32 handle, const Color& color)
+	{
+		glUniform3f(handle, (GLfloat)color.r, (GLfloat)color.g, (GLfloat)color.b);
+		m_frameStats.m_uniformCalls++;
+	}
+
+	void GLRenderDevice::UpdateShaderUniformVector2(int32 handle, const Vector2& m)
+	{
+		glUniform2f(handle, (GLfloat)m.x, (GLfloat)m.y);
+		m_frameStats.m_uniformCalls++;
+	}
+
+	void GLRenderDevice::UpdateShaderUniformVector3(int32 handle, const Vector3& m)
+	{
+		glUniform3f(handle, (GLfloat)m.x, (GLfloat)m.y, (GLfloat)m.z);
+		m_frameStats.m_uniformCalls++;
+	}
+
+	void GLRenderDevice::UpdateShaderUniformVector4F(int32 handle, const Vector4& m)
+	{
+		glUniform4f(handle, (GLfloat)m.x, (GLfloat)m.y, (GLfloat)m.z, (GLfloat)m.w);
+		m_frameStats.m_uniformCalls++;
+	}
+
+	void GLRenderDevice::UpdateShaderUniformMatrix(int32 handle, const Matrix& m)
+	{
+		glUniformMatrix4fv(handle, 1, GL_FALSE, &m[0][0]);
+		m_frameStats.m_uniformCalls++;
+	}
+
 	void GLRenderDevice::UpdateShaderUniformFloat(uint32 shader, const std::string& uniform, const float f)
 	{
-		glUniform1f(m_shaderProgramMap[shader].uniformMap[uniform], (GLfloat)f);
+		UpdateShaderUniformFloat(GetUniformHandle(shader, uniform), f);
 	}
 
 	void GLRenderDevice::UpdateShaderUniformInt(uint32 shader, const std::string& uniform, const int f)
 	{
-		glUniform1i(m_shaderProgramMap[shader].uniformMap[uniform], (GLint)f);
+		UpdateShaderUniformInt(GetUniformHandle(shader, uniform), f);
 	}
 
 	void GLRenderDevice::UpdateShaderUniformColor(uint32 shader, const std::string& uniform, const Color& color)
 	{
-		glUniform3f(m_shaderProgramMap[shader].uniformMap[uniform], (GLfloat)color.r, (GLfloat)color.g, (GLfloat)color.b);
+		UpdateShaderUniformColor(GetUniformHandle(shader, uniform), color);
 	}
 
 	void GLRenderDevice::UpdateShaderUniformVector2(uint32 shader, const std::string& uniform, const Vector2& m)
 	{
-		glUniform2f(m_shaderProgramMap[shader].uniformMap[uniform], (GLfloat)m.x, (GLfloat)m.y);
+		UpdateShaderUniformVector2(GetUniformHandle(shader, uniform), m);
 	}
 
 	void GLRenderDevice::UpdateShaderUniformVector3(uint32 shader, const std::string& uniform, const Vector3& m)
 	{
-		glUniform3f(m_shaderProgramMap[shader].uniformMap[uniform], (GLfloat)m.x, (GLfloat)m.y, (GLfloat)m.z);
+		UpdateShaderUniformVector3(GetUniformHandle(shader, uniform), m);
 	}
 
 	void GLRenderDevice::UpdateShaderUniformVector4F(uint32 shader, const std::string& uniform, const Vector4& m)
 	{
-		glUniform4f(m_shaderProgramMap[shader].uniformMap[uniform], (GLfloat)m.x, (GLfloat)m.y, (GLfloat)m.z, (GLfloat)m.w);
-
+		UpdateShaderUniformVector4F(GetUniformHandle(shader, uniform), m);
 	}
 
 	void GLRenderDevice::UpdateShaderUniformMatrix(uint32 shader, const std::string& uniform, void* data)
 	{
 		float* matrixData = ((float*)data);
-		glUniformMatrix4fv(m_shaderProgramMap[shader].uniformMap[uniform], 1, GL_FALSE, matrixData);
+		glUniformMatrix4fv(GetUniformHandle(shader, uniform), 1, GL_FALSE, matrixData);
+		m_frameStats.m_uniformCalls++;
 	}
 
 	void GLRenderDevice::UpdateShaderUniformMatrix(uint32 shader, const std::string& uniform, const Matrix& m)
 	{
-		glUniformMatrix4fv(m_shaderProgramMap[shader].uniformMap[uniform], 1, GL_FALSE, &m[0][0]);
+		UpdateShaderUniformMatrix(GetUniformHandle(shader, uniform), m);
 	}
 
 
@@ -1310,6 +1813,7 @@ namespace LinaEngine::Graphics
 		if (fbo == m_boundFBO) return;
 		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
 		m_boundFBO = m_boundReadFBO = m_boundWriteFBO = fbo;
+		m_frameStats.m_fboSwitches++;
 	}
 
 
@@ -1533,6 +2037,9 @@ namespace LinaEngine::Graphics
 		case PixelFormat::FORMAT_SRGBA: return GL_RGBA;
 		case PixelFormat::FORMAT_RGBA16F: return GL_RGBA;
 		case PixelFormat::FORMAT_RGB16F: return GL_RGBA;
+		case PixelFormat::FORMAT_R32UI: return GL_RED_INTEGER;
+		case PixelFormat::FORMAT_RG32UI: return GL_RG_INTEGER;
+		case PixelFormat::FORMAT_RGBA32F: return GL_RGBA;
 		default:
 			LINA_CORE_ERR("PixelFormat {0} is not a valid PixelFormat.", format);
 			return 0;
@@ -1560,6 +2067,9 @@ namespace LinaEngine::Graphics
 		case PixelFormat::FORMAT_SRGBA: return GL_SRGB_ALPHA;
 		case PixelFormat::FORMAT_RGBA16F: return GL_RGBA16F;
 		case PixelFormat::FORMAT_RGB16F: return GL_RGB16F;
+		case PixelFormat::FORMAT_R32UI: return GL_R32UI;
+		case PixelFormat::FORMAT_RG32UI: return GL_RG32UI;
+		case PixelFormat::FORMAT_RGBA32F: return GL_RGBA32F;
 		default:
 			LINA_CORE_ERR("PixelFormat {0} is not a valid PixelFormat.", format);
 			return 0;
@@ -1567,6 +2077,58 @@ namespace LinaEngine::Graphics
 	}
 
 
+	static uint64 GetTextureUploadSize(const Vector2& size, GLint format, uint64 bytesPerChannel)
+	{
+		// Get channel count of the client side pixel data.
+		uint64 channels = 4;
+		switch (format)
+		{
+		case GL_RED:
+		case GL_RED_INTEGER:
+		case GL_DEPTH_COMPONENT:
+		case GL_DEPTH_COMPONENT16: channels = 1; break;
+		case GL_RG:
+		case GL_RG_INTEGER: channels = 2; break;
+		case GL_RGB: channels = 3; break;
+		default: break;
+		}
+
+		return (uint64)size.x * (uint64)size.y * channels * bytesPerChannel;
+	}
+
+	static bool LoadProgramBinary(GLuint program, const std::string& path)
+	{
+		std::ifstream stream(path, std::ios::binary);
+		if (!stream) return false;
+
+		// Format followed by the binary itself.
+		GLenum format = 0;
+		stream.read((char*)&format, sizeof(GLenum));
+		std::vector<char> binary((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+		if (binary.empty()) return false;
+
+		// Drivers reject binaries of other versions, the program is then compiled from source.
+		glProgramBinary(program, format, &binary[0], (GLsizei)binary.size());
+		GLint success = 0;
+		glGetProgramiv(program, GL_LINK_STATUS, &success);
+		return success == GL_TRUE;
+	}
+
+	static void SaveProgramBinary(GLuint program, const std::string& path)
+	{
+		GLint length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0) return;
+
+		std::vector<char> binary(length);
+		GLenum format = 0;
+		glGetProgramBinary(program, length, nullptr, &format, &binary[0]);
+
+		std::ofstream stream(path, std::ios::binary);
+		stream.write((const char*)&format, sizeof(GLenum));
+		stream.write(&binary[0], binary.size());
+	}
+
 	static bool AddShader(GLuint shaderProgram, const std::string& text, GLenum type, std::vector<GLuint>* shaders)
 	{
 		// Create shader object.
@@ -1662,8 +2224,12 @@ namespace LinaEngine::Graphics
 		}
 	}
 
-	static void AddShaderUniforms(GLuint shaderProgram, const std::string& shaderText, std::map<std::string, GLint>& uniformBlockMap, std::map<std::string, GLint>& uniformMap, std::map<std::string, GLint>& samplerMap)
+	static void AddShaderUniforms(GLuint shaderProgram, ShaderProgram& programData)
 	{
+		std::map<std::string, GLint>& uniformBlockMap = programData.uniformBlockMap;
+		std::map<std::string, GLint>& uniformMap = programData.uniformMap;
+		GLint materialBlockIndex = -1;
+
 		// Load uniform sets.
 		GLint numBlocks;
 		glGetProgramiv(shaderProgram, GL_ACTIVE_UNIFORM_BLOCKS, &numBlocks);
@@ -1679,47 +2245,68 @@ namespace LinaEngine::Graphics
 			glGetActiveUniformBlockName(shaderProgram, block, nameLen, NULL, &name[0]);
 			std::string uniformBlockName((char*)&name[0], nameLen - 1);
 			uniformBlockMap[uniformBlockName] = glGetUniformBlockIndex(shaderProgram, &name[0]);
+
+			// Material parameters live in their own block, sized by the driver's std140 layout.
+			if (uniformBlockName.compare(MAT_BLOCKNAME) == 0)
+			{
+				materialBlockIndex = block;
+				glGetActiveUniformBlockiv(shaderProgram, block, GL_UNIFORM_BLOCK_DATA_SIZE, &programData.materialBlockSize);
+			}
 		}
 
 		// Load uniforms.
 		GLint numUniforms = 0;
+		GLint maxNameLength = 0;
 		glGetProgramiv(shaderProgram, GL_ACTIVE_UNIFORMS, &numUniforms);
+		glGetProgramiv(shaderProgram, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
 
 		// Iterate through uniforms.
-		std::vector<GLchar> uniformName(256);
+		std::vector<GLchar> uniformName(maxNameLength > 0 ? maxNameLength : 1);
 		for (int32 uniform = 0; uniform < numUniforms; ++uniform)
 		{
 			GLint arraySize = 0;
 			GLenum type = 0;
 			GLsizei actualLength = 0;
+			glGetActiveUniform(shaderProgram, uniform, (GLsizei)uniformName.size(), &actualLength, &arraySize, &type, &uniformName[0]);
 
-			// Get sampler uniform data & store it on our sampler map.
-			glGetActiveUniform(shaderProgram, uniform, uniformName.size(), &actualLength, &arraySize, &type, &uniformName[0]);
-
-			/*if (type != GL_SAMPLER_2D)
+			// Uniform block members have no location, they are updated through their buffers.
+			std::string name((char*)&uniformName[0], actualLength);
+			GLint loc = glGetUniformLocation(shaderProgram, name.c_str());
+			if (loc == -1)
 			{
-				LINA_CORE_ERR("Non-sampler2d uniforms currently unsupported!");
-				continue;
-			}*/
-
+				GLuint index = (GLuint)uniform;
+				GLint blockIndex = -1;
+				glGetActiveUniformsiv(shaderProgram, 1, &index, GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+
+				// Material block members are reported as "MaterialData.member", store them as "material.member".
+				if (blockIndex != -1 && blockIndex == materialBlockIndex)
+				{
+					GLint offset = -1;
+					glGetActiveUniformsiv(shaderProgram, 1, &index, GL_UNIFORM_OFFSET, &offset);
+					std::string memberName = name.substr(name.find('.') + 1);
+					programData.materialBlockOffsets[MAT_BLOCKPREFIX + memberName] = offset;
+				}
 
-			std::string name((char*)&uniformName[0], actualLength - 1);
-			samplerMap[name] = glGetUniformLocation(shaderProgram, (char*)&uniformName[0]);
-			GLint loc = glGetUniformLocation(shaderProgram, (char*)&uniformName[0]);
-			uniformMap[&uniformName[0]] = loc;
+				continue;
+			}
 
-			for (int i = 1; i < arraySize; i++)
+			// Arrays are reported as "name[0]", register the bare name & every element.
+			const bool isArray = name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0;
+			if (!isArray)
 			{
-				std::string name((char*)&uniformName[0], actualLength - 2);
-				name = name + std::to_string(i) + "]";
-
-				std::string newName(name.c_str(), actualLength - 1);
-				samplerMap[newName] = glGetUniformLocation(shaderProgram, name.c_str());
-				GLint loc = glGetUniformLocation(shaderProgram, name.c_str());
 				uniformMap[name] = loc;
+				continue;
 			}
 
+			std::string baseName = name.substr(0, name.size() - 3);
+			uniformMap[baseName] = loc;
+			uniformMap[name] = loc;
 
+			for (GLint i = 1; i < arraySize; i++)
+			{
+				std::string elementName = baseName + "[" + std::to_string(i) + "]";
+				uniformMap[elementName] = glGetUniformLocation(shaderProgram, elementName.c_str());
+			}
 		}
 	}
 }
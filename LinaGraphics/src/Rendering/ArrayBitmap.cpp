@@ -117,6 +117,11 @@ namespace LinaEngine::Graphics
 		return stbi_loadf(fileName, &w, &h, &nrChannels, 0);
 	}
 
+	void ArrayBitmap::FreeImmediate(void* data)
+	{
+		stbi_image_free(data);
+	}
+
 	void ArrayBitmap::Clear(int32 color)
 	{
 		Memory::memset(m_pixels, color, GetPixelsSize());
@@ -0,0 +1,222 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/DrawList.hpp"
+#include "Rendering/VertexArray.hpp"
+#include "Rendering/RenderEngine.hpp"
+#include "Rendering/Material.hpp"
+#include "Rendering/OcclusionCuller.hpp"
+#include <algorithm>
+
+namespace LinaEngine::Graphics
+{
+	static bool IsSphereVisible(const Vector4* planes, const Vector3& center, float radius)
+	{
+		for (int i = 0; i < 6; i++)
+		{
+			if (planes[i].x * center.x + planes[i].y * center.y + planes[i].z * center.z + planes[i].w < -radius)
+				return false;
+		}
+
+		return true;
+	}
+
+	void DrawList::CalculatePacketBounds(RenderPacket& packet)
+	{
+		const Vector3& localCenter = packet.m_vertexArray->GetBoundsCenter();
+		const Matrix& model = packet.m_model;
+		Vector4 worldCenter = model * Vector4(localCenter.x, localCenter.y, localCenter.z, 1.0f);
+		packet.m_boundsCenter = Vector3(worldCenter.x, worldCenter.y, worldCenter.z);
+
+		// Scale the radius w/ the largest axis scale.
+		float maxScaleSqr = Math::Max3(
+			model[0][0] * model[0][0] + model[0][1] * model[0][1] + model[0][2] * model[0][2],
+			model[1][0] * model[1][0] + model[1][1] * model[1][1] + model[1][2] * model[1][2],
+			model[2][0] * model[2][0] + model[2][1] * model[2][1] + model[2][2] * model[2][2]);
+		packet.m_boundsRadius = packet.m_vertexArray->GetBoundsRadius() * Math::Sqrt(maxScaleSqr);
+	}
+
+	void DrawList::Begin(const RenderView& view)
+	{
+		m_view = view;
+		m_opaquePackets.clear();
+		m_transparentPackets.clear();
+
+		// Extract the frustum planes from the view projection matrix, left, right, bottom, top, near & far.
+		Matrix viewProjection = view.m_projection * view.m_view;
+		for (int i = 0; i < 3; i++)
+		{
+			for (int side = 0; side < 2; side++)
+			{
+				float sign = side == 0 ? 1.0f : -1.0f;
+				Vector4 plane = Vector4(
+					viewProjection[0][3] + sign * viewProjection[0][i],
+					viewProjection[1][3] + sign * viewProjection[1][i],
+					viewProjection[2][3] + sign * viewProjection[2][i],
+					viewProjection[3][3] + sign * viewProjection[3][i]);
+
+				float length = Math::Sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+				m_frustumPlanes[i * 2 + side] = length > 0.0f ? Vector4(plane.x / length, plane.y / length, plane.z / length, plane.w / length) : plane;
+			}
+		}
+	}
+
+	void DrawList::Add(const std::vector<RenderPacket>& packets, PacketFilter filter, OcclusionCuller* occlusionCuller)
+	{
+		for (std::vector<RenderPacket>::const_iterator it = packets.begin(); it != packets.end(); ++it)
+		{
+			const RenderPacket& packet = *it;
+
+			if ((filter == PacketFilter::Static && !packet.m_isStatic) || (filter == PacketFilter::Dynamic && packet.m_isStatic))
+				continue;
+
+			// Packets w/o bounds are never culled.
+			if (packet.m_boundsRadius > 0.0f && !IsSphereVisible(m_frustumPlanes, packet.m_boundsCenter, packet.m_boundsRadius))
+				continue;
+
+			if (occlusionCuller != nullptr && packet.m_boundsRadius > 0.0f && occlusionCuller->IsOccluded(packet.m_boundsCenter, packet.m_boundsRadius))
+				continue;
+
+			if (packet.m_isTransparent)
+				m_transparentPackets.push_back(std::make_pair((m_view.m_location - packet.m_boundsCenter).MagnitudeSqrt(), &packet));
+			else
+				m_opaquePackets.push_back(&packet);
+		}
+	}
+
+	void DrawList::End()
+	{
+		std::sort(m_opaquePackets.begin(), m_opaquePackets.end(), [](const RenderPacket* lhs, const RenderPacket* rhs)
+		{
+			return std::tie(lhs->m_material, lhs->m_vertexArray, lhs->m_firstIndex) < std::tie(rhs->m_material, rhs->m_vertexArray, rhs->m_firstIndex);
+		});
+
+		std::sort(m_transparentPackets.begin(), m_transparentPackets.end(), [](const std::pair<float, const RenderPacket*>& lhs, const std::pair<float, const RenderPacket*>& rhs)
+		{
+			return lhs.first > rhs.first;
+		});
+	}
+
+	void DrawList::Flush(RenderEngine& renderEngine, RenderDevice& renderDevice, DrawParams& drawParams, Material* overrideMaterial)
+	{
+		const bool multiDraw = renderDevice.SupportsMultiDrawIndirect();
+
+		// Opaque packets sharing material & vertex array are consecutive after sorting, ordered by their index ranges.
+		// Each range is a command w/ its instances, base instance offsets the instance attributes into the shared upload.
+		// Multiple ranges only come from the static batch cells, every imported mesh owns its vertex array & its
+		// packets end up as a single instanced command.
+		for (size_t i = 0; i < m_opaquePackets.size();)
+		{
+			const RenderPacket* first = m_opaquePackets[i];
+			VertexArray* vertexArray = first->m_vertexArray;
+			m_models.clear();
+			m_commands.clear();
+
+			size_t j = i;
+			for (; j < m_opaquePackets.size() && m_opaquePackets[j]->m_material == first->m_material && m_opaquePackets[j]->m_vertexArray == vertexArray; j++)
+			{
+				const RenderPacket* packet = m_opaquePackets[j];
+				uint32 indexCount = packet->m_indexCount == 0 ? vertexArray->GetIndexCount() : packet->m_indexCount;
+				if (m_commands.size() == 0 || m_commands.back().m_firstIndex != packet->m_firstIndex || m_commands.back().m_count != indexCount)
+				{
+					DrawElementsIndirectCommand command;
+					command.m_count = indexCount;
+					command.m_firstIndex = packet->m_firstIndex;
+					command.m_baseInstance = (uint32)m_models.size();
+					m_commands.push_back(command);
+				}
+
+				m_commands.back().m_instanceCount++;
+				m_models.push_back(packet->m_model);
+			}
+
+			Material* material = overrideMaterial == nullptr ? first->m_material : overrideMaterial;
+			if (m_commands.size() == 1)
+				DrawInstances(renderEngine, renderDevice, drawParams, material, first);
+			else if (multiDraw)
+			{
+				UploadInstances(vertexArray, first->m_modelBufferIndex, 0, m_models.size());
+				renderEngine.UpdateShaderData(material);
+				renderDevice.MultiDrawIndirect(vertexArray->GetID(), drawParams, &m_commands[0], (uint32)m_commands.size());
+			}
+			else
+			{
+				// GL 3.3 has no base instance, each range uploads its own instances.
+				renderEngine.UpdateShaderData(material);
+				for (const DrawElementsIndirectCommand& command : m_commands)
+				{
+					UploadInstances(vertexArray, first->m_modelBufferIndex, command.m_baseInstance, command.m_instanceCount);
+					renderDevice.Draw(vertexArray->GetID(), drawParams, command.m_instanceCount, command.m_count, false, command.m_firstIndex);
+				}
+			}
+
+			i = j;
+		}
+
+		// Transparent packets are drawn one by one to keep the back to front order.
+		for (std::vector<std::pair<float, const RenderPacket*>>::iterator it = m_transparentPackets.begin(); it != m_transparentPackets.end(); ++it)
+		{
+			const RenderPacket* packet = it->second;
+			m_models.clear();
+			m_models.push_back(packet->m_model);
+			DrawInstances(renderEngine, renderDevice, drawParams, overrideMaterial == nullptr ? packet->m_material : overrideMaterial, packet);
+		}
+	}
+
+	void DrawList::DrawInstances(RenderEngine& renderEngine, RenderDevice& renderDevice, DrawParams& drawParams, Material* material, const RenderPacket* packet)
+	{
+		// Update the instance buffers w/ the transforms & draw.
+		VertexArray* vertexArray = packet->m_vertexArray;
+		UploadInstances(vertexArray, packet->m_modelBufferIndex, 0, m_models.size());
+
+		uint32 indexCount = packet->m_indexCount == 0 ? vertexArray->GetIndexCount() : packet->m_indexCount;
+		renderEngine.UpdateShaderData(material);
+		renderDevice.Draw(vertexArray->GetID(), drawParams, (uint32)m_models.size(), indexCount, false, packet->m_firstIndex);
+	}
+
+	void DrawList::UploadInstances(VertexArray* vertexArray, uint32 modelBufferIndex, size_t first, size_t count)
+	{
+		// Quantized normals & tangents are pre-scaled on import to cancel out the dequantization.
+		if (vertexArray->HasQuantizedPositions())
+		{
+			for (size_t i = first; i < first + count; i++)
+				m_models[i] = m_models[i] * vertexArray->GetPositionDequantization();
+		}
+
+		// Only the upper 3 rows are uploaded, the last row of an affine matrix is constant.
+		m_instanceTransforms.resize(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			const Matrix& model = m_models[first + i];
+			for (int row = 0; row < 3; row++)
+				m_instanceTransforms[i].m_rows[row] = Vector4(model[0][row], model[1][row], model[2][row], model[3][row]);
+		}
+
+		vertexArray->UpdateBuffer(modelBufferIndex, &m_instanceTransforms[0], count * sizeof(InstanceTransform));
+	}
+}
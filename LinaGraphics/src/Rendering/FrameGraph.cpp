@@ -0,0 +1,216 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Rendering/FrameGraph.hpp"
+#include "Rendering/GPUTimer.hpp"
+#include <algorithm>
+
+namespace LinaEngine::Graphics
+{
+	void FrameGraph::Construct(RenderDevice& renderDevice, RenderTargetPool& pool, GPUTimer& timer)
+	{
+		m_renderDevice = &renderDevice;
+		m_pool = &pool;
+		m_timer = &timer;
+	}
+
+	void FrameGraph::Reset()
+	{
+		m_passes.clear();
+		m_resources.clear();
+		m_culledPassCount = 0;
+	}
+
+	FrameGraphResource FrameGraph::Import(const std::string& name, uint32 fbo, Texture* texture, const Vector2& pos, const Vector2& size, const FrameGraphClear& clear)
+	{
+		ResourceNode node;
+		node.m_name = name;
+		node.m_fbo = fbo;
+		node.m_texture = texture;
+		node.m_pos = pos;
+		node.m_size = size;
+		node.m_clear = clear;
+		node.m_imported = true;
+		m_resources.push_back(node);
+		return (FrameGraphResource)m_resources.size() - 1;
+	}
+
+	FrameGraphResource FrameGraph::Create(const std::string& name, const Vector2& size, const SamplerParameters& params, const FrameGraphClear& clear)
+	{
+		ResourceNode node;
+		node.m_name = name;
+		node.m_size = size;
+		node.m_params = params;
+		node.m_clear = clear;
+		m_resources.push_back(node);
+		return (FrameGraphResource)m_resources.size() - 1;
+	}
+
+	FrameGraphPass& FrameGraph::AddPass(const std::string& name, const std::string& timerName, std::function<void()> execute)
+	{
+		m_passes.push_back(FrameGraphPass());
+		FrameGraphPass& pass = m_passes.back();
+		pass.m_name = name;
+		pass.m_timerName = timerName;
+		pass.m_execute = execute;
+		return pass;
+	}
+
+	void FrameGraph::Compile()
+	{
+		// Count the readers of each resource & the outputs of each pass.
+		for (FrameGraphPass& pass : m_passes)
+		{
+			pass.m_refCount = (int)pass.m_writes.size();
+			for (FrameGraphResource read : pass.m_reads)
+				m_resources[read].m_refCount++;
+		}
+
+		// Walk back from the resources nobody reads, a pass is culled once none of its outputs are read.
+		std::vector<FrameGraphResource> unreferenced;
+		for (size_t i = 0; i < m_resources.size(); i++)
+		{
+			if (m_resources[i].m_refCount == 0)
+				unreferenced.push_back((FrameGraphResource)i);
+		}
+
+		while (!unreferenced.empty())
+		{
+			FrameGraphResource resource = unreferenced.back();
+			unreferenced.pop_back();
+
+			for (FrameGraphPass& pass : m_passes)
+			{
+				if (pass.m_culled || pass.m_hasSideEffect) continue;
+				if (std::find(pass.m_writes.begin(), pass.m_writes.end(), resource) == pass.m_writes.end()) continue;
+
+				if (--pass.m_refCount > 0) continue;
+
+				pass.m_culled = true;
+				m_culledPassCount++;
+
+				for (FrameGraphResource read : pass.m_reads)
+				{
+					if (--m_resources[read].m_refCount == 0)
+						unreferenced.push_back(read);
+				}
+			}
+		}
+
+		// Lifetimes of the resources over the remaining passes.
+		for (size_t i = 0; i < m_passes.size(); i++)
+		{
+			FrameGraphPass& pass = m_passes[i];
+			if (pass.m_culled) continue;
+
+			for (int j = 0; j < 2; j++)
+			{
+				for (FrameGraphResource resource : j == 0 ? pass.m_reads : pass.m_writes)
+				{
+					ResourceNode& node = m_resources[resource];
+					if (node.m_firstPass == -1)
+						node.m_firstPass = (int)i;
+					node.m_lastPass = (int)i;
+				}
+			}
+		}
+	}
+
+	void FrameGraph::Execute()
+	{
+		std::string activeTimer = "";
+
+		for (size_t i = 0; i < m_passes.size(); i++)
+		{
+			FrameGraphPass& pass = m_passes[i];
+			if (pass.m_culled) continue;
+
+			// Transient targets are taken from the pool right before their first use.
+			for (ResourceNode& node : m_resources)
+			{
+				if (!node.m_imported && node.m_firstPass == (int)i)
+				{
+					node.m_pooled = m_pool->Acquire(node.m_size, node.m_params);
+					node.m_fbo = node.m_pooled->m_target.GetID();
+					node.m_texture = &node.m_pooled->m_texture;
+				}
+			}
+
+			if (activeTimer != pass.m_timerName)
+			{
+				if (!activeTimer.empty())
+					LINA_GPUTIMER_STOP(*m_timer);
+
+				if (!pass.m_timerName.empty())
+					LINA_GPUTIMER_START(*m_timer, pass.m_timerName);
+
+				activeTimer = pass.m_timerName;
+			}
+
+			// Clear the targets on their first write only.
+			for (FrameGraphResource write : pass.m_writes)
+			{
+				ResourceNode& node = m_resources[write];
+				if (node.m_cleared) continue;
+				node.m_cleared = true;
+
+				if (node.m_clear.m_color || node.m_clear.m_depth || node.m_clear.m_stencil)
+				{
+					m_renderDevice->SetFBO(node.m_fbo);
+					m_renderDevice->SetViewport(node.m_pos, node.m_size);
+					m_renderDevice->Clear(node.m_clear.m_color, node.m_clear.m_depth, node.m_clear.m_stencil, node.m_clear.m_clearColor, 0xFF);
+				}
+			}
+
+			// Bind the pass' target, redundant binds are skipped by the device.
+			if (!pass.m_writes.empty())
+			{
+				ResourceNode& target = m_resources[pass.m_writes[0]];
+				m_renderDevice->SetFBO(target.m_fbo);
+				m_renderDevice->SetViewport(target.m_pos, target.m_size);
+			}
+
+			pass.m_execute();
+
+			// Give the transient targets back once their last reader is done, later passes may reuse them.
+			for (ResourceNode& node : m_resources)
+			{
+				if (!node.m_imported && node.m_lastPass == (int)i)
+				{
+					m_pool->Release(node.m_pooled);
+					node.m_pooled = nullptr;
+					node.m_texture = nullptr;
+				}
+			}
+		}
+
+		if (!activeTimer.empty())
+			LINA_GPUTIMER_STOP(*m_timer);
+	}
+}
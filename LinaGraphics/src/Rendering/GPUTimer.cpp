@@ -0,0 +1,97 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Rendering/GPUTimer.hpp"
+#include "Core/Timer.hpp"
+#include "Utility/Log.hpp"
+
+namespace LinaEngine::Graphics
+{
+	void GPUTimer::Begin(const std::string& name)
+	{
+		if (m_isActive)
+		{
+			LINA_CORE_WARN("GPU timer {0} started while another pass is being timed, returning...", name);
+			return;
+		}
+
+		PassQueries& pass = m_passes[name];
+		uint32 slot = m_frameIndex % GPUTIMER_FRAME_LATENCY;
+
+		// A query still pending after the whole latency is reused, its result is dropped instead of waiting for it.
+		if (pass.m_queries[slot] == 0)
+			pass.m_queries[slot] = m_renderDevice->CreateQuery();
+
+		pass.m_pending[slot] = true;
+		m_renderDevice->BeginTimeQuery(pass.m_queries[slot]);
+		m_isActive = true;
+	}
+
+	void GPUTimer::End()
+	{
+		if (!m_isActive) return;
+
+		m_renderDevice->EndTimeQuery();
+		m_isActive = false;
+	}
+
+	void GPUTimer::EndFrame()
+	{
+		if (m_isActive)
+			End();
+
+		// Publish the results that are ready, the others are checked again next frame.
+		for (std::map<std::string, PassQueries>::iterator it = m_passes.begin(); it != m_passes.end(); ++it)
+		{
+			PassQueries& pass = it->second;
+
+			for (uint32 i = 0; i < GPUTIMER_FRAME_LATENCY; i++)
+			{
+				if (!pass.m_pending[i] || !m_renderDevice->IsQueryResultAvailable(pass.m_queries[i])) continue;
+
+				uint64 nanoseconds = m_renderDevice->GetQueryResult(pass.m_queries[i]);
+				Timer::GetTimer("[GPU] " + it->first).SetDuration((double)nanoseconds / 1000000.0);
+				pass.m_pending[i] = false;
+			}
+		}
+
+		m_frameIndex++;
+	}
+
+	void GPUTimer::Release()
+	{
+		for (std::map<std::string, PassQueries>::iterator it = m_passes.begin(); it != m_passes.end(); ++it)
+		{
+			for (uint32 i = 0; i < GPUTIMER_FRAME_LATENCY; i++)
+				it->second.m_queries[i] = m_renderDevice->ReleaseQuery(it->second.m_queries[i]);
+		}
+
+		m_passes.clear();
+	}
+}
@@ -0,0 +1,149 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Rendering/HDRICache.hpp"
+#include "Utility/Log.hpp"
+#include <fstream>
+
+namespace LinaEngine::Graphics
+{
+	uint64 HDRICache::HashBytes(const void* data, size_t size, uint64 hash)
+	{
+		const uint8* bytes = (const uint8*)data;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	uint64 HDRICache::HashFile(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open()) return 0;
+
+		// Hash in chunks, HDR sources are tens of megabytes.
+		uint64 hash = 14695981039346656037ull;
+		std::vector<char> chunk(1 << 16);
+		while (file.good())
+		{
+			file.read(chunk.data(), chunk.size());
+			hash = HashBytes(chunk.data(), (size_t)file.gcount(), hash);
+		}
+
+		return hash;
+	}
+
+	bool HDRICache::Read(const std::string& path, uint64 key, std::vector<HDRICacheImage>& images)
+	{
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file.is_open()) return false;
+
+		// Sizes read from the file are checked against the bytes left, so a corrupt file can not cause large allocations.
+		const uint64 fileSize = (uint64)file.tellg();
+		file.seekg(0, std::ios::beg);
+
+		uint32 magic = 0, version = 0, imageCount = 0;
+		uint64 fileKey = 0;
+		file.read((char*)&magic, sizeof(uint32));
+		file.read((char*)&version, sizeof(uint32));
+		file.read((char*)&fileKey, sizeof(uint64));
+		file.read((char*)&imageCount, sizeof(uint32));
+
+		if (!file.good() || magic != HDRICACHE_MAGIC || version != HDRICACHE_VERSION || fileKey != key)
+		{
+			LINA_CORE_TRACE("HDRI cache {0} is outdated, maps will be recomputed.", path);
+			return false;
+		}
+
+		bool valid = imageCount > 0 && imageCount <= HDRICACHE_MAXIMAGES;
+		if (valid)
+			images.resize(imageCount);
+
+		for (uint32 i = 0; valid && i < images.size(); i++)
+		{
+			HDRICacheImage& image = images[i];
+			uint32 header[6];
+			file.read((char*)header, sizeof(header));
+			image.m_map = (HDRICacheMap)header[0];
+			image.m_face = header[1];
+			image.m_mip = header[2];
+			image.m_width = header[3];
+			image.m_height = header[4];
+			image.m_channels = header[5];
+
+			const uint64 pixelBytes = (uint64)image.m_width * image.m_height * image.m_channels * sizeof(uint16);
+			const uint64 position = (uint64)file.tellg();
+			const uint64 bytesLeft = position <= fileSize ? fileSize - position : 0;
+			valid = file.good() && image.m_width > 0 && image.m_width <= HDRICACHE_MAXSIZE && image.m_height > 0 && image.m_height <= HDRICACHE_MAXSIZE
+				&& image.m_channels > 0 && image.m_channels <= HDRICACHE_MAXCHANNELS && pixelBytes <= bytesLeft;
+			if (!valid) break;
+
+			image.m_pixels.resize((size_t)image.m_width * image.m_height * image.m_channels);
+			file.read((char*)image.m_pixels.data(), pixelBytes);
+			valid = file.good();
+		}
+
+		if (!valid)
+		{
+			LINA_CORE_WARN("HDRI cache {0} is corrupt, maps will be recomputed.", path);
+			images.clear();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool HDRICache::Write(const std::string& path, uint64 key, const std::vector<HDRICacheImage>& images)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			LINA_CORE_WARN("HDRI cache {0} could not be written.", path);
+			return false;
+		}
+
+		uint32 magic = HDRICACHE_MAGIC, version = HDRICACHE_VERSION, imageCount = (uint32)images.size();
+		file.write((const char*)&magic, sizeof(uint32));
+		file.write((const char*)&version, sizeof(uint32));
+		file.write((const char*)&key, sizeof(uint64));
+		file.write((const char*)&imageCount, sizeof(uint32));
+
+		for (const HDRICacheImage& image : images)
+		{
+			uint32 header[6] = { (uint32)image.m_map, image.m_face, image.m_mip, image.m_width, image.m_height, image.m_channels };
+			file.write((const char*)header, sizeof(header));
+			file.write((const char*)image.m_pixels.data(), image.m_pixels.size() * sizeof(uint16));
+		}
+
+		return file.good();
+	}
+}
@@ -28,9 +28,66 @@ SOFTWARE.
 
 #include "Rendering/IndexedModel.hpp"  
 #include "PackageManager/PAMRenderDevice.hpp"
+#include "Utility/Math/Math.hpp"
+#include <glm/gtc/packing.hpp>
+#include <cstring>
 
 namespace LinaEngine::Graphics
 {
+	// Instanced elements start at the same location in both layouts so shaders are shared.
+	#define INTERLEAVED_INSTANCELOCATION 5
+
+	// Maps a unit vector onto the octahedron unfolded to [-1, 1].
+	static Vector2 EncodeOctahedral(float x, float y, float z)
+	{
+		float sum = Math::Abs(x) + Math::Abs(y) + Math::Abs(z);
+		if (sum <= 0.0f) return Vector2(0.0f, 0.0f);
+
+		float octX = x / sum;
+		float octY = y / sum;
+
+		// Fold the lower hemisphere over the diagonals.
+		if (z < 0.0f)
+		{
+			float foldedX = (1.0f - Math::Abs(octY)) * (octX >= 0.0f ? 1.0f : -1.0f);
+			float foldedY = (1.0f - Math::Abs(octX)) * (octY >= 0.0f ? 1.0f : -1.0f);
+			octX = foldedX;
+			octY = foldedY;
+		}
+
+		return Vector2(octX, octY);
+	}
+
+	static int16 PackSnorm(float value)
+	{
+		return (int16)glm::packSnorm1x16(value);
+	}
+
+	static void GetPositionBounds(const std::vector<float>& positions, Vector3& center, Vector3& halfExtent)
+	{
+		Vector3 boundsMin = Vector3::Zero;
+		Vector3 boundsMax = Vector3::Zero;
+		if (positions.size() >= 3)
+		{
+			boundsMin = Vector3(positions[0], positions[1], positions[2]);
+			boundsMax = boundsMin;
+		}
+
+		for (size_t i = 3; i + 2 < positions.size(); i += 3)
+		{
+			boundsMin = Vector3(Math::Min(boundsMin.x, positions[i]), Math::Min(boundsMin.y, positions[i + 1]), Math::Min(boundsMin.z, positions[i + 2]));
+			boundsMax = Vector3(Math::Max(boundsMax.x, positions[i]), Math::Max(boundsMax.y, positions[i + 1]), Math::Max(boundsMax.z, positions[i + 2]));
+		}
+
+		center = Vector3((boundsMin.x + boundsMax.x) * 0.5f, (boundsMin.y + boundsMax.y) * 0.5f, (boundsMin.z + boundsMax.z) * 0.5f);
+
+		// Flat axes keep a unit extent to avoid dividing by zero.
+		halfExtent = Vector3((boundsMax.x - boundsMin.x) * 0.5f, (boundsMax.y - boundsMin.y) * 0.5f, (boundsMax.z - boundsMin.z) * 0.5f);
+		if (halfExtent.x <= 0.0f) halfExtent.x = 1.0f;
+		if (halfExtent.y <= 0.0f) halfExtent.y = 1.0f;
+		if (halfExtent.z <= 0.0f) halfExtent.z = 1.0f;
+	}
+
 	void IndexedModel::AddElement(uint32 elementIndex, float e0)
 	{
 	
@@ -95,6 +152,55 @@ namespace LinaEngine::Graphics
 		m_elements.push_back(std::vector<float>());
 	}
 
+	void IndexedModel::CalculateBoundingSphere(Vector3& center, float& radius) const
+	{
+		center = Vector3::Zero;
+		radius = 0.0f;
+		if (m_elements.size() == 0 || m_elementSizes[0] != 3 || m_elements[0].size() < 3) return;
+
+		// Center the sphere on the bounding box of the positions.
+		const std::vector<float>& positions = m_elements[0];
+		Vector3 boundsMin = Vector3(positions[0], positions[1], positions[2]);
+		Vector3 boundsMax = boundsMin;
+		for (size_t i = 3; i + 2 < positions.size(); i += 3)
+		{
+			boundsMin = Vector3(Math::Min(boundsMin.x, positions[i]), Math::Min(boundsMin.y, positions[i + 1]), Math::Min(boundsMin.z, positions[i + 2]));
+			boundsMax = Vector3(Math::Max(boundsMax.x, positions[i]), Math::Max(boundsMax.y, positions[i + 1]), Math::Max(boundsMax.z, positions[i + 2]));
+		}
+
+		center = Vector3((boundsMin.x + boundsMax.x) * 0.5f, (boundsMin.y + boundsMax.y) * 0.5f, (boundsMin.z + boundsMax.z) * 0.5f);
+
+		// Then grow it to the furthest position.
+		float radiusSqr = 0.0f;
+		for (size_t i = 0; i + 2 < positions.size(); i += 3)
+			radiusSqr = Math::Max(radiusSqr, Math::Square(positions[i] - center.x) + Math::Square(positions[i + 1] - center.y) + Math::Square(positions[i + 2] - center.z));
+
+		radius = Math::Sqrt(radiusSqr);
+	}
+
+	bool IndexedModel::IsInterleaved() const
+	{
+		if (!m_interleaved) return false;
+
+		uint32 numVertexComponents = m_startIndex == ((uint32)-1) ? m_elementSizes.size() : m_startIndex;
+		return numVertexComponents >= 4 && m_elementSizes[0] == 3 && m_elementSizes[1] == 2 && m_elementSizes[2] == 3 && m_elementSizes[3] == 3;
+	}
+
+	uint32 IndexedModel::GetInstanceBufferIndex() const
+	{
+		if (IsInterleaved()) return 1;
+		return m_startIndex == ((uint32)-1) ? m_elementSizes.size() : m_startIndex;
+	}
+
+	Matrix IndexedModel::GetPositionDequantization() const
+	{
+		if (!HasQuantizedPositions()) return Matrix::Identity();
+
+		Vector3 center, halfExtent;
+		GetPositionBounds(m_elements[0], center, halfExtent);
+		return Matrix::Translate(center) * Matrix::Scale(halfExtent);
+	}
+
 	uint32 IndexedModel::CreateVertexArray(RenderDevice& renderDevice, BufferUsage bufferUsage) const
 	{
 		// Find the vertex component size using start index of instanced components.
@@ -102,6 +208,88 @@ namespace LinaEngine::Graphics
 		uint32 numInstanceComponents = m_startIndex == ((uint32)-1) ? 0 : (numVertexComponents - m_startIndex);
 		numVertexComponents -= numInstanceComponents;
 
+		// Narrow the indices to 16 bits when all vertices are addressable w/ them.
+		std::vector<uint16> shortIndices;
+		const bool useShortIndices = m_elements[0].size() / m_elementSizes[0] <= 0xFFFF;
+		if (useShortIndices)
+			shortIndices.assign(m_indices.begin(), m_indices.end());
+
+		const void* indices = useShortIndices ? (const void*)shortIndices.data() : (const void*)m_indices.data();
+
+		if (IsInterleaved())
+		{
+			const std::vector<float>& positions = m_elements[0];
+			const std::vector<float>& texCoords = m_elements[1];
+			const std::vector<float>& normals = m_elements[2];
+			const std::vector<float>& tangents = m_elements[3];
+			const std::vector<float>* bitangents = numVertexComponents > 4 && m_elementSizes[4] == 3 ? &m_elements[4] : nullptr;
+			uint32 numVertices = positions.size() / 3;
+
+			// Position, 2 half float tex coords, 2 snorm normal & 4 snorm tangent w/ the bitangent sign.
+			uint32 positionSize = m_quantizePositions ? 4 * sizeof(int16) : 3 * sizeof(float);
+			uint32 stride = positionSize + 2 * sizeof(uint16) + 2 * sizeof(int16) + 4 * sizeof(int16);
+			std::vector<uint8> vertexData(numVertices * stride);
+
+			Vector3 center, halfExtent;
+			if (m_quantizePositions)
+				GetPositionBounds(positions, center, halfExtent);
+
+			for (uint32 i = 0; i < numVertices; i++)
+			{
+				uint8* vertex = &vertexData[i * stride];
+				const float* position = &positions[i * 3];
+				const float* normal = &normals[i * 3];
+				const float* tangent = &tangents[i * 3];
+
+				if (m_quantizePositions)
+				{
+					int16 packedPosition[4] = { PackSnorm((position[0] - center.x) / halfExtent.x), PackSnorm((position[1] - center.y) / halfExtent.y), PackSnorm((position[2] - center.z) / halfExtent.z), 0 };
+					memcpy(vertex, packedPosition, sizeof(packedPosition));
+				}
+				else
+					memcpy(vertex, position, 3 * sizeof(float));
+
+				uint16 packedTexCoord[2] = { glm::packHalf1x16(texCoords[i * 2]), glm::packHalf1x16(texCoords[i * 2 + 1]) };
+				memcpy(vertex + positionSize, packedTexCoord, sizeof(packedTexCoord));
+
+				// The instance matrix carries the dequantization scale, normals are pre-scaled by it & tangents by its inverse
+				// so the normal matrix & model matrix derived in the shaders map them back to the same directions.
+				Vector3 packedNormalDir = Vector3(normal[0], normal[1], normal[2]);
+				Vector3 packedTangentDir = Vector3(tangent[0], tangent[1], tangent[2]);
+				if (m_quantizePositions)
+				{
+					packedNormalDir = Vector3(packedNormalDir.x * halfExtent.x, packedNormalDir.y * halfExtent.y, packedNormalDir.z * halfExtent.z);
+					packedTangentDir = Vector3(packedTangentDir.x / halfExtent.x, packedTangentDir.y / halfExtent.y, packedTangentDir.z / halfExtent.z);
+				}
+
+				Vector2 octNormal = EncodeOctahedral(packedNormalDir.x, packedNormalDir.y, packedNormalDir.z);
+				int16 packedNormal[2] = { PackSnorm(octNormal.x), PackSnorm(octNormal.y) };
+				memcpy(vertex + positionSize + 4, packedNormal, sizeof(packedNormal));
+
+				// Bitangent is rebuilt in the shader as cross(normal, tangent) * sign.
+				float sign = 1.0f;
+				if (bitangents != nullptr)
+				{
+					Vector3 n = Vector3(normal[0], normal[1], normal[2]);
+					Vector3 b = Vector3((*bitangents)[i * 3], (*bitangents)[i * 3 + 1], (*bitangents)[i * 3 + 2]);
+					sign = n.Cross(Vector3(tangent[0], tangent[1], tangent[2])).Dot(b) < 0.0f ? -1.0f : 1.0f;
+				}
+
+				Vector2 octTangent = EncodeOctahedral(packedTangentDir.x, packedTangentDir.y, packedTangentDir.z);
+				int16 packedTangent[4] = { PackSnorm(octTangent.x), PackSnorm(octTangent.y), PackSnorm(sign), 0 };
+				memcpy(vertex + positionSize + 8, packedTangent, sizeof(packedTangent));
+			}
+
+			VertexAttribute attributes[4];
+			attributes[0] = { 0, m_quantizePositions ? 4u : 3u, m_quantizePositions ? VertexAttributeType::ATTRIB_SHORT_NORMALIZED : VertexAttributeType::ATTRIB_FLOAT, 0 };
+			attributes[1] = { 1, 2, VertexAttributeType::ATTRIB_HALF_FLOAT, positionSize };
+			attributes[2] = { 2, 2, VertexAttributeType::ATTRIB_SHORT_NORMALIZED, positionSize + 4 };
+			attributes[3] = { 3, 4, VertexAttributeType::ATTRIB_SHORT_NORMALIZED, positionSize + 8 };
+
+			const uint32* instanceElementSizes = numInstanceComponents > 0 ? &m_elementSizes[m_startIndex] : nullptr;
+			return renderDevice.CreateInterleavedVertexArray(&vertexData[0], stride, attributes, 4, numVertices, instanceElementSizes, numInstanceComponents, INTERLEAVED_INSTANCELOCATION, indices, m_indices.size(), useShortIndices, bufferUsage);
+		}
+
 		// Create a new array to add the instanced data.
 		std::vector<const float*> vertexDataArray;
 
@@ -116,7 +304,7 @@ namespace LinaEngine::Graphics
 		uint32 numVertices = m_elements[0].size() / vertexElementSizes[0];
 		uint32 numIndices = m_indices.size();
 
-		return renderDevice.CreateVertexArray(vertexData, vertexElementSizes, vertexElementTypes, numVertexComponents, numInstanceComponents, numVertices, &m_indices[0], numIndices, bufferUsage);
+		return renderDevice.CreateVertexArray(vertexData, vertexElementSizes, vertexElementTypes, numVertexComponents, numInstanceComponents, numVertices, indices, numIndices, useShortIndices, bufferUsage);
 	}
 }
 
@@ -52,7 +52,7 @@ namespace LinaEngine::Graphics
 			}
 		}
 
-		m_shaderID = Shader::GetShader(m_shaderType).GetID();
+		m_shaderID = 0;
 	}
 
 
@@ -65,6 +65,8 @@ namespace LinaEngine::Graphics
 			// Read the data into it.
 			iarchive(mat);
 		}
+
+		mat.SetParametersChanged();
 	}
 
 	void Material::SaveMaterialData(const Material& mat, const std::string& path)
@@ -85,6 +87,7 @@ namespace LinaEngine::Graphics
 			m_sampler2Ds[textureName].m_boundTexture = texture;
 			m_sampler2Ds[textureName].m_bindMode = bindMode;
 			m_sampler2Ds[textureName].m_isActive = texture == nullptr ? false : true;
+			m_shaderVariantDirty = true;
 
 			if (texture != nullptr)
 			{
@@ -104,6 +107,7 @@ namespace LinaEngine::Graphics
 		{
 			m_sampler2Ds[textureName].m_boundTexture = nullptr;
 			m_sampler2Ds[textureName].m_isActive = false;
+			m_shaderVariantDirty = true;
 		}
 		else
 		{
@@ -145,6 +149,42 @@ namespace LinaEngine::Graphics
 		mat.m_path = path;
 		return s_loadedMaterials[id];
 	}
+	uint32 Material::GetShaderID()
+	{
+		if (m_shaderID != 0 && !m_shaderVariantDirty && m_shaderGeneration == Shader::GetGeneration())
+			return m_shaderID;
+
+		// Build the keyword mask from the features currently active on the material.
+		Shader& shader = Shader::GetShader(m_shaderType);
+		const std::vector<ShaderKeyword>& keywords = shader.GetKeywords();
+		uint32 variant = 0;
+		for (uint32 i = 0; i < keywords.size(); i++)
+		{
+			if (IsFeatureActive(keywords[i].m_parameter))
+				variant |= 1u << i;
+		}
+
+		// Reloaded programs may reuse the released ids, resolve the uniform handles again.
+		if (m_shaderGeneration != Shader::GetGeneration())
+			m_parameterGeneration++;
+
+		m_shaderID = shader.GetVariant(variant);
+		m_shaderVariant = variant;
+		m_shaderGeneration = Shader::GetGeneration();
+		m_shaderVariantDirty = false;
+		return m_shaderID;
+	}
+
+	bool Material::IsFeatureActive(const std::string& parameter)
+	{
+		std::map<std::string, MaterialSampler2D>::iterator sampler = m_sampler2Ds.find(parameter);
+		if (sampler != m_sampler2Ds.end())
+			return sampler->second.m_isActive && sampler->second.m_boundTexture != nullptr && !sampler->second.m_boundTexture->GetIsEmpty();
+
+		std::map<std::string, bool>::iterator flag = m_bools.find(parameter);
+		return flag != m_bools.end() && flag->second;
+	}
+
 	Material& Material::GetMaterial(int id)
 	{
 		if (!MaterialExists(id))
@@ -177,12 +217,16 @@ namespace LinaEngine::Graphics
 	{
 		// If no shader found, fall back to standardLit
 		std::map<int, Shader>& shaders = Shader::GetLoadedShaders();
+		Shader* materialShader = nullptr;
 		if (shaders.find(shader) == shaders.end()) {
 			LINA_CORE_WARN("Shader with engine ID {0} was not found. Setting material's shader to standardUnlit.", shader);
-			material.m_shaderID = shaders[Shaders::Standard_Unlit].GetID();
+			materialShader = &shaders[Shaders::Standard_Unlit];
 		}
 		else
-			material.m_shaderID = shaders[shader].GetID();
+			materialShader = &shaders[shader];
+
+		// The variant is resolved on first use, once the material's textures & bools are set.
+		material.m_shaderID = 0;
 
 		if (onlySetID) return material;
 
@@ -196,8 +240,10 @@ namespace LinaEngine::Graphics
 		material.m_vector2s.clear();
 		material.m_matrices.clear();
 		material.m_vector4s.clear();
+		material.m_parameterGeneration++;
 		material.m_shaderType = shader;
 		material.m_isShadowMapped = false;
+		material.m_blockDirty = true;
 		material.m_receivesLighting = false;
 		material.m_usesHDRI = false;
 
@@ -251,10 +297,14 @@ namespace LinaEngine::Graphics
 			material.m_bools[MAT_FXAAENABLED] = false;
 			material.m_vector3s[MAT_INVERSESCREENMAPSIZE] = Vector3();
 		}
-		else if (shader == Shaders::ScreenQuad_Blur)
+		else if (shader == Shaders::ScreenQuad_Bloom)
 		{
 			material.m_sampler2Ds[MAT_MAP_SCREEN] = { 0 };
-			material.m_bools[MAT_ISHORIZONTAL] = false;
+			material.m_sampler2Ds[MAT_MAP_BLOOM] = { 1 };
+			material.m_vector3s[MAT_INVERSESCREENMAPSIZE] = Vector3();
+			material.m_floats[MAT_BLOOMTHRESHOLD] = 1.0f;
+			material.m_floats[MAT_BLOOMRADIUS] = 1.0f;
+			material.m_ints[MAT_BLOOMPASS] = 0;
 		}
 		else if (shader == Shaders::ScreenQuad_Outline)
 		{
@@ -272,10 +322,11 @@ namespace LinaEngine::Graphics
 			material.m_sampler2Ds[MAT_TEXTURE2D_ROUGHNESSMAP] = { 2 };
 			material.m_sampler2Ds[MAT_TEXTURE2D_METALLICMAP] = { 3 };
 			material.m_sampler2Ds[MAT_TEXTURE2D_AOMAP] = { 4 };
-		//	material.m_sampler2Ds[MAT_TEXTURE2D_SHADOWMAP] = { 5 };
 			material.m_sampler2Ds[MAT_TEXTURE2D_BRDFLUTMAP] = { 5 };
 			material.m_sampler2Ds[MAT_TEXTURE2D_IRRADIANCEMAP] = { 6, nullptr, "", "", TextureBindMode::BINDTEXTURE_CUBEMAP, false };
 			material.m_sampler2Ds[MAT_TEXTURE2D_PREFILTERMAP] = { 7,nullptr, "", "", TextureBindMode::BINDTEXTURE_CUBEMAP, false };
+			material.m_sampler2Ds[MAT_TEXTURE2D_SHADOWMAP] = { 8 };
+			material.m_bools[MAT_IRRADIANCESH] = false;
 			material.m_floats[MAT_METALLICMULTIPLIER] = 1.0f;
 			material.m_floats[MAT_ROUGHNESSMULTIPLIER] = 1.0f;
 			material.m_ints[MAT_WORKFLOW] = 0;
@@ -301,6 +352,10 @@ namespace LinaEngine::Graphics
 			material.m_colors[MAT_OBJECTCOLORPROPERTY] = Color::White;
 			material.m_sampler2Ds[MAT_TEXTURE2D_DIFFUSE] = { 0 };
 		}
+		else if (shader == Shaders::Standard_SpriteBatch)
+		{
+			material.m_sampler2Ds[MAT_TEXTURE2D_DIFFUSE] = { 0 };
+		}
 
 
 		return material;
@@ -318,6 +373,9 @@ namespace LinaEngine::Graphics
 
 	void Material::UnloadAll()
 	{
+		for (std::map<int, Material>::iterator it = s_loadedMaterials.begin(); it != s_loadedMaterials.end(); ++it)
+			it->second.m_blockBuffer = RenderEngine::GetRenderDevice().ReleaseUniformBuffer(it->second.m_blockBuffer);
+
 		s_loadedMaterials.clear();
 		s_hdriMaterials.clear();
 		s_shadowMappedMaterials.clear();
@@ -349,6 +407,7 @@ namespace LinaEngine::Graphics
 		if (s_shadowMappedMaterials.find(&s_loadedMaterials[id]) != s_shadowMappedMaterials.end())
 			s_shadowMappedMaterials.erase(&s_loadedMaterials[id]);
 
+		s_loadedMaterials[id].m_blockBuffer = RenderEngine::GetRenderDevice().ReleaseUniformBuffer(s_loadedMaterials[id].m_blockBuffer);
 		s_loadedMaterials.erase(id);
 	}
 }
\ No newline at end of file
@@ -31,6 +31,8 @@ SOFTWARE.
 #include "Utility/UtilityFunctions.hpp"
 #include "Rendering/RenderEngine.hpp"
 #include "Rendering/ModelLoader.hpp"
+#include "Rendering/MeshSimplifier.hpp"
+#include "Rendering/MeshOptimizer.hpp"
 #include <stdio.h>
 #include <cereal/archives/binary.hpp>
 #include <fstream>
@@ -46,6 +48,14 @@ namespace LinaEngine::Graphics
 			delete m_vertexArrays[i];
 
 		m_vertexArrays.clear();
+
+		for (uint32 i = 0; i < m_lodVertexArrays.size(); i++)
+		{
+			for (uint32 j = 0; j < m_lodVertexArrays[i].size(); j++)
+				delete m_lodVertexArrays[i][j];
+		}
+
+		m_lodVertexArrays.clear();
 		m_indexedModelArray.clear();
 		m_materialSpecArray.clear();
 		m_materialIndexArray.clear();
@@ -67,6 +77,18 @@ namespace LinaEngine::Graphics
 			return GetPrimitive(Primitives::Plane);
 		}
 
+		// Reorder for the vertex caches & overdraw before uploading.
+		mesh.m_optimizationReports.clear();
+		if (meshParams.m_optimizeMesh)
+		{
+			for (uint32 i = 0; i < mesh.GetIndexedModels().size(); i++)
+			{
+				MeshOptimizationReport report = MeshOptimizer::Optimize(mesh.GetIndexedModels()[i]);
+				mesh.m_optimizationReports.push_back(report);
+				LINA_CORE_TRACE("Mesh optimized. {0} [{1}] ACMR: {2} -> {3} ATVR: {4} -> {5}", filePath, i, report.m_acmrBefore, report.m_acmrAfter, report.m_atvrBefore, report.m_atvrAfter);
+			}
+		}
+
 		// Create vertex array for each mesh.
 		for (uint32 i = 0; i < mesh.GetIndexedModels().size(); i++)
 		{
@@ -75,6 +97,57 @@ namespace LinaEngine::Graphics
 			mesh.GetVertexArrays().push_back(vertexArray);
 		}
 
+		// Generate the simplified levels, each from the previous one.
+		std::vector<IndexedModel> lodModels = mesh.GetIndexedModels();
+		for (int lod = 0; lod < meshParams.m_lodCount; lod++)
+		{
+			uint32 previousIndexCount = 0;
+			uint32 indexCount = 0;
+
+			for (uint32 i = 0; i < lodModels.size(); i++)
+			{
+				IndexedModel& previous = lodModels[i];
+				uint32 targetIndexCount = (uint32)((float)(previous.GetIndexCount() / 3) * meshParams.m_lodReduction) * 3;
+				previousIndexCount += previous.GetIndexCount();
+
+				if (targetIndexCount >= LOD_MINTRIANGLES * 3)
+				{
+					IndexedModel simplified;
+					MeshSimplifier::Simplify(previous, simplified, targetIndexCount);
+
+					if (meshParams.m_optimizeMesh)
+						MeshOptimizer::Optimize(simplified);
+
+					lodModels[i] = simplified;
+				}
+
+				indexCount += lodModels[i].GetIndexCount();
+			}
+
+			// Stop once the meshes can not be reduced meaningfully, e.g. mostly seams or already below the minimum.
+			if ((float)indexCount > (float)previousIndexCount * 0.9f) break;
+
+			std::vector<VertexArray*> lodArrays;
+			for (uint32 i = 0; i < lodModels.size(); i++)
+			{
+				VertexArray* vertexArray = new VertexArray();
+				vertexArray->Construct(RenderEngine::GetRenderDevice(), lodModels[i], BufferUsage::USAGE_STATIC_COPY);
+				lodArrays.push_back(vertexArray);
+			}
+
+			mesh.m_lodVertexArrays.push_back(lodArrays);
+		}
+
+		// Only positions & indices are kept for the occlusion rasterizer.
+		mesh.m_occluderGeometry.clear();
+		for (uint32 i = 0; i < lodModels.size(); i++)
+		{
+			OccluderGeometry geometry;
+			geometry.m_positions = lodModels[i].GetElements()[0];
+			geometry.m_indices = lodModels[i].GetIndices();
+			mesh.m_occluderGeometry.push_back(geometry);
+		}
+
 		// Set id
 		mesh.m_meshID = id;
 		mesh.m_path = filePath;
@@ -157,11 +230,22 @@ namespace LinaEngine::Graphics
 		MeshParameters params;
 
 		std::ifstream stream(path);
+
+		try
 		{
+			bool versioned = Utility::ReadVersionTag(stream);
 			cereal::BinaryInputArchive iarchive(stream);
 
-			// Read the data into it.
-			iarchive(params);
+			// Read the data into it, files without the tag were written before the parameters were versioned.
+			if (versioned)
+				iarchive(params);
+			else
+				params.serialize(iarchive, 0);
+		}
+		catch (const std::exception& e)
+		{
+			LINA_CORE_WARN("Mesh parameters {0} could not be read, using defaults. {1}", path, e.what());
+			return MeshParameters();
 		}
 
 		return params;
@@ -171,6 +255,7 @@ namespace LinaEngine::Graphics
 	{
 		std::ofstream stream(path);
 		{
+			Utility::WriteVersionTag(stream);
 			cereal::BinaryOutputArchive oarchive(stream); // Create an output archive
 
 			oarchive(params); // Write the data to the archive
@@ -0,0 +1,358 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Rendering/MeshOptimizer.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace LinaEngine::Graphics
+{
+	struct TriangleCluster
+	{
+		uint32 m_start = 0;
+		uint32 m_end = 0;
+		float m_sortKey = 0.0f;
+	};
+
+	static float GetVertexScore(int cachePosition, uint32 remainingTriangles)
+	{
+		if (remainingTriangles == 0) return -1.0f;
+
+		float score = 0.0f;
+		if (cachePosition >= 0)
+		{
+			// Vertices of the last triangle get a fixed score, using them right away tends to produce strips.
+			if (cachePosition < 3)
+				score = 0.75f;
+			else
+				score = std::pow(1.0f - (float)(cachePosition - 3) / (float)(MESHOPT_CACHESIZE - 3), 1.5f);
+		}
+
+		// Boost the vertices w/ few triangles left, finishing them takes them out of the working set.
+		score += 2.0f * std::pow((float)remainingTriangles, -0.5f);
+		return score;
+	}
+
+	MeshOptimizationReport MeshOptimizer::Optimize(IndexedModel& model)
+	{
+		MeshOptimizationReport report;
+
+		std::vector<std::vector<float>>& elements = model.GetElements();
+		std::vector<uint32>& indices = model.GetIndices();
+		if (elements.size() == 0 || model.GetElementSizes()[0] != 3 || indices.size() < 3) return report;
+
+		uint32 vertexCount = (uint32)(elements[0].size() / 3);
+		AnalyzeVertexCache(indices, vertexCount, report.m_acmrBefore, report.m_atvrBefore);
+
+		OptimizeVertexCache(indices, vertexCount);
+		OptimizeOverdraw(indices, elements[0], vertexCount);
+		OptimizeVertexFetch(model);
+
+		vertexCount = (uint32)(elements[0].size() / 3);
+		AnalyzeVertexCache(indices, vertexCount, report.m_acmrAfter, report.m_atvrAfter);
+		return report;
+	}
+
+	void MeshOptimizer::OptimizeVertexCache(std::vector<uint32>& indices, uint32 vertexCount)
+	{
+		const uint32 triangleCount = (uint32)(indices.size() / 3);
+		if (triangleCount == 0) return;
+
+		// Triangles using each vertex, emitted triangles are removed from the lists.
+		std::vector<uint32> remainingTriangles(vertexCount, 0);
+		std::vector<uint32> adjacencyOffsets(vertexCount + 1, 0);
+		for (uint32 i = 0; i < triangleCount * 3; i++)
+			remainingTriangles[indices[i]]++;
+
+		for (uint32 i = 0; i < vertexCount; i++)
+			adjacencyOffsets[i + 1] = adjacencyOffsets[i] + remainingTriangles[i];
+
+		std::vector<uint32> adjacency(triangleCount * 3);
+		std::vector<uint32> adjacencyCursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (uint32 i = 0; i < triangleCount * 3; i++)
+			adjacency[adjacencyCursor[indices[i]]++] = i / 3;
+
+		std::vector<int> cachePositions(vertexCount, -1);
+		std::vector<float> vertexScores(vertexCount);
+		for (uint32 i = 0; i < vertexCount; i++)
+			vertexScores[i] = GetVertexScore(-1, remainingTriangles[i]);
+
+		std::vector<float> triangleScores(triangleCount);
+		std::vector<bool> emitted(triangleCount, false);
+		int bestTriangle = -1;
+		float bestScore = -1.0f;
+		for (uint32 i = 0; i < triangleCount; i++)
+		{
+			triangleScores[i] = vertexScores[indices[i * 3]] + vertexScores[indices[i * 3 + 1]] + vertexScores[indices[i * 3 + 2]];
+			if (triangleScores[i] > bestScore)
+			{
+				bestScore = triangleScores[i];
+				bestTriangle = (int)i;
+			}
+		}
+
+		std::vector<uint32> output;
+		output.reserve(triangleCount * 3);
+		std::vector<uint32> cache;
+		std::vector<uint32> newCache;
+		uint32 scanCursor = 0;
+
+		while (output.size() < triangleCount * 3)
+		{
+			// No triangle left around the cache, continue from the next one in the input order.
+			if (bestTriangle < 0)
+			{
+				while (emitted[scanCursor])
+					scanCursor++;
+
+				bestTriangle = (int)scanCursor;
+			}
+
+			const uint32* triangle = &indices[bestTriangle * 3];
+			emitted[bestTriangle] = true;
+			output.insert(output.end(), triangle, triangle + 3);
+
+			// Remove the triangle from its vertices' lists.
+			for (int i = 0; i < 3; i++)
+			{
+				uint32 vertex = triangle[i];
+				uint32* list = &adjacency[adjacencyOffsets[vertex]];
+				uint32 count = remainingTriangles[vertex];
+				for (uint32 j = 0; j < count; j++)
+				{
+					if (list[j] == (uint32)bestTriangle)
+					{
+						list[j] = list[count - 1];
+						remainingTriangles[vertex]--;
+						break;
+					}
+				}
+			}
+
+			// The triangle's vertices move to the front of the cache.
+			newCache.clear();
+			newCache.insert(newCache.end(), triangle, triangle + 3);
+			for (uint32 vertex : cache)
+			{
+				if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+					newCache.push_back(vertex);
+			}
+
+			cache.swap(newCache);
+
+			// Update the scores of the vertices in the cache & the ones pushed out of it.
+			for (uint32 i = 0; i < cache.size(); i++)
+			{
+				uint32 vertex = cache[i];
+				cachePositions[vertex] = i < MESHOPT_CACHESIZE ? (int)i : -1;
+
+				float score = GetVertexScore(cachePositions[vertex], remainingTriangles[vertex]);
+				float difference = score - vertexScores[vertex];
+				vertexScores[vertex] = score;
+
+				for (uint32 j = 0; j < remainingTriangles[vertex]; j++)
+					triangleScores[adjacency[adjacencyOffsets[vertex] + j]] += difference;
+			}
+
+			if (cache.size() > MESHOPT_CACHESIZE)
+				cache.resize(MESHOPT_CACHESIZE);
+
+			// Next triangle is the best one using a cached vertex.
+			bestTriangle = -1;
+			bestScore = -1.0f;
+			for (uint32 vertex : cache)
+			{
+				for (uint32 j = 0; j < remainingTriangles[vertex]; j++)
+				{
+					uint32 candidate = adjacency[adjacencyOffsets[vertex] + j];
+					if (triangleScores[candidate] > bestScore)
+					{
+						bestScore = triangleScores[candidate];
+						bestTriangle = (int)candidate;
+					}
+				}
+			}
+		}
+
+		indices.swap(output);
+	}
+
+	void MeshOptimizer::OptimizeOverdraw(std::vector<uint32>& indices, const std::vector<float>& positions, uint32 vertexCount)
+	{
+		const uint32 triangleCount = (uint32)(indices.size() / 3);
+		if (triangleCount == 0) return;
+
+		// A triangle missing all of its vertices starts a new cluster, splitting there keeps the cache efficiency.
+		std::vector<TriangleCluster> clusters;
+		std::vector<uint32> timestamps(vertexCount, 0);
+		uint32 time = MESHOPT_ANALYZECACHESIZE + 1;
+		for (uint32 i = 0; i < triangleCount; i++)
+		{
+			int misses = 0;
+			for (int j = 0; j < 3; j++)
+			{
+				uint32 vertex = indices[i * 3 + j];
+				if (time - timestamps[vertex] > MESHOPT_ANALYZECACHESIZE)
+				{
+					timestamps[vertex] = time++;
+					misses++;
+				}
+			}
+
+			if (i == 0 || misses == 3)
+			{
+				if (clusters.size() > 0) clusters.back().m_end = i;
+				TriangleCluster cluster;
+				cluster.m_start = i;
+				clusters.push_back(cluster);
+			}
+		}
+
+		clusters.back().m_end = triangleCount;
+		if (clusters.size() == 1) return;
+
+		// Area weighted centroids & normals of the clusters.
+		std::vector<Vector3> clusterCentroids(clusters.size(), Vector3::Zero);
+		std::vector<Vector3> clusterNormals(clusters.size(), Vector3::Zero);
+		Vector3 meshCentroid = Vector3::Zero;
+		float meshArea = 0.0f;
+		for (size_t c = 0; c < clusters.size(); c++)
+		{
+			float clusterArea = 0.0f;
+			for (uint32 i = clusters[c].m_start; i < clusters[c].m_end; i++)
+			{
+				const float* p0 = &positions[indices[i * 3] * 3];
+				const float* p1 = &positions[indices[i * 3 + 1] * 3];
+				const float* p2 = &positions[indices[i * 3 + 2] * 3];
+				Vector3 edge0 = Vector3(p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]);
+				Vector3 edge1 = Vector3(p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]);
+				Vector3 normal = edge0.Cross(edge1);
+				float area = normal.Magnitude();
+
+				clusterCentroids[c].x += (p0[0] + p1[0] + p2[0]) * area;
+				clusterCentroids[c].y += (p0[1] + p1[1] + p2[1]) * area;
+				clusterCentroids[c].z += (p0[2] + p1[2] + p2[2]) * area;
+				clusterNormals[c].x += normal.x;
+				clusterNormals[c].y += normal.y;
+				clusterNormals[c].z += normal.z;
+				clusterArea += area;
+			}
+
+			meshCentroid.x += clusterCentroids[c].x;
+			meshCentroid.y += clusterCentroids[c].y;
+			meshCentroid.z += clusterCentroids[c].z;
+			meshArea += clusterArea * 3.0f;
+
+			float inverseArea = clusterArea > 0.0f ? 1.0f / (clusterArea * 3.0f) : 0.0f;
+			clusterCentroids[c] = Vector3(clusterCentroids[c].x * inverseArea, clusterCentroids[c].y * inverseArea, clusterCentroids[c].z * inverseArea);
+		}
+
+		if (meshArea > 0.0f)
+			meshCentroid = Vector3(meshCentroid.x / meshArea, meshCentroid.y / meshArea, meshCentroid.z / meshArea);
+
+		// Clusters facing away from the center are likely to occlude the others, draw them first.
+		for (size_t c = 0; c < clusters.size(); c++)
+		{
+			float length = clusterNormals[c].Magnitude();
+			Vector3 toCluster = Vector3(clusterCentroids[c].x - meshCentroid.x, clusterCentroids[c].y - meshCentroid.y, clusterCentroids[c].z - meshCentroid.z);
+			clusters[c].m_sortKey = length > 0.0f ? toCluster.Dot(clusterNormals[c]) / length : 0.0f;
+		}
+
+		std::stable_sort(clusters.begin(), clusters.end(), [](const TriangleCluster& lhs, const TriangleCluster& rhs) { return lhs.m_sortKey > rhs.m_sortKey; });
+
+		std::vector<uint32> output;
+		output.reserve(indices.size());
+		for (const TriangleCluster& cluster : clusters)
+			output.insert(output.end(), indices.begin() + cluster.m_start * 3, indices.begin() + cluster.m_end * 3);
+
+		indices.swap(output);
+	}
+
+	void MeshOptimizer::OptimizeVertexFetch(IndexedModel& model)
+	{
+		std::vector<std::vector<float>>& elements = model.GetElements();
+		std::vector<uint32>& indices = model.GetIndices();
+		const std::vector<uint32>& elementSizes = model.GetElementSizes();
+		const uint32 vertexCount = (uint32)(elements[0].size() / 3);
+		const uint32 vertexElementCount = model.GetStartIndex() == (uint32)-1 ? (uint32)elements.size() : model.GetStartIndex();
+
+		// New index of each vertex in the order of first use, unused vertices are dropped.
+		std::vector<uint32> remap(vertexCount, (uint32)-1);
+		uint32 usedVertices = 0;
+		for (uint32& index : indices)
+		{
+			if (remap[index] == (uint32)-1)
+				remap[index] = usedVertices++;
+
+			index = remap[index];
+		}
+
+		for (uint32 e = 0; e < vertexElementCount; e++)
+		{
+			const uint32 size = elementSizes[e];
+			if (elements[e].size() < (size_t)vertexCount * size) continue;
+
+			std::vector<float> reordered(usedVertices * size);
+			for (uint32 v = 0; v < vertexCount; v++)
+			{
+				if (remap[v] != (uint32)-1)
+					std::copy(elements[e].begin() + v * size, elements[e].begin() + (v + 1) * size, reordered.begin() + remap[v] * size);
+			}
+
+			elements[e].swap(reordered);
+		}
+	}
+
+	void MeshOptimizer::AnalyzeVertexCache(const std::vector<uint32>& indices, uint32 vertexCount, float& acmr, float& atvr)
+	{
+		std::vector<uint32> timestamps(vertexCount, 0);
+		std::vector<bool> referenced(vertexCount, false);
+		uint32 time = MESHOPT_ANALYZECACHESIZE + 1;
+		uint32 misses = 0;
+		uint32 uniqueVertices = 0;
+
+		for (uint32 index : indices)
+		{
+			if (!referenced[index])
+			{
+				referenced[index] = true;
+				uniqueVertices++;
+			}
+
+			if (time - timestamps[index] > MESHOPT_ANALYZECACHESIZE)
+			{
+				timestamps[index] = time++;
+				misses++;
+			}
+		}
+
+		acmr = indices.size() >= 3 ? (float)misses / (float)(indices.size() / 3) : 0.0f;
+		atvr = uniqueVertices > 0 ? (float)misses / (float)uniqueVertices : 0.0f;
+	}
+}
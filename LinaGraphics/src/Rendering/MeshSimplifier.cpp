@@ -0,0 +1,303 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Rendering/MeshSimplifier.hpp"
+#include "Utility/Math/Math.hpp"
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+namespace LinaEngine::Graphics
+{
+	// Symmetric 4x4 error quadric, a2 ab ac ad b2 bc bd c2 cd d2.
+	struct Quadric
+	{
+		double m[10] = { 0.0 };
+	};
+
+	struct Collapse
+	{
+		double m_cost = 0.0;
+		uint32 m_from = 0;
+		uint32 m_to = 0;
+	};
+
+	static void AddPlane(Quadric& q, double a, double b, double c, double d, double weight)
+	{
+		q.m[0] += weight * a * a; q.m[1] += weight * a * b; q.m[2] += weight * a * c; q.m[3] += weight * a * d;
+		q.m[4] += weight * b * b; q.m[5] += weight * b * c; q.m[6] += weight * b * d;
+		q.m[7] += weight * c * c; q.m[8] += weight * c * d;
+		q.m[9] += weight * d * d;
+	}
+
+	static double EvaluateQuadric(const Quadric& q, double x, double y, double z)
+	{
+		return q.m[0] * x * x + 2.0 * q.m[1] * x * y + 2.0 * q.m[2] * x * z + 2.0 * q.m[3] * x
+			+ q.m[4] * y * y + 2.0 * q.m[5] * y * z + 2.0 * q.m[6] * y
+			+ q.m[7] * z * z + 2.0 * q.m[8] * z
+			+ q.m[9];
+	}
+
+	static Vector3 GetPosition(const std::vector<float>& positions, uint32 vertex)
+	{
+		return Vector3(positions[vertex * 3], positions[vertex * 3 + 1], positions[vertex * 3 + 2]);
+	}
+
+	static Vector3 TriangleNormal(Vector3 p0, Vector3 p1, Vector3 p2)
+	{
+		return (p1 - p0).Cross(p2 - p0);
+	}
+
+	float MeshSimplifier::Simplify(const IndexedModel& source, IndexedModel& target, uint32 targetIndexCount)
+	{
+		target = source;
+
+		const std::vector<std::vector<float>>& sourceElements = source.GetElements();
+		const std::vector<uint32>& elementSizes = source.GetElementSizes();
+		if (sourceElements.size() == 0 || elementSizes[0] != 3 || source.GetIndexCount() <= targetIndexCount) return 0.0f;
+
+		const std::vector<float>& positions = sourceElements[0];
+		const uint32 vertexCount = (uint32)(positions.size() / 3);
+		const uint32 vertexElementCount = source.GetStartIndex() == (uint32)-1 ? (uint32)sourceElements.size() : source.GetStartIndex();
+		std::vector<uint32> indices = source.GetIndices();
+
+		// Weld the vertices w/ identical attributes, imported meshes are not joined unless optimized.
+		std::map<std::vector<float>, uint32> attributeVertices;
+		std::vector<uint32> weldRemap(vertexCount);
+		for (uint32 i = 0; i < vertexCount; i++)
+		{
+			std::vector<float> key;
+			for (uint32 e = 0; e < vertexElementCount; e++)
+				key.insert(key.end(), sourceElements[e].begin() + i * elementSizes[e], sourceElements[e].begin() + (i + 1) * elementSizes[e]);
+
+			weldRemap[i] = attributeVertices.emplace(key, i).first->second;
+		}
+
+		for (uint32& index : indices)
+			index = weldRemap[index];
+
+		// Topology is built on positions, the first referenced vertex at each position stands for all vertices there.
+		std::vector<uint32> positionVertex(vertexCount);
+		std::vector<bool> referenced(vertexCount, false);
+		std::map<std::tuple<float, float, float>, uint32> positionVertices;
+		for (uint32 index : indices)
+			referenced[index] = true;
+
+		for (uint32 i = 0; i < vertexCount; i++)
+		{
+			std::tuple<float, float, float> key = std::make_tuple(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
+			positionVertex[i] = referenced[i] ? positionVertices.emplace(key, i).first->second : i;
+		}
+
+		// Lock the vertices sharing a position w/ another after welding, those are attribute seams.
+		std::vector<bool> locked(vertexCount, false);
+		for (uint32 i = 0; i < vertexCount; i++)
+		{
+			if (referenced[i] && positionVertex[i] != i)
+			{
+				locked[i] = true;
+				locked[positionVertex[i]] = true;
+			}
+		}
+
+		// Lock the vertices of edges used by a single triangle, those are open borders. Seam edges are shared through their positions.
+		std::unordered_map<uint64, int> edgeCounts;
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			for (int e = 0; e < 3; e++)
+			{
+				uint32 a = positionVertex[indices[i + e]];
+				uint32 b = positionVertex[indices[i + (e + 1) % 3]];
+				edgeCounts[((uint64)Math::Min(a, b) << 32) | (uint64)Math::Max(a, b)]++;
+			}
+		}
+
+		std::vector<bool> borderPositions(vertexCount, false);
+		for (std::unordered_map<uint64, int>::iterator it = edgeCounts.begin(); it != edgeCounts.end(); ++it)
+		{
+			if (it->second == 1)
+			{
+				borderPositions[(uint32)(it->first >> 32)] = true;
+				borderPositions[(uint32)(it->first & 0xFFFFFFFF)] = true;
+			}
+		}
+
+		for (uint32 i = 0; i < vertexCount; i++)
+		{
+			if (borderPositions[positionVertex[i]])
+				locked[i] = true;
+		}
+
+		// Accumulate the area weighted planes of the triangles around each vertex.
+		std::vector<Quadric> quadrics(vertexCount);
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			Vector3 p0 = GetPosition(positions, indices[i]);
+			Vector3 normal = TriangleNormal(p0, GetPosition(positions, indices[i + 1]), GetPosition(positions, indices[i + 2]));
+			float length = normal.Magnitude();
+			if (length <= 0.0f) continue;
+
+			normal = Vector3(normal.x / length, normal.y / length, normal.z / length);
+			double d = -(double)normal.Dot(p0);
+			for (int v = 0; v < 3; v++)
+				AddPlane(quadrics[indices[i + v]], normal.x, normal.y, normal.z, d, length * 0.5);
+		}
+
+		float maxError = 0.0f;
+		std::vector<uint32> remap(vertexCount);
+		std::vector<bool> touched(vertexCount);
+		std::vector<std::vector<uint32>> vertexTriangles(vertexCount);
+		std::vector<Collapse> collapses;
+
+		while (indices.size() > targetIndexCount)
+		{
+			for (uint32 i = 0; i < vertexCount; i++)
+			{
+				remap[i] = i;
+				touched[i] = false;
+				vertexTriangles[i].clear();
+			}
+
+			// Every edge can collapse either way, unless the vertex moving is locked.
+			collapses.clear();
+			for (size_t i = 0; i + 2 < indices.size(); i += 3)
+			{
+				for (int e = 0; e < 3; e++)
+				{
+					uint32 a = indices[i + e];
+					uint32 b = indices[i + (e + 1) % 3];
+					vertexTriangles[a].push_back((uint32)i);
+
+					Quadric combined = quadrics[a];
+					for (int k = 0; k < 10; k++)
+						combined.m[k] += quadrics[b].m[k];
+
+					if (!locked[a])
+						collapses.push_back({ EvaluateQuadric(combined, positions[b * 3], positions[b * 3 + 1], positions[b * 3 + 2]), a, b });
+
+					if (!locked[b])
+						collapses.push_back({ EvaluateQuadric(combined, positions[a * 3], positions[a * 3 + 1], positions[a * 3 + 2]), b, a });
+				}
+			}
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) { return lhs.m_cost < rhs.m_cost; });
+
+			// Collapse the cheapest edges, a vertex is only involved in a single collapse per pass.
+			size_t trianglesToRemove = (indices.size() - targetIndexCount) / 3;
+			size_t trianglesRemoved = 0;
+			for (const Collapse& collapse : collapses)
+			{
+				if (trianglesRemoved >= trianglesToRemove) break;
+				if (touched[collapse.m_from] || touched[collapse.m_to]) continue;
+
+				// Moving the vertex should not flip any of the remaining triangles around it.
+				Vector3 toPosition = GetPosition(positions, collapse.m_to);
+				size_t removed = 0;
+				bool flips = false;
+				for (uint32 triangle : vertexTriangles[collapse.m_from])
+				{
+					uint32 i0 = indices[triangle], i1 = indices[triangle + 1], i2 = indices[triangle + 2];
+					if (i0 == collapse.m_to || i1 == collapse.m_to || i2 == collapse.m_to)
+					{
+						removed++;
+						continue;
+					}
+
+					Vector3 p0 = GetPosition(positions, i0), p1 = GetPosition(positions, i1), p2 = GetPosition(positions, i2);
+					Vector3 before = TriangleNormal(p0, p1, p2);
+					Vector3 after = TriangleNormal(i0 == collapse.m_from ? toPosition : p0, i1 == collapse.m_from ? toPosition : p1, i2 == collapse.m_from ? toPosition : p2);
+					if (before.Dot(after) <= 0.0f)
+					{
+						flips = true;
+						break;
+					}
+				}
+
+				if (flips) continue;
+
+				remap[collapse.m_from] = collapse.m_to;
+				for (int k = 0; k < 10; k++)
+					quadrics[collapse.m_to].m[k] += quadrics[collapse.m_from].m[k];
+
+				// Triangles around the collapsed vertex changed, keep their vertices out of this pass.
+				for (uint32 triangle : vertexTriangles[collapse.m_from])
+				{
+					touched[indices[triangle]] = true;
+					touched[indices[triangle + 1]] = true;
+					touched[indices[triangle + 2]] = true;
+				}
+
+				trianglesRemoved += removed;
+				maxError = Math::Max(maxError, (float)collapse.m_cost);
+			}
+
+			if (trianglesRemoved == 0) break;
+
+			// Rewrite the triangles & drop the degenerate ones.
+			size_t writeIndex = 0;
+			for (size_t i = 0; i + 2 < indices.size(); i += 3)
+			{
+				uint32 i0 = remap[indices[i]], i1 = remap[indices[i + 1]], i2 = remap[indices[i + 2]];
+				if (i0 == i1 || i1 == i2 || i0 == i2) continue;
+
+				indices[writeIndex++] = i0;
+				indices[writeIndex++] = i1;
+				indices[writeIndex++] = i2;
+			}
+
+			indices.resize(writeIndex);
+		}
+
+		// Compact the vertices still in use, in the order they are referenced.
+		std::vector<std::vector<float>>& targetElements = target.GetElements();
+		std::vector<uint32> newIndices(vertexCount, (uint32)-1);
+		for (uint32 e = 0; e < vertexElementCount; e++)
+			targetElements[e].clear();
+
+		uint32 usedVertices = 0;
+		for (uint32& index : indices)
+		{
+			if (newIndices[index] == (uint32)-1)
+			{
+				newIndices[index] = usedVertices++;
+				for (uint32 e = 0; e < vertexElementCount; e++)
+				{
+					const uint32 size = elementSizes[e];
+					targetElements[e].insert(targetElements[e].end(), sourceElements[e].begin() + index * size, sourceElements[e].begin() + (index + 1) * size);
+				}
+			}
+
+			index = newIndices[index];
+		}
+
+		target.GetIndices() = indices;
+		return maxError;
+	}
+}
@@ -47,6 +47,9 @@ namespace LinaEngine::Graphics
 		if (meshParams.m_smoothNormals)
 			importFlags |= aiProcess_GenSmoothNormals;
 
+		if (meshParams.m_optimizeMesh)
+			importFlags |= aiProcess_JoinIdenticalVertices;
+
 		const aiScene* scene = importer.ReadFile(fileName.c_str(), importFlags);
 		// | aiProcess_FlipUVs
 
@@ -73,8 +76,8 @@ namespace LinaEngine::Graphics
 			//currentModel.AllocateElement(3, false); // Joint IDs
 			//currentModel.AllocateElement(3, true); // Weights
 			currentModel.SetStartIndex(5); // Begin instanced data
-			currentModel.AllocateElement(16, true); // Model Matrix
-			currentModel.AllocateElement(16, true); // Inverse transpose matrix
+			currentModel.AllocateElement(12, true); // Affine model matrix rows
+			currentModel.SetInterleaved(true, meshParams.m_quantizePositions);
 
 			const aiVector3D aiZeroVector(0.0f, 0.0f, 0.0f);
 
@@ -157,8 +160,8 @@ namespace LinaEngine::Graphics
 			currentModel.AllocateElement(3, true); // Tangents
 			currentModel.AllocateElement(3, true); // Bitangents
 			currentModel.SetStartIndex(5); // Begin instanced data
-			currentModel.AllocateElement(16, true); // Model Matrix
-			currentModel.AllocateElement(16, true); // Inverse transpose matrix
+			currentModel.AllocateElement(12, true); // Affine model matrix rows
+			currentModel.SetInterleaved(true, false);
 
 
 			const aiVector3D aiZeroVector(0.0f, 0.0f, 0.0f);
@@ -220,8 +223,7 @@ namespace LinaEngine::Graphics
 		currentModel.AllocateElement(3, true); // Positions
 		currentModel.AllocateElement(2, true); // TexCoords
 		currentModel.SetStartIndex(2); // Begin instanced data
-		currentModel.AllocateElement(16, true); // Model Matrix
-		currentModel.AllocateElement(16, true); // Inverse transpose matrix
+		currentModel.AllocateElement(12, true); // Affine model matrix rows
 
 		Vector3 vertices[] = {
 			Vector3(-0.5f, 0.5f, 0.0f),  // left top, id 0
@@ -269,8 +271,8 @@ namespace LinaEngine::Graphics
 		currentModel.AllocateElement(3, true); // Normals
 		currentModel.AllocateElement(3, true); // Tangents
 		currentModel.SetStartIndex(4); // Begin instanced data
-		currentModel.AllocateElement(16, true); // Model Matrix
-		currentModel.AllocateElement(16, true); // Inverse transpose matrix
+		currentModel.AllocateElement(12, true); // Affine model matrix rows
+		currentModel.SetInterleaved(true, false);
 
 
 		const aiVector3D aiZeroVector(0.0f, 0.0f, 0.0f);
@@ -0,0 +1,367 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Rendering/OcclusionCuller.hpp"
+#include "Utility/Math/Math.hpp"
+#include <emmintrin.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace LinaEngine::Graphics
+{
+	void OcclusionCuller::Construct()
+	{
+		if (m_workers.size() > 0) return;
+
+		// Full resolution level & the max depth levels down to a single texel.
+		m_depthLevels.clear();
+		uint32 width = OCCLUSION_BUFFERWIDTH;
+		uint32 height = OCCLUSION_BUFFERHEIGHT;
+		m_depthLevels.push_back(std::vector<float>(width * height, 1.0f));
+		while (width > 1 || height > 1)
+		{
+			width = Math::Max(width / 2, 1u);
+			height = Math::Max(height / 2, 1u);
+			m_depthLevels.push_back(std::vector<float>(width * height, 1.0f));
+		}
+
+		m_exit = false;
+		for (uint32 i = 0; i < OCCLUSION_WORKERCOUNT; i++)
+			m_workers.push_back(std::thread(&OcclusionCuller::WorkerLoop, this, i));
+	}
+
+	void OcclusionCuller::Release()
+	{
+		if (m_workers.size() == 0) return;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_exit = true;
+		}
+
+		m_workCondition.notify_all();
+		for (std::thread& worker : m_workers)
+			worker.join();
+
+		m_workers.clear();
+	}
+
+	void OcclusionCuller::Begin(const RenderView& view)
+	{
+		m_viewProjection = view.m_projection * view.m_view;
+		m_hasOccluders = false;
+		m_triangles.clear();
+		m_stats = OcclusionStats();
+	}
+
+	void OcclusionCuller::AddOccluder(const OccluderGeometry& geometry, const Matrix& model)
+	{
+		const std::vector<float>& positions = geometry.m_positions;
+		const std::vector<uint32>& indices = geometry.m_indices;
+		Matrix modelViewProjection = m_viewProjection * model;
+
+		m_clipPositions.resize(positions.size() / 3);
+		for (size_t i = 0; i < m_clipPositions.size(); i++)
+			m_clipPositions[i] = modelViewProjection * Vector4(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2], 1.0f);
+
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			const Vector4* corners[3] = { &m_clipPositions[indices[i]], &m_clipPositions[indices[i + 1]], &m_clipPositions[indices[i + 2]] };
+
+			// Skip the triangles completely outside one of the side planes.
+			bool outside = corners[0]->x > corners[0]->w && corners[1]->x > corners[1]->w && corners[2]->x > corners[2]->w;
+			outside |= corners[0]->x < -corners[0]->w && corners[1]->x < -corners[1]->w && corners[2]->x < -corners[2]->w;
+			outside |= corners[0]->y > corners[0]->w && corners[1]->y > corners[1]->w && corners[2]->y > corners[2]->w;
+			outside |= corners[0]->y < -corners[0]->w && corners[1]->y < -corners[1]->w && corners[2]->y < -corners[2]->w;
+
+			if (outside) continue;
+
+			// Distances to the near plane, triangles crossing it are clipped into a polygon of up to 4 corners.
+			float distances[3] = { corners[0]->z + corners[0]->w, corners[1]->z + corners[1]->w, corners[2]->z + corners[2]->w };
+			if (distances[0] >= 0.0f && distances[1] >= 0.0f && distances[2] >= 0.0f)
+			{
+				AddClippedTriangle(*corners[0], *corners[1], *corners[2]);
+				continue;
+			}
+
+			Vector4 polygon[4];
+			int polygonSize = 0;
+			for (int j = 0; j < 3; j++)
+			{
+				int next = (j + 1) % 3;
+				if (distances[j] >= 0.0f)
+					polygon[polygonSize++] = *corners[j];
+
+				if ((distances[j] >= 0.0f) != (distances[next] >= 0.0f))
+				{
+					float t = distances[j] / (distances[j] - distances[next]);
+					const Vector4& a = *corners[j];
+					const Vector4& b = *corners[next];
+					polygon[polygonSize++] = Vector4(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t);
+				}
+			}
+
+			for (int j = 2; j < polygonSize; j++)
+				AddClippedTriangle(polygon[0], polygon[j - 1], polygon[j]);
+		}
+	}
+
+	void OcclusionCuller::AddClippedTriangle(const Vector4& v0, const Vector4& v1, const Vector4& v2)
+	{
+		const Vector4* corners[3] = { &v0, &v1, &v2 };
+		for (int i = 0; i < 3; i++)
+		{
+			// Corners on the near plane still have a tiny positive w for perspective projections.
+			float inverseW = 1.0f / Math::Max(corners[i]->w, 0.000001f);
+			m_triangles.push_back((corners[i]->x * inverseW * 0.5f + 0.5f) * OCCLUSION_BUFFERWIDTH);
+			m_triangles.push_back((corners[i]->y * inverseW * 0.5f + 0.5f) * OCCLUSION_BUFFERHEIGHT);
+			m_triangles.push_back(Math::Max(corners[i]->z * inverseW * 0.5f + 0.5f, 0.0f));
+		}
+
+		m_hasOccluders = true;
+		m_stats.m_occluderTriangles++;
+	}
+
+	void OcclusionCuller::End()
+	{
+		if (m_workers.size() == 0) return;
+
+		// Workers clear their bands even w/o occluders, the buffer must not keep the last frame's depths.
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_pendingWorkers = (uint32)m_workers.size();
+			m_generation++;
+		}
+
+		m_workCondition.notify_all();
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_doneCondition.wait(lock, [this] { return m_pendingWorkers == 0; });
+		}
+
+		if (m_hasOccluders)
+			BuildHierarchy();
+	}
+
+	void OcclusionCuller::WorkerLoop(uint32 band)
+	{
+		uint32 generation = 0;
+
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_workCondition.wait(lock, [this, generation] { return m_exit || m_generation != generation; });
+				if (m_exit) return;
+				generation = m_generation;
+			}
+
+			RasterizeBand(band);
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (--m_pendingWorkers == 0)
+					m_doneCondition.notify_one();
+			}
+		}
+	}
+
+	void OcclusionCuller::RasterizeBand(uint32 band)
+	{
+		const int bandHeight = OCCLUSION_BUFFERHEIGHT / OCCLUSION_WORKERCOUNT;
+		const int bandStart = band * bandHeight;
+		const int bandEnd = band == OCCLUSION_WORKERCOUNT - 1 ? OCCLUSION_BUFFERHEIGHT : bandStart + bandHeight;
+
+		std::vector<float>& depth = m_depthLevels[0];
+		std::fill(depth.begin() + bandStart * OCCLUSION_BUFFERWIDTH, depth.begin() + bandEnd * OCCLUSION_BUFFERWIDTH, 1.0f);
+
+		const __m128 pixelOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+		const __m128 zero = _mm_setzero_ps();
+
+		for (size_t i = 0; i + 8 < m_triangles.size(); i += 9)
+		{
+			const float* v0 = &m_triangles[i];
+			const float* v1 = &m_triangles[i + 3];
+			const float* v2 = &m_triangles[i + 6];
+
+			// Occluders are rasterized double sided, clockwise triangles are flipped.
+			float area = (v1[0] - v0[0]) * (v2[1] - v0[1]) - (v1[1] - v0[1]) * (v2[0] - v0[0]);
+			if (area == 0.0f) continue;
+			if (area < 0.0f)
+			{
+				std::swap(v1, v2);
+				area = -area;
+			}
+
+			int minX = Math::Max((int)std::floor(Math::Min(v0[0], Math::Min(v1[0], v2[0]))), 0);
+			int maxX = Math::Min((int)std::ceil(Math::Max(v0[0], Math::Max(v1[0], v2[0]))), OCCLUSION_BUFFERWIDTH - 1);
+			int minY = Math::Max((int)std::floor(Math::Min(v0[1], Math::Min(v1[1], v2[1]))), bandStart);
+			int maxY = Math::Min((int)std::ceil(Math::Max(v0[1], Math::Max(v1[1], v2[1]))), bandEnd - 1);
+			if (minX > maxX || minY > maxY) continue;
+
+			// Edge functions, positive inside. Each one is the weight of the opposite corner scaled by the area.
+			const float* corners[3] = { v0, v1, v2 };
+			float edgeA[3], edgeB[3], edgeC[3];
+			for (int e = 0; e < 3; e++)
+			{
+				const float* a = corners[(e + 1) % 3];
+				const float* b = corners[(e + 2) % 3];
+				edgeA[e] = a[1] - b[1];
+				edgeB[e] = b[0] - a[0];
+				edgeC[e] = a[0] * b[1] - a[1] * b[0];
+			}
+
+			// Depth is linear in screen space.
+			float inverseArea = 1.0f / area;
+			float depthA = (edgeA[0] * v0[2] + edgeA[1] * v1[2] + edgeA[2] * v2[2]) * inverseArea;
+			float depthB = (edgeB[0] * v0[2] + edgeB[1] * v1[2] + edgeB[2] * v2[2]) * inverseArea;
+			float depthC = (edgeC[0] * v0[2] + edgeC[1] * v1[2] + edgeC[2] * v2[2]) * inverseArea;
+
+			const __m128 a0 = _mm_set1_ps(edgeA[0]), a1 = _mm_set1_ps(edgeA[1]), a2 = _mm_set1_ps(edgeA[2]);
+			const __m128 dA = _mm_set1_ps(depthA);
+
+			// Rows are walked in aligned groups of 4 pixels.
+			int startX = minX & ~3;
+			for (int y = minY; y <= maxY; y++)
+			{
+				float pixelY = (float)y + 0.5f;
+				__m128 row0 = _mm_set1_ps(edgeB[0] * pixelY + edgeC[0]);
+				__m128 row1 = _mm_set1_ps(edgeB[1] * pixelY + edgeC[1]);
+				__m128 row2 = _mm_set1_ps(edgeB[2] * pixelY + edgeC[2]);
+				__m128 rowDepth = _mm_set1_ps(depthB * pixelY + depthC);
+				float* target = &depth[y * OCCLUSION_BUFFERWIDTH];
+
+				for (int x = startX; x <= maxX; x += 4)
+				{
+					__m128 pixelX = _mm_add_ps(_mm_set1_ps((float)x), pixelOffsets);
+					__m128 w0 = _mm_add_ps(_mm_mul_ps(a0, pixelX), row0);
+					__m128 w1 = _mm_add_ps(_mm_mul_ps(a1, pixelX), row1);
+					__m128 w2 = _mm_add_ps(_mm_mul_ps(a2, pixelX), row2);
+					__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(w0, zero), _mm_cmpge_ps(w1, zero)), _mm_cmpge_ps(w2, zero));
+					if (_mm_movemask_ps(inside) == 0) continue;
+
+					__m128 current = _mm_loadu_ps(target + x);
+					__m128 nearest = _mm_min_ps(current, _mm_add_ps(_mm_mul_ps(dA, pixelX), rowDepth));
+					_mm_storeu_ps(target + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+				}
+			}
+		}
+	}
+
+	void OcclusionCuller::BuildHierarchy()
+	{
+		uint32 width = OCCLUSION_BUFFERWIDTH;
+		uint32 height = OCCLUSION_BUFFERHEIGHT;
+
+		// Each texel keeps the furthest of the nearest occluder depths below it.
+		for (size_t level = 1; level < m_depthLevels.size(); level++)
+		{
+			const std::vector<float>& source = m_depthLevels[level - 1];
+			std::vector<float>& target = m_depthLevels[level];
+			uint32 levelWidth = Math::Max(width / 2, 1u);
+			uint32 levelHeight = Math::Max(height / 2, 1u);
+
+			for (uint32 y = 0; y < levelHeight; y++)
+			{
+				uint32 y0 = Math::Min(y * 2, height - 1);
+				uint32 y1 = Math::Min(y * 2 + 1, height - 1);
+				for (uint32 x = 0; x < levelWidth; x++)
+				{
+					uint32 x0 = Math::Min(x * 2, width - 1);
+					uint32 x1 = Math::Min(x * 2 + 1, width - 1);
+					target[y * levelWidth + x] = Math::Max(Math::Max(source[y0 * width + x0], source[y0 * width + x1]), Math::Max(source[y1 * width + x0], source[y1 * width + x1]));
+				}
+			}
+
+			width = levelWidth;
+			height = levelHeight;
+		}
+	}
+
+	bool OcclusionCuller::IsOccluded(const Vector3& center, float radius)
+	{
+		return IsOccluded(Vector3(center.x - radius, center.y - radius, center.z - radius), Vector3(center.x + radius, center.y + radius, center.z + radius));
+	}
+
+	bool OcclusionCuller::IsOccluded(const Vector3& boundsMin, const Vector3& boundsMax)
+	{
+		if (!m_hasOccluders) return false;
+		m_stats.m_testedBounds++;
+
+		// Screen rectangle & nearest depth of the box.
+		float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX, minDepth = FLT_MAX;
+		for (int i = 0; i < 8; i++)
+		{
+			Vector4 corner = Vector4(i & 1 ? boundsMax.x : boundsMin.x, i & 2 ? boundsMax.y : boundsMin.y, i & 4 ? boundsMax.z : boundsMin.z, 1.0f);
+			Vector4 clip = m_viewProjection * corner;
+
+			// Boxes crossing the near plane are kept.
+			if (clip.w <= 0.000001f || clip.z < -clip.w) return false;
+
+			float inverseW = 1.0f / clip.w;
+			float x = (clip.x * inverseW * 0.5f + 0.5f) * OCCLUSION_BUFFERWIDTH;
+			float y = (clip.y * inverseW * 0.5f + 0.5f) * OCCLUSION_BUFFERHEIGHT;
+			minX = Math::Min(minX, x);
+			maxX = Math::Max(maxX, x);
+			minY = Math::Min(minY, y);
+			maxY = Math::Max(maxY, y);
+			minDepth = Math::Min(minDepth, clip.z * inverseW * 0.5f + 0.5f);
+		}
+
+		// Off screen boxes are left to the frustum culling.
+		if (maxX < 0.0f || maxY < 0.0f || minX >= OCCLUSION_BUFFERWIDTH || minY >= OCCLUSION_BUFFERHEIGHT) return false;
+
+		int x0 = Math::Max((int)minX, 0);
+		int y0 = Math::Max((int)minY, 0);
+		int x1 = Math::Min((int)maxX, OCCLUSION_BUFFERWIDTH - 1);
+		int y1 = Math::Min((int)maxY, OCCLUSION_BUFFERHEIGHT - 1);
+
+		// Test on the level where the rectangle covers at most 2x2 texels.
+		uint32 level = 0;
+		while (level + 1 < m_depthLevels.size() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1))
+			level++;
+
+		const std::vector<float>& depths = m_depthLevels[level];
+		int levelWidth = Math::Max(OCCLUSION_BUFFERWIDTH >> level, 1);
+		int levelHeight = Math::Max(OCCLUSION_BUFFERHEIGHT >> level, 1);
+		for (int y = y0 >> level; y <= Math::Min(y1 >> level, levelHeight - 1); y++)
+		{
+			for (int x = x0 >> level; x <= Math::Min(x1 >> level, levelWidth - 1); x++)
+			{
+				if (depths[y * levelWidth + x] >= minDepth)
+					return false;
+			}
+		}
+
+		m_stats.m_occludedBounds++;
+		return true;
+	}
+}
@@ -32,6 +32,7 @@ SOFTWARE.
 #include "Rendering/RenderConstants.hpp"
 #include "Rendering/Shader.hpp"
 #include "Rendering/ArrayBitmap.hpp"
+#include "Rendering/HDRICache.hpp"
 #include "ECS/Components/CameraComponent.hpp"
 #include "ECS/ECS.hpp"
 #include "Utility/UtilityFunctions.hpp"
@@ -40,6 +41,8 @@ SOFTWARE.
 #include "PackageManager/OpenGL/GLRenderDevice.hpp"
 #include "Helpers/DrawParameterHelper.hpp"
 #include "Core/Timer.hpp"
+#include "PackageManager/Generic/GenericMemory.hpp"
+#include <glm/gtc/packing.hpp>
 
 namespace LinaEngine::Graphics
 {
@@ -51,7 +54,9 @@ namespace LinaEngine::Graphics
 	constexpr int UNIFORMBUFFER_VIEWDATA_BINDPOINT = 0;
 	constexpr auto UNIFORMBUFFER_VIEWDATA_NAME = "ViewData";
 
-	constexpr size_t UNIFORMBUFFER_LIGHTDATA_SIZE = (sizeof(int) * 2) + sizeof(Vector4) + sizeof(Vector4);
+	// std140 aligns the vec4 members to 16 bytes, after the two light counts. Irradiance SH coefficients are padded to vec4s.
+	constexpr size_t UNIFORMBUFFER_LIGHTDATA_SIZE = (sizeof(int) * 4) + sizeof(Vector4) + sizeof(Vector4) + sizeof(Vector4) * SH_COEFFICIENTCOUNT;
+	constexpr size_t UNIFORMBUFFER_LIGHTDATA_SHOFFSET = (sizeof(int) * 4) + sizeof(Vector4) + sizeof(Vector4);
 	constexpr int UNIFORMBUFFER_LIGHTDATA_BINDPOINT = 1;
 	constexpr auto UNIFORMBUFFER_LIGHTDATA_NAME = "LightData";
 
@@ -59,6 +64,36 @@ namespace LinaEngine::Graphics
 	constexpr int UNIFORMBUFFER_DEBUGDATA_BINDPOINT = 2;
 	constexpr auto UNIFORMBUFFER_DEBUGDATA_NAME = "DebugData";
 
+	constexpr int UNIFORMBUFFER_MATERIALDATA_BINDPOINT = 3;
+	constexpr auto UNIFORMBUFFER_MATERIALDATA_NAME = MAT_BLOCKNAME;
+
+	// Pass types of the bloom shader.
+	constexpr int BLOOMPASS_PREFILTER = 0;
+	constexpr int BLOOMPASS_DOWNSAMPLE = 1;
+	constexpr int BLOOMPASS_UPSAMPLE = 2;
+
+	// Frames the viewport size has to stay the same before the render targets are reallocated.
+	constexpr int RENDERTARGET_RESIZE_STABLEFRAMES = 4;
+
+	constexpr size_t UNIFORMBUFFER_LIGHTARRAYDATA_SIZE = sizeof(ECS::LightArrayData);
+	constexpr int UNIFORMBUFFER_LIGHTARRAYDATA_BINDPOINT = 4;
+	constexpr auto UNIFORMBUFFER_LIGHTARRAYDATA_NAME = "LightArrayData";
+
+	// Clustered light buffers live on the last texture units, out of the way of material samplers.
+	constexpr int TEXTUREBUFFER_LIGHTDATA_UNIT = 13;
+	constexpr auto TEXTUREBUFFER_LIGHTDATA_NAME = "lightDataBuffer";
+	constexpr int TEXTUREBUFFER_LIGHTGRID_UNIT = 14;
+	constexpr auto TEXTUREBUFFER_LIGHTGRID_NAME = "lightGridBuffer";
+	constexpr int TEXTUREBUFFER_LIGHTINDEX_UNIT = 15;
+	constexpr auto TEXTUREBUFFER_LIGHTINDEX_NAME = "lightIndexBuffer";
+
+	// Copies a parameter into the std140 material block.
+	static void WriteMaterialBlock(std::vector<uint8>& block, int32 offset, const void* data, size_t size)
+	{
+		if (offset < 0 || offset + size > block.size()) return;
+		GenericMemory::memcpy(&block[offset], data, size);
+	}
+
 	RenderEngine::RenderEngine()
 	{
 		LINA_CORE_TRACE("[Constructor] -> RenderEngine ({0})", typeid(*this).name());
@@ -75,6 +110,21 @@ namespace LinaEngine::Graphics
 		m_hdriCubeVAO = s_renderDevice.ReleaseVertexArray(m_hdriCubeVAO);
 		m_lineVAO = s_renderDevice.ReleaseVertexArray(m_lineVAO);
 
+		// Release GPU timer queries.
+		m_gpuTimer.Release();
+
+		// Release pooled render targets.
+		m_renderTargetPool.Clear();
+
+		// Release static batches.
+		m_staticBatcher.Clear();
+
+		// Stop the occlusion workers.
+		m_occlusionCuller.Release();
+
+		// Release the sprite atlas & its buffers.
+		m_spriteBatcher.Release();
+
 		LINA_CORE_TRACE("[Destructor] -> RenderEngine ({0})", typeid(*this).name());
 	}
 
@@ -114,12 +164,30 @@ namespace LinaEngine::Graphics
 		// Construct the uniform buffer for lights.
 		m_globalLightBuffer.Construct(s_renderDevice, UNIFORMBUFFER_LIGHTDATA_SIZE, BufferUsage::USAGE_DYNAMIC_DRAW, NULL);
 		m_globalLightBuffer.Bind(UNIFORMBUFFER_LIGHTDATA_BINDPOINT);
+		m_globalLightArrayBuffer.Construct(s_renderDevice, UNIFORMBUFFER_LIGHTARRAYDATA_SIZE, BufferUsage::USAGE_DYNAMIC_DRAW, NULL);
+		m_globalLightArrayBuffer.Bind(UNIFORMBUFFER_LIGHTARRAYDATA_BINDPOINT);
+
+		// Construct the texture buffers for clustered lights, they are resized every frame.
+		m_lightDataBuffer.Construct(s_renderDevice, PixelFormat::FORMAT_RGBA32F, sizeof(ECS::LightBufferData), BufferUsage::USAGE_STREAM_DRAW, NULL);
+		m_lightGridBuffer.Construct(s_renderDevice, PixelFormat::FORMAT_RG32UI, sizeof(uint32) * 2, BufferUsage::USAGE_STREAM_DRAW, NULL);
+		m_lightIndexBuffer.Construct(s_renderDevice, PixelFormat::FORMAT_R32UI, sizeof(uint32), BufferUsage::USAGE_STREAM_DRAW, NULL);
+
+		// Construct the timer queries for render passes.
+		m_gpuTimer.Construct(s_renderDevice);
+
+		// Transient render targets are created on demand.
+		m_renderTargetPool.Construct(s_renderDevice);
+		m_frameGraph.Construct(s_renderDevice, m_renderTargetPool, m_gpuTimer);
+		m_staticBatcher.Construct(s_renderDevice);
+		m_occlusionCuller.Construct();
+		m_spriteBatcher.Construct(s_renderDevice);
 
 		// Construct the uniform buffer for debugging.
 		m_globalDebugBuffer.Construct(s_renderDevice, UNIFORMBUFFER_DEBUGDATA_SIZE, BufferUsage::USAGE_DYNAMIC_DRAW, NULL);
 		m_globalDebugBuffer.Bind(UNIFORMBUFFER_DEBUGDATA_BINDPOINT);
 
-		// Initialize the engine shaders.
+		// Initialize the engine shaders, linked programs are reused between runs.
+		s_renderDevice.SetProgramBinaryCache(SC_PROGRAMCACHEPATH);
 		ConstructEngineShaders();
 
 		// Initialize engine materials
@@ -165,7 +233,11 @@ namespace LinaEngine::Graphics
 
 	void RenderEngine::Render()
 	{
-		// DrawShadows();
+		// Reallocate the render targets if the viewport settled on a new size.
+		UpdateRenderTargetSize();
+
+		// Gather the scene & update the per frame buffers once, every view drawn below builds its draw list from the same packets.
+		UpdateSystems();
 
 		if (m_preDrawCallback)
 			m_preDrawCallback();
@@ -181,6 +253,12 @@ namespace LinaEngine::Graphics
 			m_firstFrameDrawn = true;
 		}
 
+		// Collect the GPU pass timings of earlier frames.
+		m_gpuTimer.EndFrame();
+
+		// Drop the transient targets that are no longer requested.
+		m_renderTargetPool.EndFrame();
+
 		//DrawOperationsDefault();
 	}
 
@@ -199,6 +277,9 @@ namespace LinaEngine::Graphics
 	{
 		// Update window.
 		m_appWindow->Tick();
+
+		// Frame boundary for the device stats.
+		s_renderDevice.EndFrameStats();
 	}
 
 	void RenderEngine::SetViewportDisplay(Vector2 pos, Vector2 size)
@@ -209,16 +290,39 @@ namespace LinaEngine::Graphics
 
 		m_cameraSystem.SetAspectRatio((float)m_viewportSize.x / (float)m_viewportSize.y);
 
+		// Targets are resized once the size stops changing, before the first frame there is nothing to stretch.
+		// Before initialization only the size is recorded, targets are constructed with it.
+		m_renderTargetStableFrames = 0;
+		if (m_renderTargetsConstructed && !m_firstFrameDrawn)
+			ResizeRenderTargets(m_viewportSize);
+	}
+
+	void RenderEngine::UpdateRenderTargetSize()
+	{
+		if (m_renderTargetSize.x == m_viewportSize.x && m_renderTargetSize.y == m_viewportSize.y)
+			return;
+
+		// Until then the scene is drawn at the old size & stretched over the viewport.
+		if (++m_renderTargetStableFrames >= RENDERTARGET_RESIZE_STABLEFRAMES)
+			ResizeRenderTargets(m_viewportSize);
+	}
+
+	void RenderEngine::ResizeRenderTargets(const Vector2& size)
+	{
+		m_renderTargetSize = size;
+		m_renderTargetStableFrames = 0;
+
 		// Resize render buffers & frame buffer textures
-		s_renderDevice.ResizeRTTexture(m_primaryRTTexture0.GetID(), m_viewportSize, m_primaryRTParams.m_textureParams.m_internalPixelFormat, m_primaryRTParams.m_textureParams.m_pixelFormat);
-		s_renderDevice.ResizeRTTexture(m_primaryRTTexture1.GetID(), m_viewportSize, m_primaryRTParams.m_textureParams.m_internalPixelFormat, m_primaryRTParams.m_textureParams.m_pixelFormat);
+		s_renderDevice.ResizeRTTexture(m_primaryRTTexture0.GetID(), size, m_primaryRTParams.m_textureParams.m_internalPixelFormat, m_primaryRTParams.m_textureParams.m_pixelFormat);
+		s_renderDevice.ResizeRTTexture(m_primaryRTTexture1.GetID(), size, m_primaryRTParams.m_textureParams.m_internalPixelFormat, m_primaryRTParams.m_textureParams.m_pixelFormat);
 		//s_renderDevice.ResizeRTTexture(m_OutlineRTTexture.GetID(), windowSize, primaryRTParams.m_textureParams.m_internalPixelFormat, primaryRTParams.m_textureParams.m_pixelFormat);
-		s_renderDevice.ResizeRTTexture(m_pingPongRTTexture1.GetID(), m_viewportSize, m_pingPongRTParams.m_textureParams.m_internalPixelFormat, m_pingPongRTParams.m_textureParams.m_pixelFormat);
-		s_renderDevice.ResizeRTTexture(m_pingPongRTTexture1.GetID(), m_viewportSize, m_pingPongRTParams.m_textureParams.m_internalPixelFormat, m_pingPongRTParams.m_textureParams.m_pixelFormat);
-		s_renderDevice.ResizeRenderBuffer(m_primaryRenderTarget.GetID(), m_primaryRenderBuffer.GetID(), m_viewportSize, RenderBufferStorage::STORAGE_DEPTH);
+		s_renderDevice.ResizeRenderBuffer(m_primaryRenderTarget.GetID(), m_primaryRenderBuffer.GetID(), size, RenderBufferStorage::STORAGE_DEPTH);
+		m_primaryRTTexture0.m_size = m_primaryRTTexture1.m_size = size;
 
 #ifdef LINA_EDITOR
-		s_renderDevice.ResizeRTTexture(m_secondaryRTTexture.GetID(), m_viewportSize, m_primaryRTParams.m_textureParams.m_internalPixelFormat, m_primaryRTParams.m_textureParams.m_pixelFormat);
+		s_renderDevice.ResizeRTTexture(m_secondaryRTTexture.GetID(), size, m_primaryRTParams.m_textureParams.m_internalPixelFormat, m_primaryRTParams.m_textureParams.m_pixelFormat);
+		s_renderDevice.ResizeRenderBuffer(m_secondaryRenderTarget.GetID(), m_secondaryRenderBuffer.GetID(), size, RenderBufferStorage::STORAGE_DEPTH);
+		m_secondaryRTTexture.m_size = size;
 #endif
 	}
 
@@ -257,62 +361,70 @@ namespace LinaEngine::Graphics
 		Shader& unlit = Shader::CreateShader(Shaders::Standard_Unlit, "resources/engine/shaders/Unlit/Unlit.glsl");
 		unlit.BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
 		unlit.BindBlockToBuffer(UNIFORMBUFFER_DEBUGDATA_BINDPOINT, UNIFORMBUFFER_DEBUGDATA_NAME);
+		unlit.BindBlockToBuffer(UNIFORMBUFFER_MATERIALDATA_BINDPOINT, UNIFORMBUFFER_MATERIALDATA_NAME);
 
 		// PBR Lit
 		Shader& pbrLit = Shader::CreateShader(Shaders::PBR_Lit, "resources/engine/shaders/PBR/PBRLit.glsl", false);
 		pbrLit.BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
 		pbrLit.BindBlockToBuffer(UNIFORMBUFFER_LIGHTDATA_BINDPOINT, UNIFORMBUFFER_LIGHTDATA_NAME);
+		pbrLit.BindBlockToBuffer(UNIFORMBUFFER_LIGHTARRAYDATA_BINDPOINT, UNIFORMBUFFER_LIGHTARRAYDATA_NAME);
 		pbrLit.BindBlockToBuffer(UNIFORMBUFFER_DEBUGDATA_BINDPOINT, UNIFORMBUFFER_DEBUGDATA_NAME);
+		pbrLit.BindBlockToBuffer(UNIFORMBUFFER_MATERIALDATA_BINDPOINT, UNIFORMBUFFER_MATERIALDATA_NAME);
+		pbrLit.SetUniformInt(TEXTUREBUFFER_LIGHTDATA_NAME, TEXTUREBUFFER_LIGHTDATA_UNIT);
+		pbrLit.SetUniformInt(TEXTUREBUFFER_LIGHTGRID_NAME, TEXTUREBUFFER_LIGHTGRID_UNIT);
+		pbrLit.SetUniformInt(TEXTUREBUFFER_LIGHTINDEX_NAME, TEXTUREBUFFER_LIGHTINDEX_UNIT);
 
 		// Skies
-		Shader::CreateShader(Shaders::Skybox_SingleColor, "resources/engine/shaders/Skybox/SkyboxColor.glsl");
-		Shader::CreateShader(Shaders::Skybox_Gradient, "resources/engine/shaders/Skybox/SkyboxGradient.glsl").BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
-		Shader::CreateShader(Shaders::Skybox_Cubemap, "resources/engine/shaders/Skybox/SkyboxCubemap.glsl").BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
-		Shader::CreateShader(Shaders::Skybox_Procedural, "resources/engine/shaders/Skybox/SkyboxProcedural.glsl").BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
-		Shader::CreateShader(Shaders::Skybox_HDRI, "resources/engine/shaders/Skybox/SkyboxHDRI.glsl").BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
-		Shader::CreateShader(Shaders::Skybox_Atmospheric, "resources/engine/shaders/Skybox/SkyboxAtmospheric.glsl").BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
+		Shader::CreateShader(Shaders::Skybox_SingleColor, "resources/engine/shaders/Skybox/SkyboxColor.glsl").BindBlockToBuffer(UNIFORMBUFFER_MATERIALDATA_BINDPOINT, UNIFORMBUFFER_MATERIALDATA_NAME);
+		Shader& skyboxGradient = Shader::CreateShader(Shaders::Skybox_Gradient, "resources/engine/shaders/Skybox/SkyboxGradient.glsl", false, true);
+		skyboxGradient.BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
+		skyboxGradient.BindBlockToBuffer(UNIFORMBUFFER_MATERIALDATA_BINDPOINT, UNIFORMBUFFER_MATERIALDATA_NAME);
+		Shader::CreateShader(Shaders::Skybox_Cubemap, "resources/engine/shaders/Skybox/SkyboxCubemap.glsl", false, true).BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
+		Shader& skyboxProcedural = Shader::CreateShader(Shaders::Skybox_Procedural, "resources/engine/shaders/Skybox/SkyboxProcedural.glsl", false, true);
+		skyboxProcedural.BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
+		skyboxProcedural.BindBlockToBuffer(UNIFORMBUFFER_MATERIALDATA_BINDPOINT, UNIFORMBUFFER_MATERIALDATA_NAME);
+		Shader::CreateShader(Shaders::Skybox_HDRI, "resources/engine/shaders/Skybox/SkyboxHDRI.glsl", false, true).BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
+		Shader& skyboxAtmospheric = Shader::CreateShader(Shaders::Skybox_Atmospheric, "resources/engine/shaders/Skybox/SkyboxAtmospheric.glsl", false, true);
+		skyboxAtmospheric.BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
+		skyboxAtmospheric.BindBlockToBuffer(UNIFORMBUFFER_MATERIALDATA_BINDPOINT, UNIFORMBUFFER_MATERIALDATA_NAME);
 
 
 		// Equirectangular cube & irradiance for HDRI skbox
-		Shader::CreateShader(Shaders::HDRI_Equirectangular, "resources/engine/shaders/HDRI/HDRIEquirectangular.glsl");
-		Shader::CreateShader(Shaders::HDRI_Irradiance, "resources/engine/shaders/HDRI/HDRIIrradiance.glsl");
-		Shader::CreateShader(Shaders::HDRI_Prefilter, "resources/engine/shaders/HDRI/HDRIPrefilter.glsl");
-		Shader::CreateShader(Shaders::HDRI_BRDF, "resources/engine/shaders/HDRI/HDRIBRDF.glsl");
+		Shader::CreateShader(Shaders::HDRI_Equirectangular, "resources/engine/shaders/HDRI/HDRIEquirectangular.glsl", false, true);
+		Shader::CreateShader(Shaders::HDRI_Irradiance, "resources/engine/shaders/HDRI/HDRIIrradiance.glsl", false, true);
+		Shader::CreateShader(Shaders::HDRI_Prefilter, "resources/engine/shaders/HDRI/HDRIPrefilter.glsl", false, true);
+		Shader::CreateShader(Shaders::HDRI_BRDF, "resources/engine/shaders/HDRI/HDRIBRDF.glsl", false, true);
 
 
 		// Screen Quad Shaders
-		Shader::CreateShader(Shaders::ScreenQuad_Final, "resources/engine/shaders/ScreenQuads/SQFinal.glsl").BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
-		Shader::CreateShader(Shaders::ScreenQuad_Blur, "resources/engine/shaders/ScreenQuads/SQBlur.glsl").BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
-		Shader::CreateShader(Shaders::ScreenQuad_Outline, "resources/engine/shaders/ScreenQuads/SQOutline.glsl").BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
-		Shader::CreateShader(Shaders::ScreenQuad_Shadowmap, "resources/engine/shaders/ScreenQuads/SQShadowMap.glsl").BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
+		Shader& sqFinal = Shader::CreateShader(Shaders::ScreenQuad_Final, "resources/engine/shaders/ScreenQuads/SQFinal.glsl");
+		sqFinal.BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
+		sqFinal.BindBlockToBuffer(UNIFORMBUFFER_MATERIALDATA_BINDPOINT, UNIFORMBUFFER_MATERIALDATA_NAME);
+		Shader& sqBloom = Shader::CreateShader(Shaders::ScreenQuad_Bloom, "resources/engine/shaders/ScreenQuads/SQBloom.glsl", false, true);
+		sqBloom.BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
+		sqBloom.BindBlockToBuffer(UNIFORMBUFFER_MATERIALDATA_BINDPOINT, UNIFORMBUFFER_MATERIALDATA_NAME);
+		Shader::CreateShader(Shaders::ScreenQuad_Outline, "resources/engine/shaders/ScreenQuads/SQOutline.glsl", false, true).BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
+		Shader::CreateShader(Shaders::ScreenQuad_Shadowmap, "resources/engine/shaders/ScreenQuads/SQShadowMap.glsl", false, true).BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
 
 		// Line
-		Shader::CreateShader(Shaders::Debug_Line, "resources/engine/shaders/Misc/DebugLine.glsl").BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
+		Shader::CreateShader(Shaders::Debug_Line, "resources/engine/shaders/Misc/DebugLine.glsl", false, true).BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
 
 		// 2D
-		Shader::CreateShader(Shaders::Standard_Sprite, "resources/engine/shaders/2D/Sprite.glsl").BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
+		Shader& sprite = Shader::CreateShader(Shaders::Standard_Sprite, "resources/engine/shaders/2D/Sprite.glsl", false, true);
+		sprite.BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
+		sprite.BindBlockToBuffer(UNIFORMBUFFER_MATERIALDATA_BINDPOINT, UNIFORMBUFFER_MATERIALDATA_NAME);
+		Shader::CreateShader(Shaders::Standard_SpriteBatch, "resources/engine/shaders/2D/SpriteBatch.glsl", false, true).BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
 	}
 
 	bool RenderEngine::ValidateEngineShaders()
 	{
+		// Only the variants compiled so far are validated.
 		int validation = 0;
-		validation += s_renderDevice.ValidateShaderProgram(Shader::GetShader(Shaders::Standard_Unlit).GetID());
-		validation += s_renderDevice.ValidateShaderProgram(Shader::GetShader(Shaders::PBR_Lit).GetID());
-		validation += s_renderDevice.ValidateShaderProgram(Shader::GetShader(Shaders::Skybox_SingleColor).GetID());
-		validation += s_renderDevice.ValidateShaderProgram(Shader::GetShader(Shaders::Skybox_Gradient).GetID());
-		validation += s_renderDevice.ValidateShaderProgram(Shader::GetShader(Shaders::Skybox_Cubemap).GetID());
-		validation += s_renderDevice.ValidateShaderProgram(Shader::GetShader(Shaders::Skybox_Procedural).GetID());
-		validation += s_renderDevice.ValidateShaderProgram(Shader::GetShader(Shaders::Skybox_HDRI).GetID());
-		validation += s_renderDevice.ValidateShaderProgram(Shader::GetShader(Shaders::HDRI_Equirectangular).GetID());
-		validation += s_renderDevice.ValidateShaderProgram(Shader::GetShader(Shaders::HDRI_Irradiance).GetID());
-		validation += s_renderDevice.ValidateShaderProgram(Shader::GetShader(Shaders::HDRI_Prefilter).GetID());
-		validation += s_renderDevice.ValidateShaderProgram(Shader::GetShader(Shaders::HDRI_BRDF).GetID());
-		validation += s_renderDevice.ValidateShaderProgram(Shader::GetShader(Shaders::ScreenQuad_Final).GetID());
-		validation += s_renderDevice.ValidateShaderProgram(Shader::GetShader(Shaders::ScreenQuad_Blur).GetID());
-		validation += s_renderDevice.ValidateShaderProgram(Shader::GetShader(Shaders::ScreenQuad_Outline).GetID());
-		validation += s_renderDevice.ValidateShaderProgram(Shader::GetShader(Shaders::ScreenQuad_Shadowmap).GetID());
-		validation += s_renderDevice.ValidateShaderProgram(Shader::GetShader(Shaders::Debug_Line).GetID());
-		validation += s_renderDevice.ValidateShaderProgram(Shader::GetShader(Shaders::Standard_Sprite).GetID());
+		for (std::map<int, Shader>::iterator it = Shader::GetLoadedShaders().begin(); it != Shader::GetLoadedShaders().end(); ++it)
+		{
+			for (const auto& variant : it->second.GetVariants())
+				validation += s_renderDevice.ValidateShaderProgram(variant.second);
+		}
 
 		return !validation;
 	}
@@ -320,7 +432,7 @@ namespace LinaEngine::Graphics
 	void RenderEngine::ConstructEngineMaterials()
 	{
 		Material::SetMaterialShader(m_screenQuadFinalMaterial, Shaders::ScreenQuad_Final);
-		Material::SetMaterialShader(m_screenQuadBlurMaterial, Shaders::ScreenQuad_Blur);
+		Material::SetMaterialShader(m_screenQuadBloomMaterial, Shaders::ScreenQuad_Bloom);
 		Material::SetMaterialShader(m_screenQuadOutlineMaterial, Shaders::ScreenQuad_Outline);
 		Material::SetMaterialShader(m_hdriMaterial, Shaders::HDRI_Equirectangular);
 		Material::SetMaterialShader(m_debugDrawMaterial, Shaders::Debug_Line);
@@ -357,11 +469,11 @@ namespace LinaEngine::Graphics
 		m_primaryRTParams.m_textureParams.m_wrapS = m_primaryRTParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
 
 
-		// Ping pong
-		m_pingPongRTParams.m_textureParams.m_pixelFormat = PixelFormat::FORMAT_RGB;
-		m_pingPongRTParams.m_textureParams.m_internalPixelFormat = PixelFormat::FORMAT_RGB16F;
-		m_pingPongRTParams.m_textureParams.m_minFilter = m_pingPongRTParams.m_textureParams.m_magFilter = SamplerFilter::FILTER_LINEAR;
-		m_pingPongRTParams.m_textureParams.m_wrapS = m_pingPongRTParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
+		// Bloom
+		m_bloomRTParams.m_textureParams.m_pixelFormat = PixelFormat::FORMAT_RGB;
+		m_bloomRTParams.m_textureParams.m_internalPixelFormat = PixelFormat::FORMAT_RGB16F;
+		m_bloomRTParams.m_textureParams.m_minFilter = m_bloomRTParams.m_textureParams.m_magFilter = SamplerFilter::FILTER_LINEAR;
+		m_bloomRTParams.m_textureParams.m_wrapS = m_bloomRTParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
 
 		// Shadows depth.
 		m_shadowsRTParams.m_textureParams.m_pixelFormat = PixelFormat::FORMAT_DEPTH;
@@ -370,18 +482,16 @@ namespace LinaEngine::Graphics
 		m_shadowsRTParams.m_textureParams.m_wrapS = m_shadowsRTParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_BORDER;
 
 		// Initialize primary RT textures
+		m_renderTargetSize = m_viewportSize;
 		m_primaryRTTexture0.ConstructRTTexture(s_renderDevice, m_viewportSize, m_primaryRTParams, false);
 		m_primaryRTTexture1.ConstructRTTexture(s_renderDevice, m_viewportSize, m_primaryRTParams, false);
 
-		// Initialize ping pong rt texture
-		m_pingPongRTTexture1.ConstructRTTexture(s_renderDevice, m_viewportSize, m_pingPongRTParams, false);
-		m_pingPongRTTexture2.ConstructRTTexture(s_renderDevice, m_viewportSize, m_pingPongRTParams, false);
-
 		// Initialize outilne RT texture
 		//m_OutlineRTTexture.ConstructRTTexture(s_renderDevice, screenSize, primaryRTParams, false);
 
 		// Shadow map RT texture
 		m_shadowMapRTTexture.ConstructRTTexture(s_renderDevice, m_shadowMapResolution, m_shadowsRTParams, true);
+		m_staticShadowMapRTTexture.ConstructRTTexture(s_renderDevice, m_shadowMapResolution, m_shadowsRTParams, true);
 
 		// Initialize primary render buffer
 		m_primaryRenderBuffer.Construct(s_renderDevice, RenderBufferStorage::STORAGE_DEPTH, m_viewportSize);
@@ -397,10 +507,6 @@ namespace LinaEngine::Graphics
 		uint32 attachments[2] = { FrameBufferAttachment::ATTACHMENT_COLOR , (FrameBufferAttachment::ATTACHMENT_COLOR + (uint32)1) };
 		s_renderDevice.MultipleDrawBuffersCommand(m_primaryRenderTarget.GetID(), 2, attachments);
 
-		// Initialize ping pong render targets
-		m_pingPongRenderTarget1.Construct(s_renderDevice, m_pingPongRTTexture1, m_viewportSize, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR);
-		m_pingPongRenderTarget2.Construct(s_renderDevice, m_pingPongRTTexture2, m_viewportSize, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR);
-
 		// Initialize outline render target
 		//m_OutlineRenderTarget.Construct(s_renderDevice, m_OutlineRTTexture, m_viewportSize.x, m_viewportSize.y, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR);
 
@@ -410,11 +516,16 @@ namespace LinaEngine::Graphics
 		// Initialize depth map for shadows
 		m_shadowMapTarget.Construct(s_renderDevice, m_shadowMapRTTexture, m_shadowMapResolution, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_DEPTH, true);
 
+		// Initialize the depth map static shadow casters are cached in.
+		m_staticShadowMapTarget.Construct(s_renderDevice, m_staticShadowMapRTTexture, m_shadowMapResolution, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_DEPTH, true);
+
 #ifdef LINA_EDITOR
 		m_secondaryRTTexture.ConstructRTTexture(s_renderDevice, m_viewportSize, m_primaryRTParams, false);
 		m_secondaryRenderBuffer.Construct(s_renderDevice, RenderBufferStorage::STORAGE_DEPTH, m_viewportSize);
 		m_secondaryRenderTarget.Construct(s_renderDevice, m_secondaryRTTexture, m_viewportSize, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR, FrameBufferAttachment::ATTACHMENT_DEPTH, m_secondaryRenderBuffer.GetID());
 #endif
+
+		m_renderTargetsConstructed = true;
 	}
 
 	void RenderEngine::DumpMemory()
@@ -427,24 +538,36 @@ namespace LinaEngine::Graphics
 
 	void RenderEngine::DrawShadows()
 	{
-		// Clear color.
-		s_renderDevice.Clear(true, true, false, m_cameraSystem.GetCurrentClearColor(), 0xFF);
-
-		// Update pipeline.
-		m_renderingPipeline.UpdateSystems(0.0f);
+		int cascadeCount = m_lightingSystem.GetShadowCascadeCount();
 
-		// Update uniform buffers on GPU
-		UpdateUniformBuffers();
+		// Static casters are rendered only when the light, a cascade's frustum or the static geometry changes.
+		bool staticShadowsChanged = !m_staticShadowMapValid || m_staticShadowStateHash != m_meshRendererSystem.GetStaticStateHash() || m_staticShadowCascadeCount != cascadeCount;
+		for (int i = 0; i < cascadeCount; i++)
+		{
+			const ECS::ShadowCascade& cascade = m_lightingSystem.GetShadowCascade(i);
+			Matrix lightMatrix = cascade.m_projection * cascade.m_view;
+			staticShadowsChanged |= m_staticShadowMatrices[i] != lightMatrix;
+			m_staticShadowMatrices[i] = lightMatrix;
+		}
 
-		// Set depth frame 
-		s_renderDevice.SetFBO(m_shadowMapTarget.GetID());
-		s_renderDevice.SetViewport(Vector2::Zero, m_shadowMapResolution);
+		if (staticShadowsChanged)
+		{
+			m_staticShadowMapValid = true;
+			m_staticShadowStateHash = m_meshRendererSystem.GetStaticStateHash();
+			m_staticShadowCascadeCount = cascadeCount;
+
+			s_renderDevice.SetFBO(m_staticShadowMapTarget.GetID());
+			s_renderDevice.SetViewport(Vector2::Zero, m_shadowMapResolution);
+			s_renderDevice.Clear(false, true, false, m_cameraSystem.GetCurrentClearColor(), 0xFF);
+			DrawShadowCascades(m_staticShadowDrawList, PacketFilter::Static);
+		}
 
-		// Clear color.
-		s_renderDevice.Clear(false, true, false, m_cameraSystem.GetCurrentClearColor(), 0xFF);
+		// Start from the cached static depth.
+		s_renderDevice.BlitFrameBuffers(m_staticShadowMapTarget.GetID(), (uint32)m_shadowMapResolution.x, (uint32)m_shadowMapResolution.y, m_shadowMapTarget.GetID(), (uint32)m_shadowMapResolution.x, (uint32)m_shadowMapResolution.y, BufferBit::BIT_DEPTH, SamplerFilter::FILTER_NEAREST);
 
-		// Draw scene
-		DrawSceneObjects(m_shadowMapDrawParams, &m_shadowMapMaterial, false);
+		// Set depth frame & draw dynamic casters on top.
+		s_renderDevice.SetFBO(m_shadowMapTarget.GetID());
+		DrawShadowCascades(m_shadowDrawList, PacketFilter::Dynamic);
 
 		// Add the shadow texture
 		std::set<Material*>& shadowMappedMaterials = Material::GetShadowMappedMaterials();
@@ -453,77 +576,116 @@ namespace LinaEngine::Graphics
 
 	}
 
-	void RenderEngine::Draw()
+	void RenderEngine::DrawShadowCascades(DrawList& drawList, PacketFilter filter)
 	{
-		// Set render target
-		s_renderDevice.SetFBO(m_primaryRenderTarget.GetID());
-		s_renderDevice.SetViewport(Vector2::Zero, m_viewportSize);
-
-		// Clear color.
-		s_renderDevice.Clear(true, true, true, m_cameraSystem.GetCurrentClearColor(), 0xFF);
+		// Each cascade is culled against its own light frustum & drawn into its tile of the atlas.
+		for (int i = 0; i < m_lightingSystem.GetShadowCascadeCount(); i++)
+		{
+			const ECS::ShadowCascade& cascade = m_lightingSystem.GetShadowCascade(i);
+			RenderView cascadeView;
+			cascadeView.m_view = cascade.m_view;
+			cascadeView.m_projection = cascade.m_projection;
+			cascadeView.m_location = m_lightingSystem.GetDirectionalLightPos();
+			cascadeView.m_viewportPos = cascade.m_atlasOffset;
+			cascadeView.m_viewportSize = cascade.m_atlasSize;
+
+			Matrix lightSpace = cascade.m_projection * cascade.m_view;
+			m_globalDataBuffer.Update(&lightSpace[0][0], sizeof(Matrix) * 2, sizeof(Matrix));
+			s_renderDevice.SetViewport(cascade.m_atlasOffset, cascade.m_atlasSize);
+
+			// Cached static casters are drawn at full detail, the levels selected for the main view would invalidate the cache.
+			if (filter == PacketFilter::Static)
+			{
+				drawList.Begin(cascadeView);
+				drawList.Add(m_meshRendererSystem.GetStaticShadowPackets());
+				drawList.End();
+				drawList.Flush(*this, s_renderDevice, m_shadowMapDrawParams, &m_shadowMapMaterial);
+			}
+			else
+				DrawView(cascadeView, drawList, m_shadowMapDrawParams, &m_shadowMapMaterial, filter);
+		}
+	}
 
-		// Update pipeline.
-		m_renderingPipeline.UpdateSystems(0.0f);
+	void RenderEngine::DrawBloomPass(int pass, FrameGraphResource source, FrameGraphResource base)
+	{
+		Texture* sourceTexture = m_frameGraph.GetTexture(source);
+		Vector2 inverseSourceSize = 1.0f / sourceTexture->GetSize();
+		m_screenQuadBloomMaterial.SetInt(MAT_BLOOMPASS, pass);
+		m_screenQuadBloomMaterial.SetVector3(MAT_INVERSESCREENMAPSIZE, Vector3(inverseSourceSize.x, inverseSourceSize.y, 0.0f));
+		m_screenQuadBloomMaterial.SetTexture(MAT_MAP_SCREEN, sourceTexture);
+
+		if (base != FRAMEGRAPH_INVALIDRESOURCE)
+			m_screenQuadBloomMaterial.SetTexture(MAT_MAP_BLOOM, m_frameGraph.GetTexture(base));
+		else
+			m_screenQuadBloomMaterial.RemoveTexture(MAT_MAP_BLOOM);
 
-		// Update uniform buffers on GPU
-		UpdateUniformBuffers();
+		UpdateShaderData(&m_screenQuadBloomMaterial);
+		s_renderDevice.Draw(m_screenQuadVAO, m_fullscreenQuadDP, 0, 6, true);
+	}
 
-		// Draw scene
-		DrawSceneObjects(m_defaultDrawParams);
+	FrameGraphResource RenderEngine::AddBloomPasses(FrameGraphResource source)
+	{
+		m_screenQuadBloomMaterial.SetFloat(MAT_BLOOMTHRESHOLD, m_renderSettings.m_bloomThreshold);
+		m_screenQuadBloomMaterial.SetFloat(MAT_BLOOMRADIUS, m_renderSettings.m_bloomRadius);
+
+		// Chain starts at half resolution, levels below the min size are skipped so the blur covers the same screen fraction at any resolution.
+		Vector2 mipSizes[SC_MAXBLOOMMIPS];
+		int mipCount = 1;
+		Vector2 size = m_renderTargetSize;
+		for (int i = 0; i < SC_MAXBLOOMMIPS; i++)
+		{
+			size = Vector2(Math::Max(1.0f, Math::FloorToFloat(size.x * 0.5f)), Math::Max(1.0f, Math::FloorToFloat(size.y * 0.5f)));
+			mipSizes[i] = size;
 
-		bool horizontal = true;
+			if (i > 0 && Math::Min(size.x, size.y) >= SC_BLOOMMINMIPSIZE)
+				mipCount = i + 1;
+		}
 
-		if (m_renderSettings.m_bloomEnabled)
+		// Downsample the bright pass through the chain, first level applies the threshold.
+		FrameGraphResource down[SC_MAXBLOOMMIPS];
+		for (int i = 0; i < mipCount; i++)
 		{
-			// Write to the pingpong buffers to apply 2 pass gaussian blur.
-			bool firstIteration = true;
-			unsigned int amount = 4;
-			for (unsigned int i = 0; i < amount; i++)
-			{
-				// Select FBO
-				s_renderDevice.SetFBO(horizontal ? m_pingPongRenderTarget1.GetID() : m_pingPongRenderTarget2.GetID());
-
-				// Setup material & use.
-				m_screenQuadBlurMaterial.SetBool(MAT_ISHORIZONTAL, horizontal);
-				if (firstIteration)
-					m_screenQuadBlurMaterial.SetTexture(MAT_MAP_SCREEN, &m_primaryRTTexture1);
-				else
-				{
-					if (horizontal)
-						m_screenQuadBlurMaterial.SetTexture(MAT_MAP_SCREEN, &m_pingPongRTTexture2);
-					else
-						m_screenQuadBlurMaterial.SetTexture(MAT_MAP_SCREEN, &m_pingPongRTTexture1);
-				}
+			FrameGraphResource input = i == 0 ? source : down[i - 1];
+			int pass = i == 0 ? BLOOMPASS_PREFILTER : BLOOMPASS_DOWNSAMPLE;
+			down[i] = m_frameGraph.Create("BloomDownsample", mipSizes[i], m_bloomRTParams);
 
-				// Update shader data & draw.
-				UpdateShaderData(&m_screenQuadBlurMaterial);
-				s_renderDevice.Draw(m_screenQuadVAO, m_fullscreenQuadDP, 0, 6, true);
-				horizontal = !horizontal;
-				if (firstIteration) firstIteration = false;
-			}
+			FrameGraphPass& downsample = m_frameGraph.AddPass("BloomDownsample", "Bloom", [this, pass, input]() { DrawBloomPass(pass, input, FRAMEGRAPH_INVALIDRESOURCE); });
+			downsample.Read(input);
+			downsample.Write(down[i]);
 		}
 
-#ifdef LINA_EDITOR
-		s_renderDevice.SetFBO(m_secondaryRenderTarget.GetID());
-#else
-		// Back to default buffer
-		s_renderDevice.SetFBO(0);	
-#endif
-
-		s_renderDevice.SetViewport(m_viewportPos, m_viewportSize);
+		// Upsample back up, each level adds its own downsample on top of the blurred lower level.
+		FrameGraphResource lower = down[mipCount - 1];
+		for (int i = mipCount - 2; i >= 0; i--)
+		{
+			FrameGraphResource base = down[i];
+			FrameGraphResource up = m_frameGraph.Create("BloomUpsample", mipSizes[i], m_bloomRTParams);
+
+			FrameGraphPass& upsample = m_frameGraph.AddPass("BloomUpsample", "Bloom", [this, lower, base]() { DrawBloomPass(BLOOMPASS_UPSAMPLE, lower, base); });
+			upsample.Read(lower);
+			upsample.Read(base);
+			upsample.Write(up);
+			lower = up;
+		}
 
-		// Clear color bit.
-		s_renderDevice.Clear(true, true, false, Color::White, 0xFF);
+		return lower;
+	}
 
+	void RenderEngine::DrawFinal(FrameGraphResource scene, FrameGraphResource bloom)
+	{
 		// Set frame buffer texture on the material.
-		m_screenQuadFinalMaterial.SetTexture(MAT_MAP_SCREEN, &m_primaryRTTexture0, TextureBindMode::BINDTEXTURE_TEXTURE2D);
+		Texture* sceneTexture = m_frameGraph.GetTexture(scene);
+		m_screenQuadFinalMaterial.SetTexture(MAT_MAP_SCREEN, sceneTexture, TextureBindMode::BINDTEXTURE_TEXTURE2D);
 
-		if (m_screenQuadFinalMaterial.m_bools[MAT_BLOOMENABLED])
-			m_screenQuadFinalMaterial.SetTexture(MAT_MAP_BLOOM, horizontal ? &m_pingPongRTTexture1 : &m_pingPongRTTexture2, TextureBindMode::BINDTEXTURE_TEXTURE2D);
+		// Pooled targets do not outlive the frame, the bloom slot is cleared when there is none.
+		if (bloom != FRAMEGRAPH_INVALIDRESOURCE)
+			m_screenQuadFinalMaterial.SetTexture(MAT_MAP_BLOOM, m_frameGraph.GetTexture(bloom), TextureBindMode::BINDTEXTURE_TEXTURE2D);
+		else
+			m_screenQuadFinalMaterial.RemoveTexture(MAT_MAP_BLOOM);
 
 		// m_ScreenQuadFinalMaterial.SetTexture(MAT_MAP_OUTLINE, &m_OutlineRTTexture, TextureBindMode::BINDTEXTURE_TEXTURE2D);
 
-		Vector2 inverseMapSize = 1.0f / m_primaryRTTexture0.GetSize();
+		Vector2 inverseMapSize = 1.0f / sceneTexture->GetSize();
 		m_screenQuadFinalMaterial.SetVector3(MAT_INVERSESCREENMAPSIZE, Vector3(inverseMapSize.x, inverseMapSize.y, 0.0));
 
 		// update shader w/ material data.
@@ -533,11 +695,69 @@ namespace LinaEngine::Graphics
 		s_renderDevice.Draw(m_screenQuadVAO, m_fullscreenQuadDP, 0, 6, true);
 	}
 
+	void RenderEngine::BuildFrameGraph()
+	{
+		m_frameGraph.Reset();
+
+		// Persistent targets.
+		FrameGraphClear sceneClear;
+		sceneClear.m_color = sceneClear.m_depth = sceneClear.m_stencil = true;
+		sceneClear.m_clearColor = m_cameraSystem.GetCurrentClearColor();
+		FrameGraphResource sceneColor = m_frameGraph.Import("SceneColor", m_primaryRenderTarget.GetID(), &m_primaryRTTexture0, Vector2::Zero, m_renderTargetSize, sceneClear);
+		FrameGraphResource sceneBright = m_frameGraph.Import("SceneBright", m_primaryRenderTarget.GetID(), &m_primaryRTTexture1, Vector2::Zero, m_renderTargetSize);
+		FrameGraphResource shadowMap = m_frameGraph.Import("ShadowMap", m_shadowMapTarget.GetID(), &m_shadowMapRTTexture, Vector2::Zero, m_shadowMapResolution);
+
+		FrameGraphClear outputClear;
+		outputClear.m_color = outputClear.m_depth = true;
+		outputClear.m_clearColor = Color::White;
+
+#ifdef LINA_EDITOR
+		// Editor target has the size of the scene targets, the scene panel stretches it.
+		FrameGraphResource output = m_frameGraph.Import("Output", m_secondaryRenderTarget.GetID(), &m_secondaryRTTexture, Vector2::Zero, m_renderTargetSize, outputClear);
+#else
+		// Default frame buffer, scene is stretched over the viewport while a resize is pending.
+		FrameGraphResource output = m_frameGraph.Import("Output", 0, nullptr, m_viewportPos, m_viewportSize, outputClear);
+#endif
+
+		// Shadow pass is culled unless a material samples the shadow map.
+		if (m_lightingSystem.GetShadowCascadeCount() > 0)
+		{
+			FrameGraphPass& shadows = m_frameGraph.AddPass("Shadows", "Shadows", [this]() { DrawShadows(); });
+			shadows.Write(shadowMap);
+		}
+
+		FrameGraphPass& scene = m_frameGraph.AddPass("Scene", "Scene", [this]() { DrawSceneObjects(m_defaultDrawParams); });
+		if (!Material::GetShadowMappedMaterials().empty())
+			scene.Read(shadowMap);
+		scene.Write(sceneColor);
+		scene.Write(sceneBright);
+
+		FrameGraphResource bloom = FRAMEGRAPH_INVALIDRESOURCE;
+		if (m_renderSettings.m_bloomEnabled)
+			bloom = AddBloomPasses(sceneBright);
+
+		FrameGraphPass& finalPass = m_frameGraph.AddPass("Final", "Final", [this, sceneColor, bloom]() { DrawFinal(sceneColor, bloom); });
+		finalPass.Read(sceneColor);
+		finalPass.Read(bloom);
+		finalPass.Write(output);
+		finalPass.SetSideEffect();
+
+		m_frameGraph.Compile();
+	}
+
+	void RenderEngine::Draw()
+	{
+		// Passes are rebuilt every frame, disabled features add no passes & allocate no targets.
+		BuildFrameGraph();
+		m_frameGraph.Execute();
+	}
+
 	void RenderEngine::DrawLine(Vector3 p1, Vector3 p2, Color col, float width)
 	{
-		s_renderDevice.SetShader(m_debugDrawMaterial.m_shaderID);
-		s_renderDevice.UpdateShaderUniformColor(m_debugDrawMaterial.m_shaderID, MAT_COLOR, col);
-		s_renderDevice.DrawLine(m_debugDrawMaterial.m_shaderID, Matrix::Identity(), p1, p2, width);
+		uint32 shader = m_debugDrawMaterial.GetShaderID();
+		s_renderDevice.SetShader(shader);
+		s_renderDevice.UpdateShaderUniformColor(shader, MAT_COLOR, col);
+		s_renderDevice.DrawLine(shader, Matrix::Identity(), p1, p2, width);
 	}
 
 	void RenderEngine::SetDrawParameters(const DrawParams& params)
@@ -563,12 +783,6 @@ namespace LinaEngine::Graphics
 		// Clear color.
 		s_renderDevice.Clear(true, true, true, m_cameraSystem.GetCurrentClearColor(), 0xFF);
 
-		// Update pipeline.
-		m_renderingPipeline.UpdateSystems(0.0f);
-
-		// Update uniform buffers on GPU
-		UpdateUniformBuffers();
-
 		// Draw scene
 		DrawSceneObjects(m_defaultDrawParams, nullptr, true);
 	}
@@ -593,9 +807,12 @@ namespace LinaEngine::Graphics
 		if (drawSkybox)
 			DrawSkybox();
 
-		m_meshRendererSystem.FlushOpaque(drawParams, overrideMaterial, true);
-		m_meshRendererSystem.FlushTransparent(drawParams, overrideMaterial, true);
-		m_spriteRendererSystem.Flush(drawParams, overrideMaterial, true);
+		DrawView(GetMainView(), m_mainDrawList, drawParams, overrideMaterial, PacketFilter::All, m_renderSettings.m_occlusionCullingEnabled ? &m_occlusionCuller : nullptr);
+
+		// Batched sprites are drawn in the main view only, after all the sorted packets so on top of the transparent ones.
+		// They use their atlas materials & are skipped by the passes overriding materials.
+		if (overrideMaterial == nullptr)
+			m_spriteBatcher.Draw(*this, drawParams);
 
 		// Post scene draw callback.
 		if (m_postSceneDrawCallback)
@@ -603,96 +820,338 @@ namespace LinaEngine::Graphics
 
 	}
 
-	void RenderEngine::UpdateUniformBuffers()
+	void RenderEngine::DrawSceneView(const RenderView& view, DrawParams& drawParams, Material* overrideMaterial, bool drawSkybox)
 	{
-		Vector3 cameraLocation = m_cameraSystem.GetCameraLocation();
-		Vector4 viewPos = Vector4(cameraLocation.x, cameraLocation.y, cameraLocation.z, 1.0f);
+		// Point the view dependent buffers to the view, they are restored for the main view afterwards.
+		UpdateViewData(view);
+		UpdateLightClusters(view);
 
-		// Update global matrix buffer
-		uintptr currentGlobalDataOffset = 0;
-		m_globalDataBuffer.Update(&m_cameraSystem.GetProjectionMatrix()[0][0], currentGlobalDataOffset, sizeof(Matrix));
-		currentGlobalDataOffset += sizeof(Matrix);
+		if (drawSkybox)
+			DrawSkybox();
 
-		m_globalDataBuffer.Update(&m_cameraSystem.GetViewMatrix()[0][0], currentGlobalDataOffset, sizeof(Matrix));
-		currentGlobalDataOffset += sizeof(Matrix);
+		DrawView(view, m_auxiliaryDrawList, drawParams, overrideMaterial);
 
-		m_globalDataBuffer.Update(&m_lightingSystem.GetDirectionalLightMatrix()[0][0], currentGlobalDataOffset, sizeof(Matrix));
-		currentGlobalDataOffset += sizeof(Matrix);
+		RenderView mainView = GetMainView();
+		UpdateViewData(mainView);
+		UpdateLightClusters(mainView);
+	}
 
-		m_globalDataBuffer.Update(&viewPos, currentGlobalDataOffset, sizeof(Vector4));
-		currentGlobalDataOffset += sizeof(Vector4);
+	void RenderEngine::DrawView(const RenderView& view, DrawList& drawList, DrawParams& drawParams, Material* overrideMaterial, PacketFilter filter, OcclusionCuller* occlusionCuller)
+	{
+		// Cull & sort the gathered packets for the view, then draw.
+		drawList.Begin(view);
+		drawList.Add(m_meshRendererSystem.GetPackets(), filter, occlusionCuller);
+		drawList.Add(m_spriteRendererSystem.GetPackets(), filter, occlusionCuller);
+		drawList.End();
+		drawList.Flush(*this, s_renderDevice, drawParams, overrideMaterial);
+	}
 
-		ECS::CameraComponent* cameraComponent = m_cameraSystem.GetCurrentCameraComponent();
+	RenderView RenderEngine::GetMainView()
+	{
+		RenderView view;
+		view.m_view = m_cameraSystem.GetViewMatrix();
+		view.m_projection = m_cameraSystem.GetProjectionMatrix();
+		view.m_location = m_cameraSystem.GetCameraLocation();
+		view.m_viewportSize = m_renderTargetSize;
 
+		ECS::CameraComponent* cameraComponent = m_cameraSystem.GetCurrentCameraComponent();
 		if (cameraComponent != nullptr)
 		{
-			// Update only if changed.
-			if (m_bufferValueRecord.zNear != cameraComponent->m_zNear)
-			{
-				m_bufferValueRecord.zNear = cameraComponent->m_zNear;
-				m_globalDataBuffer.Update(&cameraComponent->m_zNear, currentGlobalDataOffset, sizeof(float));
-			}
-			currentGlobalDataOffset += sizeof(float);
+			view.m_zNear = cameraComponent->m_zNear;
+			view.m_zFar = cameraComponent->m_zFar;
+		}
 
+		return view;
+	}
 
-			// Update only if changed.
-			if (m_bufferValueRecord.zFar != cameraComponent->m_zFar)
-			{
-				m_bufferValueRecord.zFar = cameraComponent->m_zFar;
-				m_globalDataBuffer.Update(&cameraComponent->m_zNear, currentGlobalDataOffset, sizeof(float));
-			}
-			currentGlobalDataOffset += sizeof(float);
+	void RenderEngine::UpdateViewData(const RenderView& view)
+	{
+		Vector4 viewPos = Vector4(view.m_location.x, view.m_location.y, view.m_location.z, 1.0f);
+
+		// Projection, view & position, the light space matrix in between does not depend on the view.
+		m_globalDataBuffer.Update(&view.m_projection[0][0], 0, sizeof(Matrix));
+		m_globalDataBuffer.Update(&view.m_view[0][0], sizeof(Matrix), sizeof(Matrix));
+		m_globalDataBuffer.Update(&viewPos, sizeof(Matrix) * 3, sizeof(Vector4));
+		uintptr currentGlobalDataOffset = sizeof(Matrix) * 3 + sizeof(Vector4);
+
+		// Update only if changed.
+		if (m_bufferValueRecord.zNear != view.m_zNear)
+		{
+			m_bufferValueRecord.zNear = view.m_zNear;
+			m_globalDataBuffer.Update(&view.m_zNear, currentGlobalDataOffset, sizeof(float));
+		}
+		currentGlobalDataOffset += sizeof(float);
+
+		// Update only if changed.
+		if (m_bufferValueRecord.zFar != view.m_zFar)
+		{
+			m_bufferValueRecord.zFar = view.m_zFar;
+			m_globalDataBuffer.Update(&view.m_zFar, currentGlobalDataOffset, sizeof(float));
 		}
+	}
+
+	void RenderEngine::UpdateLightClusters(const RenderView& view)
+	{
+		// Assign the lights packed for this frame to the view's clusters.
+		m_lightingSystem.BuildLightClusters(view.m_view, view.m_projection, view.m_zNear, view.m_zFar, view.m_viewportPos, view.m_viewportSize);
+
+		// Upload the light & cluster data w/ a single update each.
+		const std::vector<ECS::LightBufferData>& lightBufferData = m_lightingSystem.GetLightBufferData();
+		const std::vector<uint32>& clusterGrid = m_lightingSystem.GetClusterGrid();
+		const std::vector<uint32>& clusterLightIndices = m_lightingSystem.GetClusterLightIndices();
+		m_globalLightArrayBuffer.Update(&m_lightingSystem.GetLightData(), 0, UNIFORMBUFFER_LIGHTARRAYDATA_SIZE);
+		m_lightDataBuffer.Update(&lightBufferData[0], lightBufferData.size() * sizeof(ECS::LightBufferData));
+		m_lightGridBuffer.Update(&clusterGrid[0], clusterGrid.size() * sizeof(uint32));
+		m_lightIndexBuffer.Update(&clusterLightIndices[0], clusterLightIndices.size() * sizeof(uint32));
+		m_lightDataBuffer.Bind(TEXTUREBUFFER_LIGHTDATA_UNIT);
+		m_lightGridBuffer.Bind(TEXTUREBUFFER_LIGHTGRID_UNIT);
+		m_lightIndexBuffer.Bind(TEXTUREBUFFER_LIGHTINDEX_UNIT);
+	}
+
+	void RenderEngine::UpdateUniformBuffers()
+	{
+		RenderView mainView = GetMainView();
+		Vector4 viewPos = Vector4(mainView.m_location.x, mainView.m_location.y, mainView.m_location.z, 1.0f);
+
+		// Update global matrix buffer
+		UpdateViewData(mainView);
+
+		// Pack all lights once per frame, fit the shadow cascades & assign the lights to the main view's clusters.
+		m_lightingSystem.PackLightData();
+		m_lightingSystem.BuildShadowCascades(mainView.m_view, mainView.m_projection, mainView.m_zNear, mainView.m_zFar, m_shadowMapResolution);
+		UpdateLightClusters(mainView);
 
 		// Update lights buffer.
 		Color ambient = m_lightingSystem.GetAmbientColor();
 		Vector4 ambientColor = Vector4(ambient.r, ambient.g, ambient.b, 1.0f);
 		m_globalLightBuffer.Update(&m_currentPointLightCount, 0, sizeof(int));
 		m_globalLightBuffer.Update(&m_currentSpotLightCount, sizeof(int), sizeof(int));
-		m_globalLightBuffer.Update(&ambientColor, sizeof(int) * 2, sizeof(float) * 4);
-		m_globalLightBuffer.Update(&m_cameraSystem.GetCameraLocation(), (sizeof(int) * 2) + (sizeof(float) * 4), sizeof(float) * 4);
+		m_globalLightBuffer.Update(&ambientColor, sizeof(int) * 4, sizeof(float) * 4);
+		m_globalLightBuffer.Update(&viewPos, (sizeof(int) * 4) + (sizeof(float) * 4), sizeof(float) * 4);
 
 		// Update debug fufer.
 		m_globalDebugBuffer.Update(&m_debugData.visualizeDepth, 0, sizeof(bool));
 	}
 
-	void RenderEngine::UpdateShaderData(Material* data)
+	void RenderEngine::ResolveUniformHandles(Material* data)
+	{
+		// Resolve every parameter name once, draws only index into the handle arrays afterwards.
+		MaterialUniformHandles& handles = data->m_uniformHandles;
+		const uint32 shader = data->m_shaderID;
+		const int32 previousBlockSize = handles.m_blockSize;
+		handles = MaterialUniformHandles();
+		handles.m_shaderID = shader;
+		handles.m_parameterGeneration = data->m_parameterGeneration;
+		handles.m_blockSize = s_renderDevice.GetMaterialBlockSize(shader);
+
+		// Parameters that are not members of the material block fall back to plain uniforms.
+		auto resolve = [&](const std::string& name) -> MaterialParameterHandle
+		{
+			MaterialParameterHandle handle;
+			handle.m_blockOffset = s_renderDevice.GetMaterialBlockOffset(shader, name);
+			if (handle.m_blockOffset == -1)
+			{
+				handle.m_location = s_renderDevice.GetUniformHandle(shader, name);
+				handles.m_hasLooseUniforms |= handle.m_location != -1;
+			}
+			return handle;
+		};
+
+		for (auto const& d : data->m_floats)
+			handles.m_floats.push_back(resolve(d.first));
+
+		for (auto const& d : data->m_bools)
+			handles.m_bools.push_back(resolve(d.first));
+
+		for (auto const& d : data->m_colors)
+			handles.m_colors.push_back(resolve(d.first));
+
+		for (auto const& d : data->m_ints)
+			handles.m_ints.push_back(resolve(d.first));
+
+		for (auto const& d : data->m_vector2s)
+			handles.m_vector2s.push_back(resolve(d.first));
+
+		for (auto const& d : data->m_vector3s)
+			handles.m_vector3s.push_back(resolve(d.first));
+
+		for (auto const& d : data->m_vector4s)
+			handles.m_vector4s.push_back(resolve(d.first));
+
+		for (auto const& d : data->m_matrices)
+			handles.m_matrices.push_back(resolve(d.first));
+
+		for (auto const& d : data->m_sampler2Ds)
+		{
+			handles.m_samplerTextures.push_back(s_renderDevice.GetUniformHandle(shader, d.first + MAT_EXTENSION_TEXTURE2D));
+			handles.m_samplerActives.push_back(s_renderDevice.GetUniformHandle(shader, d.first + MAT_EXTENSION_ISACTIVE));
+		}
+
+		// (Re)create the block buffer if the layout size changed.
+		if (handles.m_blockSize != previousBlockSize || (handles.m_blockSize > 0 && data->m_blockBuffer == 0))
+		{
+			data->m_blockBuffer = s_renderDevice.ReleaseUniformBuffer(data->m_blockBuffer);
+			data->m_blockData.assign(handles.m_blockSize, 0);
+
+			if (handles.m_blockSize > 0)
+				data->m_blockBuffer = s_renderDevice.CreateUniformBuffer(nullptr, handles.m_blockSize, BufferUsage::USAGE_DYNAMIC_DRAW);
+		}
+
+		data->m_blockDirty = true;
+	}
+
+	void RenderEngine::UpdateMaterialBlock(Material* data)
 	{
+		// Pack all block parameters w/ their std140 offsets & upload them in one go.
+		const MaterialUniformHandles& handles = data->m_uniformHandles;
+		std::vector<uint8>& block = data->m_blockData;
+		size_t i = 0;
 
-		s_renderDevice.SetShader(data->GetShaderID());
+		for (auto const& d : data->m_floats)
+			WriteMaterialBlock(block, handles.m_floats[i++].m_blockOffset, &d.second, sizeof(float));
+
+		i = 0;
+		for (auto const& d : data->m_bools)
+		{
+			// std140 bools are 4 bytes wide.
+			int32 value = d.second ? 1 : 0;
+			WriteMaterialBlock(block, handles.m_bools[i++].m_blockOffset, &value, sizeof(int32));
+		}
+
+		i = 0;
+		for (auto const& d : data->m_colors)
+		{
+			float color[3] = { d.second.r, d.second.g, d.second.b };
+			WriteMaterialBlock(block, handles.m_colors[i++].m_blockOffset, color, sizeof(float) * 3);
+		}
+
+		i = 0;
+		for (auto const& d : data->m_ints)
+			WriteMaterialBlock(block, handles.m_ints[i++].m_blockOffset, &d.second, sizeof(int32));
+
+		i = 0;
+		for (auto const& d : data->m_vector2s)
+		{
+			float vector[2] = { d.second.x, d.second.y };
+			WriteMaterialBlock(block, handles.m_vector2s[i++].m_blockOffset, vector, sizeof(float) * 2);
+		}
+
+		i = 0;
+		for (auto const& d : data->m_vector3s)
+		{
+			float vector[3] = { d.second.x, d.second.y, d.second.z };
+			WriteMaterialBlock(block, handles.m_vector3s[i++].m_blockOffset, vector, sizeof(float) * 3);
+		}
+
+		i = 0;
+		for (auto const& d : data->m_vector4s)
+		{
+			float vector[4] = { d.second.x, d.second.y, d.second.z, d.second.w };
+			WriteMaterialBlock(block, handles.m_vector4s[i++].m_blockOffset, vector, sizeof(float) * 4);
+		}
 
-		for (auto const& d : (*data).m_floats)
-			s_renderDevice.UpdateShaderUniformFloat(data->m_shaderID, d.first, d.second);
+		i = 0;
+		for (auto const& d : data->m_matrices)
+			WriteMaterialBlock(block, handles.m_matrices[i++].m_blockOffset, &d.second[0][0], sizeof(float) * 16);
 
-		for (auto const& d : (*data).m_bools)
-			s_renderDevice.UpdateShaderUniformInt(data->m_shaderID, d.first, d.second);
+		s_renderDevice.UpdateUniformBuffer(data->m_blockBuffer, &block[0], 0, block.size());
+		data->m_blockDirty = false;
+	}
+
+	void RenderEngine::UpdateLooseUniforms(Material* data)
+	{
+		// Parameters the shader declares outside of its material block.
+		const MaterialUniformHandles& handles = data->m_uniformHandles;
+		size_t i = 0;
+
+		for (auto const& d : data->m_floats)
+		{
+			const MaterialParameterHandle& h = handles.m_floats[i++];
+			if (h.m_location != -1) s_renderDevice.UpdateShaderUniformFloat(h.m_location, d.second);
+		}
+
+		i = 0;
+		for (auto const& d : data->m_bools)
+		{
+			const MaterialParameterHandle& h = handles.m_bools[i++];
+			if (h.m_location != -1) s_renderDevice.UpdateShaderUniformInt(h.m_location, d.second);
+		}
+
+		i = 0;
+		for (auto const& d : data->m_colors)
+		{
+			const MaterialParameterHandle& h = handles.m_colors[i++];
+			if (h.m_location != -1) s_renderDevice.UpdateShaderUniformColor(h.m_location, d.second);
+		}
+
+		i = 0;
+		for (auto const& d : data->m_ints)
+		{
+			const MaterialParameterHandle& h = handles.m_ints[i++];
+			if (h.m_location != -1) s_renderDevice.UpdateShaderUniformInt(h.m_location, d.second);
+		}
+
+		i = 0;
+		for (auto const& d : data->m_vector2s)
+		{
+			const MaterialParameterHandle& h = handles.m_vector2s[i++];
+			if (h.m_location != -1) s_renderDevice.UpdateShaderUniformVector2(h.m_location, d.second);
+		}
+
+		i = 0;
+		for (auto const& d : data->m_vector3s)
+		{
+			const MaterialParameterHandle& h = handles.m_vector3s[i++];
+			if (h.m_location != -1) s_renderDevice.UpdateShaderUniformVector3(h.m_location, d.second);
+		}
 
-		for (auto const& d : (*data).m_colors)
-			s_renderDevice.UpdateShaderUniformColor(data->m_shaderID, d.first, d.second);
+		i = 0;
+		for (auto const& d : data->m_vector4s)
+		{
+			const MaterialParameterHandle& h = handles.m_vector4s[i++];
+			if (h.m_location != -1) s_renderDevice.UpdateShaderUniformVector4F(h.m_location, d.second);
+		}
 
-		for (auto const& d : (*data).m_ints)
-			s_renderDevice.UpdateShaderUniformInt(data->m_shaderID, d.first, d.second);
+		i = 0;
+		for (auto const& d : data->m_matrices)
+		{
+			const MaterialParameterHandle& h = handles.m_matrices[i++];
+			if (h.m_location != -1) s_renderDevice.UpdateShaderUniformMatrix(h.m_location, d.second);
+		}
+	}
 
-		for (auto const& d : (*data).m_vector2s)
-			s_renderDevice.UpdateShaderUniformVector2(data->m_shaderID, d.first, d.second);
+	void RenderEngine::UpdateShaderData(Material* data)
+	{
 
-		for (auto const& d : (*data).m_vector3s)
-			s_renderDevice.UpdateShaderUniformVector3(data->m_shaderID, d.first, d.second);
+		s_renderDevice.SetShader(data->GetShaderID());
 
-		for (auto const& d : (*data).m_vector4s)
-			s_renderDevice.UpdateShaderUniformVector4F(data->m_shaderID, d.first, d.second);
+		if (!data->UniformHandlesValid())
+			ResolveUniformHandles(data);
 
-		for (auto const& d : (*data).m_matrices)
-			s_renderDevice.UpdateShaderUniformMatrix(data->m_shaderID, d.first, d.second);
+		const MaterialUniformHandles& handles = data->m_uniformHandles;
 
+		// Block parameters are only re-uploaded when changed, binding is a single range bind.
+		if (handles.m_blockSize > 0)
+		{
+			if (data->m_blockDirty)
+				UpdateMaterialBlock(data);
+
+			s_renderDevice.BindUniformBufferRange(data->m_blockBuffer, UNIFORMBUFFER_MATERIALDATA_BINDPOINT, 0, handles.m_blockSize);
+		}
+
+		if (handles.m_hasLooseUniforms)
+			UpdateLooseUniforms(data);
+
+		size_t i = 0;
 		for (auto const& d : (*data).m_sampler2Ds)
 		{
 			// Set whether the texture is active or not.
 			bool isActive = (d.second.m_isActive && d.second.m_boundTexture != nullptr && !d.second.m_boundTexture->GetIsEmpty()) ? true : false;
-			s_renderDevice.UpdateShaderUniformInt(data->m_shaderID, d.first + MAT_EXTENSION_ISACTIVE, isActive);
+			s_renderDevice.UpdateShaderUniformInt(handles.m_samplerActives[i], isActive);
 
 			// Set the texture to corresponding active unit.
-			s_renderDevice.UpdateShaderUniformInt(data->m_shaderID, d.first + MAT_EXTENSION_TEXTURE2D, d.second.m_unit);
+			s_renderDevice.UpdateShaderUniformInt(handles.m_samplerTextures[i], d.second.m_unit);
+			i++;
 
 			// Set texture
 			if (isActive)
@@ -707,10 +1166,6 @@ namespace LinaEngine::Graphics
 			}
 		}
 
-
-		if (data->m_receivesLighting)
-			m_lightingSystem.SetLightingShaderData(data->GetShaderID());
-
 	}
 
 	void RenderEngine::CaptureCalculateHDRI(Texture& hdriTexture)
@@ -727,11 +1182,36 @@ namespace LinaEngine::Graphics
 			Matrix::InitLookAtRH(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f,  0.0f, -1.0f), glm::vec3(0.0f, -1.0f,  0.0f))
 		};
 
-		// Calculate HDRI, Irradiance, Prefilter and BRDF
-		CalculateHDRICubemap(hdriTexture, captureProjection, captureViews);
-		CalculateHDRIIrradiance(captureProjection, captureViews);
-		CalculateHDRIPrefilter(captureProjection, captureViews);
-		CalculateHDRIBRDF(captureProjection, captureViews);
+		// Maps are cached next to the source, keyed by its content & the resolutions they are computed with.
+		const std::string& hdriPath = hdriTexture.GetPath();
+		uint32 resolutions[] = { SC_HDRICUBEMAPRESOLUTION, SC_HDRIIRRADIANCERESOLUTION, SC_HDRIPREFILTERRESOLUTION, SC_HDRIPREFILTERMIPS };
+		uint64 cacheKey = hdriPath.empty() ? 0 : HDRICache::HashFile(hdriPath);
+		if (cacheKey != 0)
+			cacheKey = HDRICache::HashBytes(resolutions, sizeof(resolutions), cacheKey);
+
+		// Calculate HDRI, Irradiance & Prefilter if they are not cached.
+		std::string cachePath = hdriPath + HDRICACHE_EXTENSION;
+		ConstructHDRIMaps();
+		if (cacheKey == 0 || !LoadHDRIMaps(cachePath, cacheKey))
+		{
+			CalculateHDRICubemap(hdriTexture, captureProjection, captureViews);
+			CalculateHDRIPrefilter(captureProjection, captureViews);
+
+			// Irradiance is projected to SH on the CPU when the source can be read, the cubemap convolution is the fallback.
+			m_hdriUsesIrradianceSH = CalculateHDRIIrradianceSH(hdriPath);
+			if (!m_hdriUsesIrradianceSH)
+				CalculateHDRIIrradiance(captureProjection, captureViews);
+			else if (cacheKey != 0)
+				SaveHDRIMaps(cachePath, cacheKey);
+		}
+
+		// BRDF doesn't depend on the HDRI, it ships precomputed & is only calculated if the asset is missing.
+		if (m_HDRILutMap.GetID() == 0 && !LoadHDRIBRDF())
+		{
+			CalculateHDRIBRDF(captureProjection, captureViews);
+			SaveHDRIBRDF();
+		}
+
 		s_renderDevice.SetFBO(0);
 		s_renderDevice.SetViewport(m_viewportPos, m_viewportSize);
 
@@ -746,9 +1226,9 @@ namespace LinaEngine::Graphics
 		}
 	}
 
-	void RenderEngine::CalculateHDRICubemap(Texture& hdriTexture, glm::mat4& captureProjection, glm::mat4 views[6])
+	void RenderEngine::ConstructHDRIMaps()
 	{
-		// Generate sampler.
+		// Generate samplers.
 		SamplerParameters samplerParams;
 		samplerParams.m_textureParams.m_wrapR = samplerParams.m_textureParams.m_wrapS = samplerParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
 		samplerParams.m_textureParams.m_magFilter = SamplerFilter::FILTER_LINEAR;
@@ -756,11 +1236,21 @@ namespace LinaEngine::Graphics
 		samplerParams.m_textureParams.m_internalPixelFormat = PixelFormat::FORMAT_RGB16F;
 		samplerParams.m_textureParams.m_pixelFormat = PixelFormat::FORMAT_RGB;
 
+		SamplerParameters prefilterParams = samplerParams;
+		prefilterParams.m_textureParams.m_generateMipMaps = true;
+
 		// Set resolution.
-		m_hdriResolution = Vector2(512, 512);
+		m_hdriResolution = Vector2(SC_HDRICUBEMAPRESOLUTION, SC_HDRICUBEMAPRESOLUTION);
 
-		// Construct Cubemap texture.
+		// Construct the textures, calculation or the cache fills them. Irradiance is only a cubemap on the fallback path.
 		m_hdriCubemap.ConstructRTCubemapTexture(s_renderDevice, m_hdriResolution, samplerParams);
+		m_hdriPrefilterMap.ConstructRTCubemapTexture(s_renderDevice, Vector2(SC_HDRIPREFILTERRESOLUTION, SC_HDRIPREFILTERRESOLUTION), prefilterParams);
+	}
+
+	void RenderEngine::CalculateHDRICubemap(Texture& hdriTexture, glm::mat4& captureProjection, glm::mat4 views[6])
+	{
+		// Earlier captures leave the render buffer at their last size.
+		s_renderDevice.ResizeRenderBuffer(m_hdriCaptureRenderTarget.GetID(), m_hdriCaptureRenderBuffer.GetID(), m_hdriResolution, RenderBufferStorage::STORAGE_DEPTH_COMP24);
 
 		// Setup shader data.
 		uint32 equirectangularShader = Shader::GetShader(Shaders::HDRI_Equirectangular).GetID();
@@ -798,7 +1288,7 @@ namespace LinaEngine::Graphics
 		irradianceParams.m_textureParams.m_pixelFormat = PixelFormat::FORMAT_RGB;
 
 		// Set resolution
-		Vector2 irradianceMapResolsution = Vector2(32, 32);
+		Vector2 irradianceMapResolsution = Vector2(SC_HDRIIRRADIANCERESOLUTION, SC_HDRIIRRADIANCERESOLUTION);
 
 		// Create irradiance texture & scale render buffer according to the resolution.
 		m_hdriIrradianceMap.ConstructRTCubemapTexture(s_renderDevice, irradianceMapResolsution, irradianceParams);
@@ -824,41 +1314,56 @@ namespace LinaEngine::Graphics
 		}
 	}
 
-	void RenderEngine::CalculateHDRIPrefilter(Matrix& captureProjection, Matrix views[6])
+	bool RenderEngine::CalculateHDRIIrradianceSH(const std::string& hdriPath)
 	{
-		// Generate sampler.
-		SamplerParameters prefilterParams;
-		prefilterParams.m_textureParams.m_generateMipMaps = true;
-		prefilterParams.m_textureParams.m_wrapR = prefilterParams.m_textureParams.m_wrapS = prefilterParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
-		prefilterParams.m_textureParams.m_minFilter = SamplerFilter::FILTER_LINEAR_MIPMAP_LINEAR;
-		prefilterParams.m_textureParams.m_magFilter = SamplerFilter::FILTER_LINEAR;
-		prefilterParams.m_textureParams.m_internalPixelFormat = PixelFormat::FORMAT_RGB16F;
-		prefilterParams.m_textureParams.m_pixelFormat = PixelFormat::FORMAT_RGB;
+		if (hdriPath.empty()) return false;
 
-		// Set resolution
-		Vector2 prefilterResolution = Vector2(128, 128);
+		// Source pixels are not kept after the upload, load them again for the projection.
+		int w = 0, h = 0, nrChannels = 0;
+		float* data = ArrayBitmap::LoadImmediateHDRI(hdriPath.c_str(), w, h, nrChannels);
+		if (data == nullptr)
+		{
+			LINA_CORE_WARN("HDRI {0} could not be read for the irradiance projection, convolving the cubemap instead.", hdriPath);
+			return false;
+		}
+
+		SphericalHarmonics::ProjectEquirectangular(data, w, h, nrChannels, m_hdriIrradianceSH);
+		SphericalHarmonics::ConvolveLambert(m_hdriIrradianceSH);
+		ArrayBitmap::FreeImmediate(data);
 
-		// Construct prefilter texture.
-		m_hdriPrefilterMap.ConstructRTCubemapTexture(s_renderDevice, prefilterResolution, prefilterParams);
+		UploadHDRIIrradianceSH();
+		return true;
+	}
+
+	void RenderEngine::UploadHDRIIrradianceSH()
+	{
+		Vector4 coefficients[SH_COEFFICIENTCOUNT];
+		for (int i = 0; i < SH_COEFFICIENTCOUNT; i++)
+			coefficients[i] = Vector4(m_hdriIrradianceSH[i].x, m_hdriIrradianceSH[i].y, m_hdriIrradianceSH[i].z, 0.0f);
+
+		m_globalLightBuffer.Update(coefficients, UNIFORMBUFFER_LIGHTDATA_SHOFFSET, sizeof(Vector4) * SH_COEFFICIENTCOUNT);
+	}
 
+	void RenderEngine::CalculateHDRIPrefilter(Matrix& captureProjection, Matrix views[6])
+	{
 		// Setup shader data.
 		uint32 prefilterShader = Shader::GetShader(Shaders::HDRI_Prefilter).GetID();
 		s_renderDevice.SetShader(prefilterShader);
 		s_renderDevice.UpdateShaderUniformInt(prefilterShader, MAT_MAP_ENVIRONMENT + std::string(MAT_EXTENSION_TEXTURE2D), 0);
 		s_renderDevice.UpdateShaderUniformInt(prefilterShader, MAT_MAP_ENVIRONMENT + std::string(MAT_EXTENSION_ISACTIVE), 1);
-		s_renderDevice.UpdateShaderUniformFloat(prefilterShader, MAT_ENVIRONMENTRESOLUTION, 512.0f);
+		s_renderDevice.UpdateShaderUniformFloat(prefilterShader, MAT_ENVIRONMENTRESOLUTION, (float)SC_HDRICUBEMAPRESOLUTION);
 		s_renderDevice.UpdateShaderUniformMatrix(prefilterShader, UF_MATRIX_PROJECTION, captureProjection);
 		s_renderDevice.SetTexture(m_hdriCubemap.GetID(), m_hdriCubemap.GetSamplerID(), 0, TextureBindMode::BINDTEXTURE_CUBEMAP);
 
 		// Setup mip levels & switch fbo.
-		uint32 maxMipLevels = 5;
+		uint32 maxMipLevels = SC_HDRIPREFILTERMIPS;
 		s_renderDevice.SetFBO(m_hdriCaptureRenderTarget.GetID());
 
 		for (uint32 mip = 0; mip < maxMipLevels; ++mip)
 		{
 			// reisze framebuffer according to mip-level size.
-			unsigned int mipWidth = 128 * std::pow(0.5, mip);
-			unsigned int mipHeight = 128 * std::pow(0.5, mip);
+			unsigned int mipWidth = SC_HDRIPREFILTERRESOLUTION * std::pow(0.5, mip);
+			unsigned int mipHeight = SC_HDRIPREFILTERRESOLUTION * std::pow(0.5, mip);
 			s_renderDevice.ResizeRenderBuffer(m_hdriCaptureRenderTarget.GetID(), m_hdriCaptureRenderBuffer.GetID(), Vector2(mipWidth, mipHeight), RenderBufferStorage::STORAGE_DEPTH_COMP24);
 			s_renderDevice.SetViewport(Vector2::Zero, Vector2(mipWidth, mipHeight));
 
@@ -886,7 +1391,7 @@ namespace LinaEngine::Graphics
 		samplerParams.m_textureParams.m_pixelFormat = PixelFormat::FORMAT_RGB;
 
 		// Set resolution.
-		Vector2 brdfLutSize = Vector2(512, 512);
+		Vector2 brdfLutSize = Vector2(SC_HDRIBRDFLUTRESOLUTION, SC_HDRIBRDFLUTRESOLUTION);
 
 		// Create BRDF texture.
 		m_HDRILutMap.ConstructHDRI(s_renderDevice, samplerParams, brdfLutSize, NULL);
@@ -906,6 +1411,120 @@ namespace LinaEngine::Graphics
 		s_renderDevice.Draw(m_screenQuadVAO, m_fullscreenQuadDP, 0, 6, true);
 	}
 
+	bool RenderEngine::LoadHDRIMaps(const std::string& path, uint64 key)
+	{
+		std::vector<HDRICacheImage> images;
+		if (!HDRICache::Read(path, key, images)) return false;
+
+		// Cubemap faces, 5 prefiltered mips of each face & the irradiance coefficients.
+		if (images.size() != 7 + 6 * SC_HDRIPREFILTERMIPS || images.back().m_map != HDRICacheMap::HDRIMAP_IRRADIANCESH || images.back().m_pixels.size() != SH_COEFFICIENTCOUNT * 3)
+		{
+			LINA_CORE_WARN("HDRI cache {0} doesn't contain all maps, recomputing.", path);
+			return false;
+		}
+
+		for (HDRICacheImage& image : images)
+		{
+			if (image.m_map == HDRICacheMap::HDRIMAP_IRRADIANCESH)
+			{
+				for (int i = 0; i < SH_COEFFICIENTCOUNT; i++)
+					m_hdriIrradianceSH[i] = Vector3(glm::unpackHalf1x16(image.m_pixels[i * 3]), glm::unpackHalf1x16(image.m_pixels[i * 3 + 1]), glm::unpackHalf1x16(image.m_pixels[i * 3 + 2]));
+				continue;
+			}
+
+			Texture& texture = image.m_map == HDRICacheMap::HDRIMAP_CUBEMAP ? m_hdriCubemap : m_hdriPrefilterMap;
+			s_renderDevice.UpdateTextureLevelHalf(texture.GetID(), TextureBindMode::BINDTEXTURE_CUBEMAP, image.m_face, image.m_mip, Vector2(image.m_width, image.m_height), image.m_pixels.data(), PixelFormat::FORMAT_RGB);
+		}
+
+		s_renderDevice.GenerateTextureMipmaps(m_hdriCubemap.GetID(), TextureBindMode::BINDTEXTURE_CUBEMAP);
+		UploadHDRIIrradianceSH();
+		m_hdriUsesIrradianceSH = true;
+		LINA_CORE_TRACE("Loaded HDRI maps from {0}", path);
+		return true;
+	}
+
+	void RenderEngine::SaveHDRIMaps(const std::string& path, uint64 key)
+	{
+		std::vector<HDRICacheImage> images;
+		HDRICacheMap maps[] = { HDRICacheMap::HDRIMAP_CUBEMAP, HDRICacheMap::HDRIMAP_PREFILTER };
+		Texture* textures[] = { &m_hdriCubemap, &m_hdriPrefilterMap };
+		uint32 resolutions[] = { SC_HDRICUBEMAPRESOLUTION, SC_HDRIPREFILTERRESOLUTION };
+		uint32 mipCounts[] = { 1, SC_HDRIPREFILTERMIPS };
+
+		// Read back each face & mip, blocks until the calculation passes are done.
+		for (uint32 i = 0; i < 2; i++)
+		{
+			for (uint32 mip = 0; mip < mipCounts[i]; mip++)
+			{
+				for (uint32 face = 0; face < 6; face++)
+				{
+					HDRICacheImage image;
+					image.m_map = maps[i];
+					image.m_face = face;
+					image.m_mip = mip;
+					image.m_width = image.m_height = resolutions[i] >> mip;
+					image.m_channels = 3;
+					image.m_pixels.resize((size_t)image.m_width * image.m_height * image.m_channels);
+					s_renderDevice.GetTextureLevelHalf(textures[i]->GetID(), TextureBindMode::BINDTEXTURE_CUBEMAP, face, mip, PixelFormat::FORMAT_RGB, image.m_pixels.data());
+					images.push_back(image);
+				}
+			}
+		}
+
+		// Irradiance coefficients go last as a 9x1 image.
+		HDRICacheImage irradiance;
+		irradiance.m_map = HDRICacheMap::HDRIMAP_IRRADIANCESH;
+		irradiance.m_width = SH_COEFFICIENTCOUNT;
+		irradiance.m_height = 1;
+		irradiance.m_channels = 3;
+		for (int i = 0; i < SH_COEFFICIENTCOUNT; i++)
+		{
+			irradiance.m_pixels.push_back((uint16)glm::packHalf1x16(m_hdriIrradianceSH[i].x));
+			irradiance.m_pixels.push_back((uint16)glm::packHalf1x16(m_hdriIrradianceSH[i].y));
+			irradiance.m_pixels.push_back((uint16)glm::packHalf1x16(m_hdriIrradianceSH[i].z));
+		}
+		images.push_back(irradiance);
+
+		if (HDRICache::Write(path, key, images))
+			LINA_CORE_TRACE("Cached HDRI maps to {0}", path);
+	}
+
+	bool RenderEngine::LoadHDRIBRDF()
+	{
+		uint32 resolution = SC_HDRIBRDFLUTRESOLUTION;
+		std::vector<HDRICacheImage> images;
+		if (!HDRICache::Read(SC_HDRIBRDFLUTPATH, HDRICache::HashBytes(&resolution, sizeof(resolution)), images) || images.size() != 1)
+			return false;
+
+		SamplerParameters samplerParams;
+		samplerParams.m_textureParams.m_wrapR = samplerParams.m_textureParams.m_wrapS = samplerParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
+		samplerParams.m_textureParams.m_magFilter = SamplerFilter::FILTER_LINEAR;
+		samplerParams.m_textureParams.m_minFilter = SamplerFilter::FILTER_LINEAR;
+		samplerParams.m_textureParams.m_internalPixelFormat = PixelFormat::FORMAT_RGB16F;
+		samplerParams.m_textureParams.m_pixelFormat = PixelFormat::FORMAT_RGB;
+
+		// The asset only stores the two channels the shaders read.
+		Vector2 brdfLutSize = Vector2(images[0].m_width, images[0].m_height);
+		m_HDRILutMap.ConstructHDRI(s_renderDevice, samplerParams, brdfLutSize, NULL);
+		s_renderDevice.UpdateTextureLevelHalf(m_HDRILutMap.GetID(), TextureBindMode::BINDTEXTURE_TEXTURE2D, 0, 0, brdfLutSize, images[0].m_pixels.data(), PixelFormat::FORMAT_RG);
+		return true;
+	}
+
+	void RenderEngine::SaveHDRIBRDF()
+	{
+		uint32 resolution = SC_HDRIBRDFLUTRESOLUTION;
+		HDRICacheImage image;
+		image.m_map = HDRICacheMap::HDRIMAP_BRDFLUT;
+		image.m_width = image.m_height = resolution;
+		image.m_channels = 2;
+		image.m_pixels.resize((size_t)image.m_width * image.m_height * image.m_channels);
+		s_renderDevice.GetTextureLevelHalf(m_HDRILutMap.GetID(), TextureBindMode::BINDTEXTURE_TEXTURE2D, 0, 0, PixelFormat::FORMAT_RG, image.m_pixels.data());
+
+		std::vector<HDRICacheImage> images;
+		images.push_back(image);
+		HDRICache::Write(SC_HDRIBRDFLUTPATH, HDRICache::HashBytes(&resolution, sizeof(resolution)), images);
+	}
+
 	void RenderEngine::SetHDRIData(Material* mat)
 	{
 		if (mat == nullptr)
@@ -920,7 +1539,13 @@ namespace LinaEngine::Graphics
 			return;
 		}
 
-		mat->SetTexture(MAT_TEXTURE2D_IRRADIANCEMAP, &m_hdriIrradianceMap, TextureBindMode::BINDTEXTURE_CUBEMAP);
+		// SH coefficients live in the light buffer, the irradiance cubemap is only bound on the fallback path.
+		if (m_hdriUsesIrradianceSH)
+			mat->RemoveTexture(MAT_TEXTURE2D_IRRADIANCEMAP);
+		else
+			mat->SetTexture(MAT_TEXTURE2D_IRRADIANCEMAP, &m_hdriIrradianceMap, TextureBindMode::BINDTEXTURE_CUBEMAP);
+
+		mat->SetBool(MAT_IRRADIANCESH, m_hdriUsesIrradianceSH);
 		mat->SetTexture(MAT_TEXTURE2D_BRDFLUTMAP, &m_HDRILutMap, TextureBindMode::BINDTEXTURE_TEXTURE2D);
 		mat->SetTexture(MAT_TEXTURE2D_PREFILTERMAP, &m_hdriPrefilterMap, TextureBindMode::BINDTEXTURE_CUBEMAP);
 	}
@@ -936,6 +1561,7 @@ namespace LinaEngine::Graphics
 		mat->RemoveTexture(MAT_TEXTURE2D_IRRADIANCEMAP);
 		mat->RemoveTexture(MAT_TEXTURE2D_BRDFLUTMAP);	
 		mat->RemoveTexture(MAT_TEXTURE2D_PREFILTERMAP);
+		mat->SetBool(MAT_IRRADIANCESH, false);
 
 	}
 
@@ -968,8 +1594,24 @@ namespace LinaEngine::Graphics
 		// Update pipeline.
 		m_renderingPipeline.UpdateSystems(0.0f);
 
+		// Rasterize the occluders before any view is drawn.
+		UpdateOcclusion();
+
 		// Update uniform buffers on GPU
 		UpdateUniformBuffers();
 	}
 
+	void RenderEngine::UpdateOcclusion()
+	{
+		// Starting a frame w/o occluders keeps the stats empty while disabled.
+		m_occlusionCuller.Begin(GetMainView());
+		if (!m_renderSettings.m_occlusionCullingEnabled) return;
+
+		const std::vector<Occluder>& occluders = m_meshRendererSystem.GetOccluders();
+		for (const Occluder& occluder : occluders)
+			m_occlusionCuller.AddOccluder(*occluder.m_geometry, occluder.m_model);
+
+		m_occlusionCuller.End();
+	}
+
 }
\ No newline at end of file
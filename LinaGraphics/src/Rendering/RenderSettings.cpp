@@ -27,6 +27,8 @@ SOFTWARE.
 */
 
 #include "Rendering/RenderSettings.hpp"
+#include "Utility/Log.hpp"
+#include "Utility/UtilityFunctions.hpp"
 #include <stdio.h>
 #include <cereal/archives/binary.hpp>
 #include <fstream>
@@ -37,6 +39,7 @@ namespace LinaEngine::Graphics
 	{
 		std::ofstream stream(path + "/" + fileName + ".rendersettings");
 		{
+			Utility::WriteVersionTag(stream);
 			cereal::BinaryOutputArchive oarchive(stream);
 			oarchive(settings);
 		}
@@ -47,9 +50,23 @@ namespace LinaEngine::Graphics
 		RenderSettings settings;
 
 		std::ifstream stream(path + "/" + fileName + ".rendersettings");
+
+		try
 		{
+			bool versioned = Utility::ReadVersionTag(stream);
 			cereal::BinaryInputArchive iarchive(stream);
-			iarchive(settings);
+
+			// Files without the tag were written before the settings were versioned.
+			if (versioned)
+				iarchive(settings);
+			else
+				settings.serialize(iarchive, 0);
+		}
+		catch (const std::exception& e)
+		{
+			// Unreadable settings file, fall back to the defaults.
+			LINA_CORE_WARN("Render settings {0} could not be read, using defaults. {1}", fileName, e.what());
+			return RenderSettings();
 		}
 
 		return settings;
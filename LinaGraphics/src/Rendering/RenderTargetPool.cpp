@@ -0,0 +1,98 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Rendering/RenderTargetPool.hpp"
+
+namespace LinaEngine::Graphics
+{
+	static bool ParamsMatch(const SamplerParameters& a, const SamplerParameters& b)
+	{
+		const TextureParameters& ta = a.m_textureParams;
+		const TextureParameters& tb = b.m_textureParams;
+		return ta.m_pixelFormat == tb.m_pixelFormat && ta.m_internalPixelFormat == tb.m_internalPixelFormat && ta.m_minFilter == tb.m_minFilter
+			&& ta.m_magFilter == tb.m_magFilter && ta.m_wrapS == tb.m_wrapS && ta.m_wrapT == tb.m_wrapT;
+	}
+
+	PooledRenderTarget* RenderTargetPool::Acquire(const Vector2& size, const SamplerParameters& params)
+	{
+		// Reuse a free target if there is one.
+		for (PooledRenderTarget* target : m_targets)
+		{
+			if (!target->m_inUse && target->m_size.x == size.x && target->m_size.y == size.y && ParamsMatch(target->m_params, params))
+			{
+				target->m_inUse = true;
+				target->m_lastUsedFrame = m_frame;
+				return target;
+			}
+		}
+
+		// Create a new one.
+		PooledRenderTarget* target = new PooledRenderTarget();
+		target->m_texture.ConstructRTTexture(*m_renderDevice, size, params, false);
+		target->m_target.Construct(*m_renderDevice, target->m_texture, size, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR);
+		target->m_size = size;
+		target->m_params = params;
+		target->m_inUse = true;
+		target->m_lastUsedFrame = m_frame;
+		m_targets.push_back(target);
+		return target;
+	}
+
+	void RenderTargetPool::Release(PooledRenderTarget* target)
+	{
+		if (target == nullptr) return;
+		target->m_inUse = false;
+	}
+
+	void RenderTargetPool::EndFrame()
+	{
+		// Drop the targets that stopped being requested, e.g. sizes before a viewport resize.
+		for (std::vector<PooledRenderTarget*>::iterator it = m_targets.begin(); it != m_targets.end();)
+		{
+			PooledRenderTarget* target = *it;
+			if (!target->m_inUse && m_frame - target->m_lastUsedFrame > RTPOOL_MAXIDLEFRAMES)
+			{
+				delete target;
+				it = m_targets.erase(it);
+			}
+			else
+				++it;
+		}
+
+		m_frame++;
+	}
+
+	void RenderTargetPool::Clear()
+	{
+		for (PooledRenderTarget* target : m_targets)
+			delete target;
+
+		m_targets.clear();
+	}
+}
@@ -30,7 +30,7 @@ SOFTWARE.
 
 namespace LinaEngine::Graphics
 {
-	char* g_shadersStr[18]
+	char* g_shadersStr[19]
 	{
 		"Standard Unlit",
 		"Skybox Single Color",
@@ -49,7 +49,8 @@ namespace LinaEngine::Graphics
 		"Screen Quad Shadowmap",
 		"Debug Line",
 		"Sprite",
-		"Skybox Atmospheric"
+		"Skybox Atmospheric",
+		"Sprite Batch"
 	};
 
 	char* g_materialSurfaceTypeStr[2]
@@ -28,20 +28,23 @@ SOFTWARE.
 
 #include "Rendering/Shader.hpp"
 #include "Rendering/RenderEngine.hpp"
-#include "Utility/UtilityFunctions.hpp"
 
 namespace LinaEngine::Graphics
 {
 	std::map<int, Shader> Shader::s_loadedShaders;
+	uint32 Shader::s_generation = 0;
 
-	Shader& Shader::CreateShader(Shaders shader, const std::string& path, bool usesGeometryShader)
+	Shader& Shader::CreateShader(Shaders shader, const std::string& path, bool usesGeometryShader, bool deferCompile)
 	{
 		// Create shader
 		if (!ShaderExists(shader))
 		{
-			std::string shaderText;
-			Utility::LoadTextFileWithIncludes(shaderText, path, "#include");
-			return s_loadedShaders[shader].Construct(RenderEngine::GetRenderDevice(), shaderText, usesGeometryShader);
+			Shader& created = s_loadedShaders[shader].ConstructDeferred(RenderEngine::GetRenderDevice(), path, usesGeometryShader);
+
+			if (!deferCompile)
+				created.GetID();
+
+			return created;
 		}
 		else
 		{
@@ -51,6 +54,105 @@ namespace LinaEngine::Graphics
 		}
 	}
 
+	void Shader::SetUniformInt(const std::string& name, int value)
+	{
+		m_intUniforms.push_back(std::make_pair(name, value));
+
+		for (std::map<uint32, uint32>::iterator it = m_variants.begin(); it != m_variants.end(); ++it)
+		{
+			s_renderDevice->SetShader(it->second);
+			s_renderDevice->UpdateShaderUniformInt(it->second, name, value);
+		}
+	}
+
+	uint32 Shader::GetVariant(uint32 keywordMask)
+	{
+		std::map<uint32, uint32>::iterator it = m_variants.find(keywordMask);
+		if (it != m_variants.end())
+			return it->second;
+
+		if (!LoadSource()) return 0;
+
+		// Defines go before the source, the device prepends the version & stage defines.
+		std::string defines = "";
+		for (uint32 i = 0; i < m_keywords.size(); i++)
+		{
+			if (keywordMask & (1u << i))
+				defines += "#define " + m_keywords[i].m_define + "\n";
+		}
+
+		uint32 program = s_renderDevice->CreateShaderProgram(defines + m_source, m_usesGeometryShader);
+		m_variants[keywordMask] = program;
+
+		for (std::pair<uint32, std::string>& binding : m_blockBindings)
+			s_renderDevice->BindShaderBlockToBufferPoint(program, binding.first, binding.second);
+
+		if (!m_intUniforms.empty())
+		{
+			s_renderDevice->SetShader(program);
+			for (std::pair<std::string, int>& uniform : m_intUniforms)
+				s_renderDevice->UpdateShaderUniformInt(program, uniform.first, uniform.second);
+		}
+
+		LINA_CORE_TRACE("Compiled shader variant {0} of {1}", keywordMask, m_path);
+		return program;
+	}
+
+	const std::vector<ShaderKeyword>& Shader::GetKeywords()
+	{
+		LoadSource();
+		return m_keywords;
+	}
+
+	void Shader::ReleaseVariants()
+	{
+		for (std::map<uint32, uint32>::iterator it = m_variants.begin(); it != m_variants.end(); ++it)
+			s_renderDevice->ReleaseShaderProgram(it->second);
+
+		m_variants.clear();
+	}
+
+	bool Shader::LoadSource()
+	{
+		if (m_sourceLoaded) return true;
+
+		m_source = "";
+		m_keywords.clear();
+		if (!ShaderSourceCache::Resolve(m_path, m_source, m_keywords))
+		{
+			LINA_CORE_ERR("Shader source could not be resolved! {0}", m_path);
+			return false;
+		}
+
+		if (m_keywords.size() > SHADER_MAX_KEYWORDS)
+		{
+			LINA_CORE_WARN("Shader {0} declares {1} keywords, only the first {2} are used.", m_path, m_keywords.size(), SHADER_MAX_KEYWORDS);
+			m_keywords.resize(SHADER_MAX_KEYWORDS);
+		}
+
+		m_sourceLoaded = true;
+		return true;
+	}
+
+	void Shader::ReloadSource(const std::string& path)
+	{
+		std::set<std::string> affected;
+		ShaderSourceCache::Invalidate(path, affected);
+
+		// Only shaders built from the affected files drop their variants.
+		for (std::map<int, Shader>::iterator it = s_loadedShaders.begin(); it != s_loadedShaders.end(); ++it)
+		{
+			Shader& shader = it->second;
+			if (affected.find(ShaderSourceCache::NormalizePath(shader.m_path)) == affected.end()) continue;
+
+			shader.ReleaseVariants();
+			shader.m_sourceLoaded = false;
+			LINA_CORE_TRACE("Shader {0} will be recompiled.", shader.m_path);
+		}
+
+		s_generation++;
+	}
+
 	Shader& Shader::GetShader(Shaders shader)
 	{
 		if (!ShaderExists(shader))
@@ -67,4 +169,4 @@ namespace LinaEngine::Graphics
 	{
 		return !(s_loadedShaders.find(shader) == s_loadedShaders.end());
 	}
-}
\ No newline at end of file
+}
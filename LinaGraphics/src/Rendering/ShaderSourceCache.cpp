@@ -0,0 +1,173 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Rendering/ShaderSourceCache.hpp"
+#include "Utility/Log.hpp"
+#include "Utility/UtilityFunctions.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace LinaEngine::Graphics
+{
+	std::map<std::string, ShaderSourceCache::SourceFile> ShaderSourceCache::s_files;
+	std::map<std::string, std::set<std::string>> ShaderSourceCache::s_includedBy;
+
+	bool ShaderSourceCache::Resolve(const std::string& path, std::string& output, std::vector<ShaderKeyword>& keywords)
+	{
+		std::vector<std::string> includeStack;
+		std::string text;
+		if (!Append(NormalizePath(path), text, keywords, includeStack))
+			return false;
+
+		output = text;
+		return true;
+	}
+
+	void ShaderSourceCache::Invalidate(const std::string& path, std::set<std::string>& affected)
+	{
+		// Walk the includers depth first, a file may be reached through several paths.
+		std::vector<std::string> open;
+		open.push_back(NormalizePath(path));
+		while (!open.empty())
+		{
+			std::string file = open.back();
+			open.pop_back();
+			if (!affected.insert(file).second) continue;
+
+			s_files.erase(file);
+			std::map<std::string, std::set<std::string>>::iterator it = s_includedBy.find(file);
+			if (it != s_includedBy.end())
+				open.insert(open.end(), it->second.begin(), it->second.end());
+		}
+	}
+
+	std::string ShaderSourceCache::NormalizePath(const std::string& path)
+	{
+		return std::filesystem::path(path).lexically_normal().generic_string();
+	}
+
+	void ShaderSourceCache::Clear()
+	{
+		s_files.clear();
+		s_includedBy.clear();
+	}
+
+	ShaderSourceCache::SourceFile* ShaderSourceCache::Load(const std::string& path)
+	{
+		std::map<std::string, SourceFile>::iterator it = s_files.find(path);
+		if (it != s_files.end())
+			return &it->second;
+
+		std::ifstream file(path.c_str());
+		if (!file.is_open())
+		{
+			LINA_CORE_ERR("File could not be loaded! {0}", path);
+			return nullptr;
+		}
+
+		// Split the file into plain lines & includes, keyword declarations are not passed to GL.
+		SourceFile& source = s_files[path];
+		std::string filePath = Utility::GetFilePath(path);
+		std::string line;
+		while (file.good())
+		{
+			getline(file, line);
+			SourceLine sourceLine;
+
+			if (line.find(SHADER_VARIANT_PRAGMA) != std::string::npos)
+			{
+				std::stringstream declaration(line.substr(line.find(SHADER_VARIANT_PRAGMA) + std::string(SHADER_VARIANT_PRAGMA).length()));
+				ShaderKeyword keyword;
+				declaration >> keyword.m_define >> keyword.m_parameter;
+				if (!keyword.m_parameter.empty())
+					source.m_keywords.push_back(keyword);
+				else
+				{
+					LINA_CORE_WARN("Variant declaration in {0} needs a define & a material parameter: {1}", path, line);
+				}
+				continue;
+			}
+			else if (line.find("#include") != std::string::npos)
+			{
+				std::string includeFileName = Utility::Split(line, ' ')[1];
+				includeFileName = includeFileName.substr(1, includeFileName.length() - 2);
+				sourceLine.m_text = NormalizePath(filePath + includeFileName);
+				sourceLine.m_isInclude = true;
+				s_includedBy[sourceLine.m_text].insert(path);
+			}
+			else
+				sourceLine.m_text = line;
+
+			source.m_lines.push_back(sourceLine);
+		}
+
+		return &source;
+	}
+
+	bool ShaderSourceCache::Append(const std::string& path, std::string& output, std::vector<ShaderKeyword>& keywords, std::vector<std::string>& includeStack)
+	{
+		// Files are included each time they are referenced, only cycles are rejected.
+		if (std::find(includeStack.begin(), includeStack.end(), path) != includeStack.end())
+		{
+			LINA_CORE_ERR("Shader include cycle detected at {0}", path);
+			return false;
+		}
+
+		SourceFile* source = Load(path);
+		if (source == nullptr) return false;
+
+		for (const ShaderKeyword& keyword : source->m_keywords)
+		{
+			bool exists = false;
+			for (const ShaderKeyword& existing : keywords)
+				exists |= existing.m_define == keyword.m_define;
+
+			if (!exists)
+				keywords.push_back(keyword);
+		}
+
+		includeStack.push_back(path);
+		for (const SourceLine& line : source->m_lines)
+		{
+			if (!line.m_isInclude)
+				output += line.m_text + "\n";
+			else
+			{
+				std::string included;
+				Append(line.m_text, included, keywords, includeStack);
+				output += included + "\n";
+			}
+		}
+		includeStack.pop_back();
+
+		return true;
+	}
+}
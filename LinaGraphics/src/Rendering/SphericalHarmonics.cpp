@@ -0,0 +1,187 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Rendering/SphericalHarmonics.hpp"
+#include <emmintrin.h>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace LinaEngine::Graphics
+{
+	// Constant factors of the real basis functions.
+	constexpr float SH_Y0 = 0.282095f;
+	constexpr float SH_Y1 = 0.488603f;
+	constexpr float SH_Y2 = 1.092548f;
+	constexpr float SH_Y20 = 0.315392f;
+	constexpr float SH_Y22 = 0.546274f;
+	constexpr double SH_PI = 3.14159265358979323846;
+
+	void SphericalHarmonics::ProjectEquirectangular(const float* pixels, int width, int height, int channels, Vector3 coefficients[SH_COEFFICIENTCOUNT])
+	{
+		for (int i = 0; i < SH_COEFFICIENTCOUNT; i++)
+			coefficients[i] = Vector3::Zero;
+
+		if (pixels == nullptr || width <= 0 || height <= 0 || channels < 3) return;
+
+		// Longitude only depends on the column, shared by all rows.
+		std::vector<float> cosPhi(width), sinPhi(width);
+		for (int x = 0; x < width; x++)
+		{
+			double phi = ((x + 0.5) / width - 0.5) * 2.0 * SH_PI;
+			cosPhi[x] = (float)std::cos(phi);
+			sinPhi[x] = (float)std::sin(phi);
+		}
+
+		// Each thread sums an equal band of rows, bands are merged afterwards.
+		int threadCount = std::max(1, std::min((int)std::thread::hardware_concurrency(), height));
+		std::vector<double> sums((size_t)threadCount * SH_COEFFICIENTCOUNT * 3, 0.0);
+		std::vector<std::thread> threads;
+		int rowsPerThread = (height + threadCount - 1) / threadCount;
+		for (int i = 0; i < threadCount; i++)
+		{
+			int rowBegin = i * rowsPerThread;
+			int rowEnd = std::min(height, rowBegin + rowsPerThread);
+			threads.push_back(std::thread(&SphericalHarmonics::ProjectRows, pixels, width, height, channels, rowBegin, rowEnd, cosPhi.data(), sinPhi.data(), &sums[(size_t)i * SH_COEFFICIENTCOUNT * 3]));
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		for (int i = 0; i < threadCount; i++)
+		{
+			const double* band = &sums[(size_t)i * SH_COEFFICIENTCOUNT * 3];
+			for (int c = 0; c < SH_COEFFICIENTCOUNT; c++)
+				coefficients[c] += Vector3((float)band[c * 3], (float)band[c * 3 + 1], (float)band[c * 3 + 2]);
+		}
+	}
+
+	void SphericalHarmonics::ProjectRows(const float* pixels, int width, int height, int channels, int rowBegin, int rowEnd, const float* cosPhi, const float* sinPhi, double* sums)
+	{
+		// Solid angle of a texel is cos(latitude) * dLatitude * dLongitude.
+		const double texelArea = (2.0 * SH_PI / width) * (SH_PI / height);
+
+		for (int y = rowBegin; y < rowEnd; y++)
+		{
+			double latitude = ((y + 0.5) / height - 0.5) * SH_PI;
+			float cosLat = (float)std::cos(latitude);
+			float sinLat = (float)std::sin(latitude);
+			float weight = (float)(texelArea * cosLat);
+			const float* row = pixels + (size_t)y * width * channels;
+
+			// Basis values times weighted radiance, 4 columns per lane set.
+			__m128 acc[SH_COEFFICIENTCOUNT][3];
+			for (int c = 0; c < SH_COEFFICIENTCOUNT; c++)
+				acc[c][0] = acc[c][1] = acc[c][2] = _mm_setzero_ps();
+
+			const __m128 dirY = _mm_set1_ps(sinLat);
+			const __m128 cosLat4 = _mm_set1_ps(cosLat);
+			const __m128 weight4 = _mm_set1_ps(weight);
+			const __m128 one = _mm_set1_ps(1.0f);
+			const __m128 three = _mm_set1_ps(3.0f);
+
+			int x = 0;
+			for (; x + 4 <= width; x += 4)
+			{
+				__m128 dirX = _mm_mul_ps(cosLat4, _mm_loadu_ps(cosPhi + x));
+				__m128 dirZ = _mm_mul_ps(cosLat4, _mm_loadu_ps(sinPhi + x));
+
+				const float* p = row + (size_t)x * channels;
+				__m128 color[3];
+				for (int ch = 0; ch < 3; ch++)
+					color[ch] = _mm_mul_ps(weight4, _mm_set_ps(p[3 * channels + ch], p[2 * channels + ch], p[channels + ch], p[ch]));
+
+				__m128 basis[SH_COEFFICIENTCOUNT];
+				basis[0] = _mm_set1_ps(SH_Y0);
+				basis[1] = _mm_mul_ps(_mm_set1_ps(SH_Y1), dirY);
+				basis[2] = _mm_mul_ps(_mm_set1_ps(SH_Y1), dirZ);
+				basis[3] = _mm_mul_ps(_mm_set1_ps(SH_Y1), dirX);
+				basis[4] = _mm_mul_ps(_mm_set1_ps(SH_Y2), _mm_mul_ps(dirX, dirY));
+				basis[5] = _mm_mul_ps(_mm_set1_ps(SH_Y2), _mm_mul_ps(dirY, dirZ));
+				basis[6] = _mm_mul_ps(_mm_set1_ps(SH_Y20), _mm_sub_ps(_mm_mul_ps(three, _mm_mul_ps(dirZ, dirZ)), one));
+				basis[7] = _mm_mul_ps(_mm_set1_ps(SH_Y2), _mm_mul_ps(dirX, dirZ));
+				basis[8] = _mm_mul_ps(_mm_set1_ps(SH_Y22), _mm_sub_ps(_mm_mul_ps(dirX, dirX), _mm_mul_ps(dirY, dirY)));
+
+				for (int c = 0; c < SH_COEFFICIENTCOUNT; c++)
+				{
+					acc[c][0] = _mm_add_ps(acc[c][0], _mm_mul_ps(basis[c], color[0]));
+					acc[c][1] = _mm_add_ps(acc[c][1], _mm_mul_ps(basis[c], color[1]));
+					acc[c][2] = _mm_add_ps(acc[c][2], _mm_mul_ps(basis[c], color[2]));
+				}
+			}
+
+			// Reduce the lanes of the row into the band's sums.
+			for (int c = 0; c < SH_COEFFICIENTCOUNT; c++)
+			{
+				for (int ch = 0; ch < 3; ch++)
+				{
+					float lanes[4];
+					_mm_storeu_ps(lanes, acc[c][ch]);
+					sums[c * 3 + ch] += (double)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+				}
+			}
+
+			// Remaining columns.
+			for (; x < width; x++)
+			{
+				float dx = cosLat * cosPhi[x];
+				float dz = cosLat * sinPhi[x];
+				float dy = sinLat;
+				float basis[SH_COEFFICIENTCOUNT] = { SH_Y0, SH_Y1 * dy, SH_Y1 * dz, SH_Y1 * dx, SH_Y2 * dx * dy, SH_Y2 * dy * dz, SH_Y20 * (3.0f * dz * dz - 1.0f), SH_Y2 * dx * dz, SH_Y22 * (dx * dx - dy * dy) };
+				const float* p = row + (size_t)x * channels;
+				for (int c = 0; c < SH_COEFFICIENTCOUNT; c++)
+				{
+					for (int ch = 0; ch < 3; ch++)
+						sums[c * 3 + ch] += (double)basis[c] * weight * p[ch];
+				}
+			}
+		}
+	}
+
+	void SphericalHarmonics::ConvolveLambert(Vector3 coefficients[SH_COEFFICIENTCOUNT])
+	{
+		// Band factors of the clamped cosine are PI, 2PI / 3 & PI / 4, divided by PI.
+		const float bandFactors[SH_COEFFICIENTCOUNT] = { 1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f };
+		for (int i = 0; i < SH_COEFFICIENTCOUNT; i++)
+			coefficients[i] *= bandFactors[i];
+	}
+
+	Vector3 SphericalHarmonics::Evaluate(const Vector3 coefficients[SH_COEFFICIENTCOUNT], const Vector3& direction)
+	{
+		float x = direction.x, y = direction.y, z = direction.z;
+		float basis[SH_COEFFICIENTCOUNT] = { SH_Y0, SH_Y1 * y, SH_Y1 * z, SH_Y1 * x, SH_Y2 * x * y, SH_Y2 * y * z, SH_Y20 * (3.0f * z * z - 1.0f), SH_Y2 * x * z, SH_Y22 * (x * x - y * y) };
+
+		Vector3 result = Vector3::Zero;
+		for (int i = 0; i < SH_COEFFICIENTCOUNT; i++)
+			result += coefficients[i] * basis[i];
+
+		return result;
+	}
+}
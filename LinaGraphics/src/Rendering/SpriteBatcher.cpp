@@ -0,0 +1,246 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "Rendering/SpriteBatcher.hpp"
+#include "Rendering/RenderEngine.hpp"
+#include "Rendering/ArrayBitmap.hpp"
+#include <algorithm>
+
+namespace LinaEngine::Graphics
+{
+	// Corners of the sprite quad & their tex coords, same as the quad model of the sprite renderers.
+	static const float s_quadPositions[4][2] = { { -0.5f, 0.5f }, { -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f } };
+	static const float s_quadTexCoords[4][2] = { { 1.0f, 1.0f }, { 1.0f, 0.0f }, { 0.0f, 0.0f }, { 0.0f, 1.0f } };
+
+	void SpriteBatcher::Construct(RenderDevice& renderDevice)
+	{
+		m_renderDevice = &renderDevice;
+
+		// The quads never change their indices, only the vertices are streamed.
+		std::vector<uint16> indices;
+		indices.reserve(SPRITEBATCH_MAXSPRITES * 6);
+		for (uint32 i = 0; i < SPRITEBATCH_MAXSPRITES; i++)
+		{
+			uint16 first = (uint16)(i * 4);
+			uint16 quad[6] = { first, (uint16)(first + 1), (uint16)(first + 2), (uint16)(first + 2), (uint16)(first + 3), first };
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+
+		VertexAttribute attributes[3];
+		attributes[0].m_location = 0;
+		attributes[0].m_components = 3;
+		attributes[0].m_offset = offsetof(SpriteVertex, m_position);
+		attributes[1].m_location = 1;
+		attributes[1].m_components = 2;
+		attributes[1].m_offset = offsetof(SpriteVertex, m_texCoords);
+		attributes[2].m_location = 2;
+		attributes[2].m_components = 4;
+		attributes[2].m_offset = offsetof(SpriteVertex, m_color);
+
+		m_vertexArray = m_renderDevice->CreateInterleavedVertexArray(nullptr, sizeof(SpriteVertex), attributes, 3, SPRITEBATCH_MAXSPRITES * 4, nullptr, 0, 0, &indices[0], (uint32)indices.size(), true, BufferUsage::USAGE_STREAM_DRAW);
+	}
+
+	void SpriteBatcher::Release()
+	{
+		for (AtlasPage* page : m_pages)
+			delete page;
+
+		m_pages.clear();
+		m_entries.clear();
+		m_sprites.clear();
+		m_batches.clear();
+
+		if (m_renderDevice != nullptr && m_vertexArray != 0)
+			m_vertexArray = m_renderDevice->ReleaseVertexArray(m_vertexArray);
+	}
+
+	bool SpriteBatcher::GetAtlasEntry(Texture* texture, SpriteAtlasEntry& entry)
+	{
+		if (texture == nullptr || m_vertexArray == 0) return false;
+
+		// Textures that could not be packed are remembered w/ an invalid page.
+		std::map<uint32, SpriteAtlasEntry>::iterator it = m_entries.find(texture->GetID());
+		if (it != m_entries.end())
+		{
+			entry = it->second;
+			return entry.m_page != -1;
+		}
+
+		SpriteAtlasEntry& newEntry = m_entries[texture->GetID()];
+
+		// GL textures can not be read back cheaply, the pixels are loaded from the source file again.
+		ArrayBitmap bitmap;
+		if (texture->GetPath().empty() || bitmap.Load(texture->GetPath()) < 0)
+			return false;
+
+		int width = bitmap.GetWidth();
+		int height = bitmap.GetHeight();
+		stbrp_rect rect;
+		rect.id = 0;
+		rect.w = width + SPRITEATLAS_PADDING * 2;
+		rect.h = height + SPRITEATLAS_PADDING * 2;
+		if (rect.w > SPRITEATLAS_PAGESIZE || rect.h > SPRITEATLAS_PAGESIZE)
+		{
+			LINA_CORE_WARN("Texture {0} is larger than a sprite atlas page, sprites using it will not be batched.", texture->GetPath());
+			return false;
+		}
+
+		// Try the existing pages first, open a new page if none has room.
+		int page = -1;
+		for (size_t i = 0; i < m_pages.size() && page == -1; i++)
+		{
+			if (stbrp_pack_rects(&m_pages[i]->m_context, &rect, 1) && rect.was_packed)
+				page = (int)i;
+		}
+
+		if (page == -1)
+		{
+			page = AddPage();
+			stbrp_pack_rects(&m_pages[page]->m_context, &rect, 1);
+		}
+
+		// Copy the pixels inside the padding & inset the uvs by half a texel.
+		Vector2 offset = Vector2((float)(rect.x + SPRITEATLAS_PADDING), (float)(rect.y + SPRITEATLAS_PADDING));
+		m_renderDevice->UpdateTexture2DRegion(m_pages[page]->m_texture.GetID(), offset, Vector2((float)width, (float)height), bitmap.GetPixelArray());
+
+		const float texel = 1.0f / (float)SPRITEATLAS_PAGESIZE;
+		newEntry.m_page = page;
+		newEntry.m_uvRect = Vector4((offset.x + 0.5f) * texel, (offset.y + 0.5f) * texel, (offset.x + width - 0.5f) * texel, (offset.y + height - 0.5f) * texel);
+		entry = newEntry;
+		m_stats.m_pages = (uint32)m_pages.size();
+		return true;
+	}
+
+	int SpriteBatcher::AddPage()
+	{
+		AtlasPage* page = new AtlasPage();
+		page->m_nodes.resize(SPRITEATLAS_PAGESIZE);
+		stbrp_init_target(&page->m_context, SPRITEATLAS_PAGESIZE, SPRITEATLAS_PAGESIZE, &page->m_nodes[0], (int)page->m_nodes.size());
+
+		// No mipmaps, lower levels would mix the neighbouring textures.
+		SamplerParameters samplerParams;
+		samplerParams.m_textureParams.m_minFilter = SamplerFilter::FILTER_LINEAR;
+		samplerParams.m_textureParams.m_wrapS = SamplerWrapMode::WRAP_CLAMP_EDGE;
+		samplerParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
+		page->m_texture.ConstructRTTexture(*m_renderDevice, Vector2((float)SPRITEATLAS_PAGESIZE, (float)SPRITEATLAS_PAGESIZE), samplerParams);
+
+		Material::SetMaterialShader(page->m_material, Shaders::Standard_SpriteBatch);
+		page->m_material.SetTexture(MAT_TEXTURE2D_DIFFUSE, &page->m_texture);
+
+		m_pages.push_back(page);
+		return (int)m_pages.size() - 1;
+	}
+
+	void SpriteBatcher::Begin()
+	{
+		m_sprites.clear();
+	}
+
+	bool SpriteBatcher::Add(const Matrix& model, const Color& color, int layer, const SpriteAtlasEntry& entry)
+	{
+		if (m_sprites.size() >= SPRITEBATCH_MAXSPRITES || entry.m_page == -1) return false;
+
+		Sprite sprite;
+		sprite.m_model = model;
+		sprite.m_color = color;
+		sprite.m_layer = layer;
+		sprite.m_entry = entry;
+		m_sprites.push_back(sprite);
+		return true;
+	}
+
+	void SpriteBatcher::End()
+	{
+		m_batches.clear();
+		m_vertices.clear();
+
+		// Lower layers are drawn first, sprites of a layer are grouped by their page & keep their order otherwise.
+		m_order.resize(m_sprites.size());
+		for (uint32 i = 0; i < (uint32)m_order.size(); i++)
+			m_order[i] = i;
+
+		std::stable_sort(m_order.begin(), m_order.end(), [this](uint32 lhs, uint32 rhs)
+		{
+			const Sprite& l = m_sprites[lhs];
+			const Sprite& r = m_sprites[rhs];
+			return l.m_layer != r.m_layer ? l.m_layer < r.m_layer : l.m_entry.m_page < r.m_entry.m_page;
+		});
+
+		// Expand each sprite into a world space quad, a new batch starts whenever the page changes.
+		m_vertices.reserve(m_sprites.size() * 4);
+		for (uint32 index : m_order)
+		{
+			const Sprite& sprite = m_sprites[index];
+			const Vector4& uv = sprite.m_entry.m_uvRect;
+
+			for (int i = 0; i < 4; i++)
+			{
+				Vector4 position = sprite.m_model * Vector4(s_quadPositions[i][0], s_quadPositions[i][1], 0.0f, 1.0f);
+				SpriteVertex vertex;
+				vertex.m_position[0] = position.x;
+				vertex.m_position[1] = position.y;
+				vertex.m_position[2] = position.z;
+				vertex.m_texCoords[0] = uv.x + s_quadTexCoords[i][0] * (uv.z - uv.x);
+				vertex.m_texCoords[1] = uv.y + s_quadTexCoords[i][1] * (uv.w - uv.y);
+				vertex.m_color[0] = sprite.m_color.r;
+				vertex.m_color[1] = sprite.m_color.g;
+				vertex.m_color[2] = sprite.m_color.b;
+				vertex.m_color[3] = 1.0f;
+				m_vertices.push_back(vertex);
+			}
+
+			if (m_batches.size() == 0 || m_batches.back().m_page != sprite.m_entry.m_page)
+			{
+				SpriteBatch batch;
+				batch.m_page = sprite.m_entry.m_page;
+				batch.m_firstIndex = (uint32)(m_vertices.size() / 4 - 1) * 6;
+				m_batches.push_back(batch);
+			}
+
+			m_batches.back().m_indexCount += 6;
+		}
+
+		if (m_vertices.size() > 0)
+			m_renderDevice->UpdateVertexArrayBuffer(m_vertexArray, 0, &m_vertices[0], m_vertices.size() * sizeof(SpriteVertex));
+
+		m_stats.m_sprites = (uint32)m_sprites.size();
+		m_stats.m_batches = (uint32)m_batches.size();
+		m_stats.m_pages = (uint32)m_pages.size();
+	}
+
+	void SpriteBatcher::Draw(RenderEngine& renderEngine, DrawParams& drawParams)
+	{
+		for (const SpriteBatch& batch : m_batches)
+		{
+			renderEngine.UpdateShaderData(&m_pages[batch.m_page]->m_material);
+			m_renderDevice->Draw(m_vertexArray, drawParams, 1, batch.m_indexCount, false, batch.m_firstIndex);
+		}
+	}
+}
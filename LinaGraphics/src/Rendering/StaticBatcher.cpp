@@ -0,0 +1,336 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Rendering/StaticBatcher.hpp"
+#include "Rendering/Mesh.hpp"
+#include "Rendering/VertexArray.hpp"
+#include "Utility/UtilityFunctions.hpp"
+#include "Utility/Math/Math.hpp"
+#include <cereal/archives/binary.hpp>
+#include <fstream>
+#include <map>
+#include <set>
+#include <tuple>
+
+namespace LinaEngine::Graphics
+{
+	// Element layout of the lit meshes, positions, tex coords, normals, tangents & bitangents.
+	static const uint32 s_batchElementSizes[5] = { 3, 2, 3, 3, 3 };
+
+	static void HashBytes(uint64& hash, const void* data, size_t size)
+	{
+		// FNV-1a, stable between runs unlike std::hash.
+		const uint8* bytes = (const uint8*)data;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+	}
+
+	static void AppendTransformed(std::vector<float>& target, const std::vector<float>& source, const Matrix& matrix, float w, bool normalize)
+	{
+		for (size_t i = 0; i + 2 < source.size(); i += 3)
+		{
+			Vector4 transformed = matrix * Vector4(source[i], source[i + 1], source[i + 2], w);
+			Vector3 result = Vector3(transformed.x, transformed.y, transformed.z);
+			if (normalize && result.MagnitudeSqrt() > 0.0f)
+				result.Normalize();
+
+			target.push_back(result.x);
+			target.push_back(result.y);
+			target.push_back(result.z);
+		}
+	}
+
+	static void CalculateBounds(const std::vector<float>& positions, Vector3& center, float& radius)
+	{
+		center = Vector3::Zero;
+		radius = 0.0f;
+		if (positions.size() < 3) return;
+
+		// Center the sphere on the bounding box, then grow it to the furthest position.
+		Vector3 boundsMin = Vector3(positions[0], positions[1], positions[2]);
+		Vector3 boundsMax = boundsMin;
+		for (size_t i = 3; i + 2 < positions.size(); i += 3)
+		{
+			boundsMin = Vector3(Math::Min(boundsMin.x, positions[i]), Math::Min(boundsMin.y, positions[i + 1]), Math::Min(boundsMin.z, positions[i + 2]));
+			boundsMax = Vector3(Math::Max(boundsMax.x, positions[i]), Math::Max(boundsMax.y, positions[i + 1]), Math::Max(boundsMax.z, positions[i + 2]));
+		}
+
+		center = Vector3((boundsMin.x + boundsMax.x) * 0.5f, (boundsMin.y + boundsMax.y) * 0.5f, (boundsMin.z + boundsMax.z) * 0.5f);
+
+		float radiusSqr = 0.0f;
+		for (size_t i = 0; i + 2 < positions.size(); i += 3)
+			radiusSqr = Math::Max(radiusSqr, Math::Square(positions[i] - center.x) + Math::Square(positions[i + 1] - center.y) + Math::Square(positions[i + 2] - center.z));
+
+		radius = Math::Sqrt(radiusSqr);
+	}
+
+	bool StaticBatcher::CanBatch(Mesh& mesh)
+	{
+		if (mesh.GetIndexedModels().size() == 0 || mesh.GetIndexedModels().size() != mesh.GetVertexArrays().size()) return false;
+
+		for (IndexedModel& model : mesh.GetIndexedModels())
+		{
+			const std::vector<uint32>& sizes = model.GetElementSizes();
+			if (sizes.size() < 5) return false;
+
+			for (int i = 0; i < 5; i++)
+			{
+				if (sizes[i] != s_batchElementSizes[i]) return false;
+			}
+		}
+
+		return true;
+	}
+
+	uint64 StaticBatcher::HashSources(const std::vector<StaticBatchSource>& sources)
+	{
+		uint64 hash = 14695981039346656037ull;
+
+		for (const StaticBatchSource& source : sources)
+		{
+			const std::string& meshPath = source.m_mesh->GetPath();
+			const std::string& paramsPath = source.m_mesh->GetParamsPath();
+			const std::string& materialPath = source.m_material->GetPath();
+			HashBytes(hash, meshPath.data(), meshPath.size());
+			HashBytes(hash, paramsPath.data(), paramsPath.size());
+			HashBytes(hash, materialPath.data(), materialPath.size());
+			HashBytes(hash, &source.m_model[0][0], sizeof(float) * 16);
+		}
+
+		// Mesh data, so re-imported meshes or changed import parameters invalidate the cache.
+		std::set<Mesh*> hashedMeshes;
+		for (const StaticBatchSource& source : sources)
+		{
+			if (!hashedMeshes.insert(source.m_mesh).second) continue;
+
+			for (IndexedModel& model : source.m_mesh->GetIndexedModels())
+			{
+				for (uint32 i = 0; i < 5; i++)
+				{
+					const std::vector<float>& element = model.GetElements()[i];
+					HashBytes(hash, element.data(), element.size() * sizeof(float));
+				}
+
+				const std::vector<uint32>& indices = model.GetIndices();
+				HashBytes(hash, indices.data(), indices.size() * sizeof(uint32));
+			}
+		}
+
+		return hash;
+	}
+
+	void StaticBatcher::Build(const std::vector<StaticBatchSource>& sources, StaticBatchCache& cache)
+	{
+		cache.m_sourceHash = HashSources(sources);
+		cache.m_batches.clear();
+
+		// Batch index of each material & cell.
+		std::map<std::tuple<std::string, int, int, int>, size_t> batchIndices;
+
+		for (const StaticBatchSource& source : sources)
+		{
+			const Matrix& model = source.m_model;
+			Matrix normalMatrix = model.Inverse().Transpose();
+
+			// Mirroring transforms flip the winding order.
+			bool flipWinding = model.Determinant4x4() < 0.0f;
+
+			std::vector<IndexedModel>& indexedModels = source.m_mesh->GetIndexedModels();
+			for (uint32 i = 0; i < indexedModels.size(); i++)
+			{
+				IndexedModel& indexedModel = indexedModels[i];
+				std::vector<std::vector<float>>& elements = indexedModel.GetElements();
+				const std::vector<uint32>& indices = indexedModel.GetIndices();
+
+				// Sub-meshes are placed in the cell containing their bounds center.
+				const Vector3& localCenter = source.m_mesh->GetVertexArray(i)->GetBoundsCenter();
+				Vector4 center = model * Vector4(localCenter.x, localCenter.y, localCenter.z, 1.0f);
+				int cellX = Math::FloorToInt(center.x / STATICBATCH_CELLSIZE);
+				int cellY = Math::FloorToInt(center.y / STATICBATCH_CELLSIZE);
+				int cellZ = Math::FloorToInt(center.z / STATICBATCH_CELLSIZE);
+
+				std::tuple<std::string, int, int, int> key = std::make_tuple(source.m_material->GetPath(), cellX, cellY, cellZ);
+				std::map<std::tuple<std::string, int, int, int>, size_t>::iterator it = batchIndices.find(key);
+				if (it == batchIndices.end())
+				{
+					StaticBatchData data;
+					data.m_materialPath = source.m_material->GetPath();
+					data.m_cellX = cellX;
+					data.m_cellY = cellY;
+					data.m_cellZ = cellZ;
+					cache.m_batches.push_back(data);
+					it = batchIndices.emplace(key, cache.m_batches.size() - 1).first;
+				}
+
+				StaticBatchData& batch = cache.m_batches[it->second];
+				uint32 baseVertex = (uint32)(batch.m_positions.size() / 3);
+
+				// Transform the vertices to world space.
+				AppendTransformed(batch.m_positions, elements[0], model, 1.0f, false);
+				batch.m_texCoords.insert(batch.m_texCoords.end(), elements[1].begin(), elements[1].end());
+				AppendTransformed(batch.m_normals, elements[2], normalMatrix, 0.0f, true);
+				AppendTransformed(batch.m_tangents, elements[3], model, 0.0f, true);
+				AppendTransformed(batch.m_bitangents, elements[4], model, 0.0f, true);
+
+				for (size_t j = 0; j + 2 < indices.size(); j += 3)
+				{
+					batch.m_indices.push_back(baseVertex + indices[j]);
+					batch.m_indices.push_back(baseVertex + indices[flipWinding ? j + 2 : j + 1]);
+					batch.m_indices.push_back(baseVertex + indices[flipWinding ? j + 1 : j + 2]);
+				}
+			}
+		}
+	}
+
+	bool StaticBatcher::LoadCache(const std::string& path, StaticBatchCache& cache)
+	{
+		if (!Utility::FileExists(path)) return false;
+
+		std::ifstream stream(path, std::ios::binary);
+
+		try
+		{
+			cereal::BinaryInputArchive iarchive(stream);
+
+			// Read the data into it.
+			iarchive(cache);
+		}
+		catch (const cereal::Exception& e)
+		{
+			LINA_CORE_WARN("Static batch cache {0} is corrupt, batches will be built again. {1}", path, e.what());
+			cache = StaticBatchCache();
+			return false;
+		}
+
+		return true;
+	}
+
+	void StaticBatcher::SaveCache(const std::string& path, const StaticBatchCache& cache)
+	{
+		std::ofstream stream(path, std::ios::binary);
+		{
+			cereal::BinaryOutputArchive oarchive(stream); // Create an output archive
+
+			oarchive(cache); // Write the data to the archive
+		}
+	}
+
+	void StaticBatcher::Load(const StaticBatchCache& cache, const std::vector<StaticBatchSource>& sources)
+	{
+		Clear();
+		m_sources = sources;
+
+		// Cells of a material share a single vertex array, each drawing its own index range.
+		std::map<std::string, std::vector<const StaticBatchData*>> materialBatches;
+		for (const StaticBatchData& batch : cache.m_batches)
+		{
+			if (batch.m_indices.size() == 0) continue;
+
+			if (!Material::MaterialExists(batch.m_materialPath))
+			{
+				LINA_CORE_WARN("Static batch material {0} is not loaded, skipping the batch...", batch.m_materialPath);
+				continue;
+			}
+
+			materialBatches[batch.m_materialPath].push_back(&batch);
+		}
+
+		for (std::map<std::string, std::vector<const StaticBatchData*>>::iterator it = materialBatches.begin(); it != materialBatches.end(); ++it)
+		{
+			// Same layout as the lit meshes so batches go through the same shaders & instance buffers.
+			IndexedModel model;
+			model.AllocateElement(3, true); // Positions
+			model.AllocateElement(2, true); // TexCoords
+			model.AllocateElement(3, true); // Normals
+			model.AllocateElement(3, true); // Tangents
+			model.AllocateElement(3, true); // Bitangents
+			model.SetStartIndex(5); // Begin instanced data
+			model.AllocateElement(12, true); // Affine model matrix rows
+			model.SetInterleaved(true, false);
+
+			std::vector<std::vector<float>>& elements = model.GetElements();
+			std::vector<RenderPacket> cellPackets;
+
+			for (const StaticBatchData* batch : it->second)
+			{
+				uint32 baseVertex = (uint32)(elements[0].size() / 3);
+				elements[0].insert(elements[0].end(), batch->m_positions.begin(), batch->m_positions.end());
+				elements[1].insert(elements[1].end(), batch->m_texCoords.begin(), batch->m_texCoords.end());
+				elements[2].insert(elements[2].end(), batch->m_normals.begin(), batch->m_normals.end());
+				elements[3].insert(elements[3].end(), batch->m_tangents.begin(), batch->m_tangents.end());
+				elements[4].insert(elements[4].end(), batch->m_bitangents.begin(), batch->m_bitangents.end());
+
+				RenderPacket packet;
+				packet.m_firstIndex = model.GetIndexCount();
+				packet.m_indexCount = (uint32)batch->m_indices.size();
+				packet.m_model = Matrix::Identity();
+				packet.m_isStatic = true;
+				CalculateBounds(batch->m_positions, packet.m_boundsCenter, packet.m_boundsRadius);
+				cellPackets.push_back(packet);
+
+				for (uint32 index : batch->m_indices)
+					model.AddIndices(baseVertex + index);
+			}
+
+			VertexArray* vertexArray = new VertexArray();
+			vertexArray->Construct(*m_renderDevice, model, BufferUsage::USAGE_STATIC_COPY);
+			m_vertexArrays.push_back(vertexArray);
+
+			for (RenderPacket& packet : cellPackets)
+			{
+				packet.m_vertexArray = vertexArray;
+				packet.m_material = &Material::GetMaterial(it->first);
+				packet.m_modelBufferIndex = vertexArray->GetInstanceBufferIndex();
+				m_packets.push_back(packet);
+			}
+		}
+
+		LINA_CORE_TRACE("Static batches loaded, {0} batches in {1} vertex arrays", m_packets.size(), m_vertexArrays.size());
+	}
+
+	void StaticBatcher::Rebuild(const std::vector<StaticBatchSource>& sources)
+	{
+		StaticBatchCache cache;
+		Build(sources, cache);
+		Load(cache, sources);
+	}
+
+	void StaticBatcher::Clear()
+	{
+		for (uint32 i = 0; i < m_vertexArrays.size(); i++)
+			delete m_vertexArrays[i];
+
+		m_vertexArrays.clear();
+		m_packets.clear();
+		m_sources.clear();
+	}
+}
@@ -28,7 +28,9 @@ SOFTWARE.
 
 #include "Rendering/Texture.hpp"  
 #include "Rendering/ArrayBitmap.hpp"
+#include "Rendering/TextureCooker.hpp"
 #include "Rendering/RenderEngine.hpp"
+#include "Utility/UtilityFunctions.hpp"
 #include <stdio.h>
 #include <cereal/archives/binary.hpp>
 #include <fstream>
@@ -59,6 +61,29 @@ namespace LinaEngine::Graphics
 	}
 
 
+	Texture& Texture::ConstructCompressed(RenderDevice& deviceIn, const CookedTexture& data, SamplerParameters samplerParams, const std::string& path)
+	{
+		std::vector<const void*> levels;
+		std::vector<uint32> levelSizes;
+		for (const CookedTextureLevel& level : data.m_levels)
+		{
+			levels.push_back(level.m_blocks.data());
+			levelSizes.push_back((uint32)level.m_blocks.size());
+		}
+
+		s_renderDevice = &deviceIn;
+		m_size = Vector2(data.m_levels[0].m_width, data.m_levels[0].m_height);
+		m_bindMode = TextureBindMode::BINDTEXTURE_TEXTURE2D;
+		m_sampler.Construct(deviceIn, samplerParams, m_bindMode);
+		m_id = s_renderDevice->CreateTexture2DCompressed(m_size, data.m_compression, data.m_sRGB, levels, levelSizes, samplerParams);
+		m_sampler.SetTargetTextureID(m_id);
+		m_isCompressed = true;
+		m_hasMipMaps = data.m_levels.size() > 1;
+		m_isEmpty = false;
+		m_path = path;
+		return *this;
+	}
+
 	Texture& Texture::ConstructCubemap(RenderDevice& deviceIn, SamplerParameters samplerParams, const std::vector<ArrayBitmap*>& data, bool shouldCompress, const std::string& path)
 	{
 		if (data.size() != 6)
@@ -174,11 +199,22 @@ namespace LinaEngine::Graphics
 		SamplerParameters params;
 
 		std::ifstream stream(path);
+
+		try
 		{
+			bool versioned = Utility::ReadVersionTag(stream);
 			cereal::BinaryInputArchive iarchive(stream);
 
-			// Read the data into it.
-			iarchive(params);
+			// Read the data into it, files without the tag were written before the parameters were versioned.
+			if (versioned)
+				iarchive(params);
+			else
+				params.serialize(iarchive, 0);
+		}
+		catch (const std::exception& e)
+		{
+			LINA_CORE_WARN("Texture parameters {0} could not be read, using defaults. {1}", path, e.what());
+			return SamplerParameters();
 		}
 
 		return params;
@@ -188,6 +224,7 @@ namespace LinaEngine::Graphics
 	{
 		std::ofstream stream(path);
 		{
+			Utility::WriteVersionTag(stream);
 			cereal::BinaryOutputArchive oarchive(stream); // Create an output archive
 
 			oarchive(params); // Write the data to the archive
@@ -196,6 +233,24 @@ namespace LinaEngine::Graphics
 
 	Texture& Texture::CreateTexture2D(const std::string& filePath, SamplerParameters samplerParams, bool compress, bool useDefaultFormats, const std::string& paramsPath)
 	{
+		if (compress)
+		{
+			PixelFormat internalFormat = samplerParams.m_textureParams.m_internalPixelFormat;
+			bool sRGB = internalFormat == PixelFormat::FORMAT_SRGB || internalFormat == PixelFormat::FORMAT_SRGBA;
+
+			// Upload the cooked blocks directly, skips decoding the source.
+			CookedTexture cooked;
+			if (TextureCooker::LoadOrCook(filePath, sRGB, cooked))
+			{
+				Texture* texture = new Texture();
+				texture->ConstructCompressed(RenderEngine::GetRenderDevice(), cooked, samplerParams, filePath);
+				s_loadedTextures[texture->GetID()] = texture;
+				texture->m_paramsPath = paramsPath;
+				LINA_CORE_TRACE("Texture created from cooked blocks. {0}", filePath);
+				return *s_loadedTextures[texture->GetID()];
+			}
+		}
+
 		// Create pixel data.
 		ArrayBitmap* textureBitmap = new ArrayBitmap();
 
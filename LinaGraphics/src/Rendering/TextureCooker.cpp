@@ -0,0 +1,312 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#define STB_DXT_IMPLEMENTATION
+#define STB_IMAGE_RESIZE_IMPLEMENTATION
+#include "Rendering/TextureCooker.hpp"
+#include "Rendering/HDRICache.hpp"
+#include "Rendering/ArrayBitmap.hpp"
+#include "Utility/stb/stb_dxt.h"
+#include "Utility/stb/stb_image_resize.h"
+#include "Utility/Log.hpp"
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+
+namespace LinaEngine::Graphics
+{
+	bool TextureCooker::LoadOrCook(const std::string& sourcePath, bool sRGB, CookedTexture& cooked)
+	{
+		uint64 key = GetSourceKey(sourcePath, sRGB);
+		if (key == 0) return false;
+
+		std::string cachePath = sourcePath + TEXTURECOOKER_EXTENSION;
+		if (Read(cachePath, key, cooked))
+			return true;
+
+		ArrayBitmap bitmap;
+		int channels = bitmap.Load(sourcePath);
+		if (channels == -1) return false;
+
+		const uint8* rgba = (const uint8*)bitmap.GetPixelArray();
+		uint32 width = (uint32)bitmap.GetWidth();
+		uint32 height = (uint32)bitmap.GetHeight();
+		uint32 pixelCount = width * height;
+
+		// Grey sources are loaded as RGBA w/ the grey replicated, normal maps are renormalized after filtering.
+		bool normalMap = channels >= 3 && IsNormalMap(rgba, pixelCount);
+		TextureCompression compression = ChooseCompression(rgba, pixelCount, channels, sRGB);
+		cooked.m_sRGB = sRGB && (compression == TextureCompression::COMPRESSION_BC1 || compression == TextureCompression::COMPRESSION_BC3);
+		Cook(rgba, width, height, compression, cooked.m_sRGB && !normalMap, normalMap, cooked);
+
+		Write(cachePath, key, cooked);
+		LINA_CORE_TRACE("Texture cooked. {0}", sourcePath);
+		return true;
+	}
+
+	void TextureCooker::Cook(const uint8* rgba, uint32 width, uint32 height, TextureCompression compression, bool sRGB, bool normalMap, CookedTexture& cooked)
+	{
+		cooked.m_compression = compression;
+		cooked.m_levels.clear();
+
+		std::vector<uint8> current(rgba, rgba + (size_t)width * height * 4);
+		std::vector<uint8> next;
+
+		while (true)
+		{
+			CookedTextureLevel level;
+			level.m_width = width;
+			level.m_height = height;
+			CompressLevel(current.data(), width, height, compression, level.m_blocks);
+			cooked.m_levels.push_back(std::move(level));
+
+			if (width == 1 && height == 1)
+				break;
+
+			// Each level is filtered from the previous one.
+			uint32 nextWidth = std::max(width / 2, 1u);
+			uint32 nextHeight = std::max(height / 2, 1u);
+			next.resize((size_t)nextWidth * nextHeight * 4);
+
+			if (sRGB)
+				stbir_resize_uint8_srgb(current.data(), width, height, 0, next.data(), nextWidth, nextHeight, 0, 4, 3, 0);
+			else
+				stbir_resize_uint8(current.data(), width, height, 0, next.data(), nextWidth, nextHeight, 0, 4);
+
+			if (normalMap)
+			{
+				for (size_t i = 0; i < next.size(); i += 4)
+				{
+					float x = next[i] / 127.5f - 1.0f;
+					float y = next[i + 1] / 127.5f - 1.0f;
+					float z = next[i + 2] / 127.5f - 1.0f;
+					float length = std::sqrt(x * x + y * y + z * z);
+					if (length < 0.0001f) continue;
+
+					next[i] = (uint8)std::clamp((x / length + 1.0f) * 127.5f + 0.5f, 0.0f, 255.0f);
+					next[i + 1] = (uint8)std::clamp((y / length + 1.0f) * 127.5f + 0.5f, 0.0f, 255.0f);
+					next[i + 2] = (uint8)std::clamp((z / length + 1.0f) * 127.5f + 0.5f, 0.0f, 255.0f);
+				}
+			}
+
+			current.swap(next);
+			width = nextWidth;
+			height = nextHeight;
+		}
+	}
+
+	TextureCompression TextureCooker::ChooseCompression(const uint8* rgba, uint32 pixelCount, int channels, bool sRGB)
+	{
+		if (channels == 1 && !sRGB) return TextureCompression::COMPRESSION_BC4;
+		if (channels == 2 && !sRGB) return TextureCompression::COMPRESSION_BC5;
+		if (channels == 1 || channels == 3) return TextureCompression::COMPRESSION_BC1;
+
+		for (uint32 i = 0; i < pixelCount; i++)
+		{
+			if (rgba[i * 4 + 3] != 255)
+				return TextureCompression::COMPRESSION_BC3;
+		}
+
+		return TextureCompression::COMPRESSION_BC1;
+	}
+
+	bool TextureCooker::IsNormalMap(const uint8* rgba, uint32 pixelCount)
+	{
+		if (pixelCount == 0) return false;
+
+		// Sample up to 4096 pixels spread over the image.
+		uint32 step = std::max(pixelCount / 4096, 1u);
+		uint32 samples = 0, matches = 0;
+		for (uint32 i = 0; i < pixelCount; i += step, samples++)
+		{
+			const uint8* pixel = rgba + (size_t)i * 4;
+			float x = pixel[0] / 127.5f - 1.0f;
+			float y = pixel[1] / 127.5f - 1.0f;
+			float z = pixel[2] / 127.5f - 1.0f;
+			float length = std::sqrt(x * x + y * y + z * z);
+			if (z > 0.0f && std::abs(length - 1.0f) < 0.1f)
+				matches++;
+		}
+
+		return matches * 100 >= samples * 95;
+	}
+
+	uint32 TextureCooker::GetLevelSize(TextureCompression compression, uint32 width, uint32 height)
+	{
+		uint32 blockSize = compression == TextureCompression::COMPRESSION_BC1 || compression == TextureCompression::COMPRESSION_BC4 ? 8 : 16;
+		return ((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+	}
+
+	void TextureCooker::CompressLevel(const uint8* rgba, uint32 width, uint32 height, TextureCompression compression, std::vector<uint8>& blocks)
+	{
+		blocks.resize(GetLevelSize(compression, width, height));
+		uint32 blockSize = compression == TextureCompression::COMPRESSION_BC1 || compression == TextureCompression::COMPRESSION_BC4 ? 8 : 16;
+		uint8* dest = blocks.data();
+
+		uint8 block[64];
+		uint8 channels[32];
+		for (uint32 by = 0; by < height; by += 4)
+		{
+			for (uint32 bx = 0; bx < width; bx += 4)
+			{
+				// Gather the 4x4 block, edges are replicated for levels smaller than a block.
+				for (uint32 y = 0; y < 4; y++)
+				{
+					uint32 sy = std::min(by + y, height - 1);
+					for (uint32 x = 0; x < 4; x++)
+					{
+						uint32 sx = std::min(bx + x, width - 1);
+						const uint8* pixel = rgba + ((size_t)sy * width + sx) * 4;
+						uint8* target = block + (y * 4 + x) * 4;
+						target[0] = pixel[0];
+						target[1] = pixel[1];
+						target[2] = pixel[2];
+						target[3] = pixel[3];
+
+						// Grey & alpha for the dual channel blocks, grey sources are replicated into rgb.
+						channels[(y * 4 + x) * 2] = pixel[0];
+						channels[(y * 4 + x) * 2 + 1] = pixel[3];
+					}
+				}
+
+				if (compression == TextureCompression::COMPRESSION_BC1)
+					stb_compress_dxt_block(dest, block, 0, STB_DXT_HIGHQUAL);
+				else if (compression == TextureCompression::COMPRESSION_BC3)
+					stb_compress_dxt_block(dest, block, 1, STB_DXT_HIGHQUAL);
+				else if (compression == TextureCompression::COMPRESSION_BC5)
+					stb_compress_bc5_block(dest, channels);
+				else
+				{
+					uint8 red[16];
+					for (uint32 i = 0; i < 16; i++)
+						red[i] = block[i * 4];
+					stb_compress_bc4_block(dest, red);
+				}
+
+				dest += blockSize;
+			}
+		}
+	}
+
+	uint64 TextureCooker::GetSourceKey(const std::string& sourcePath, bool sRGB)
+	{
+		// Size & write time of the source, hashing the contents would cost as much as decoding it.
+		std::error_code error;
+		uint64 size = (uint64)std::filesystem::file_size(sourcePath, error);
+		if (error) return 0;
+
+		int64 writeTime = (int64)std::filesystem::last_write_time(sourcePath, error).time_since_epoch().count();
+		if (error) return 0;
+
+		uint64 key = HDRICache::HashBytes(&size, sizeof(uint64));
+		key = HDRICache::HashBytes(&writeTime, sizeof(int64), key);
+		return HDRICache::HashBytes(&sRGB, sizeof(bool), key);
+	}
+
+	bool TextureCooker::Read(const std::string& path, uint64 key, CookedTexture& cooked)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open()) return false;
+
+		uint32 magic = 0, version = 0, compression = 0, sRGB = 0, levelCount = 0;
+		uint64 fileKey = 0;
+		file.read((char*)&magic, sizeof(uint32));
+		file.read((char*)&version, sizeof(uint32));
+		file.read((char*)&fileKey, sizeof(uint64));
+		file.read((char*)&compression, sizeof(uint32));
+		file.read((char*)&sRGB, sizeof(uint32));
+		file.read((char*)&levelCount, sizeof(uint32));
+
+		if (!file.good() || magic != TEXTURECOOKER_MAGIC || version != TEXTURECOOKER_VERSION || fileKey != key)
+		{
+			LINA_CORE_TRACE("Cooked texture {0} is outdated, texture will be cooked again.", path);
+			return false;
+		}
+
+		cooked.m_compression = (TextureCompression)compression;
+		cooked.m_sRGB = sRGB != 0;
+		// Sizes are checked before anything is allocated for them.
+		bool valid = levelCount > 0 && levelCount <= TEXTURECOOKER_MAXLEVELS && compression >= (uint32)TextureCompression::COMPRESSION_BC1 && compression <= (uint32)TextureCompression::COMPRESSION_BC5;
+		if (valid)
+			cooked.m_levels.resize(levelCount);
+
+		for (uint32 i = 0; valid && i < cooked.m_levels.size(); i++)
+		{
+			CookedTextureLevel& level = cooked.m_levels[i];
+			uint32 header[2];
+			file.read((char*)header, sizeof(header));
+			level.m_width = header[0];
+			level.m_height = header[1];
+			valid = file.good() && level.m_width > 0 && level.m_width <= TEXTURECOOKER_MAXSIZE && level.m_height > 0 && level.m_height <= TEXTURECOOKER_MAXSIZE;
+			if (!valid) break;
+
+			level.m_blocks.resize(GetLevelSize(cooked.m_compression, level.m_width, level.m_height));
+			file.read((char*)level.m_blocks.data(), level.m_blocks.size());
+			valid = file.good();
+		}
+
+		if (!valid)
+		{
+			LINA_CORE_WARN("Cooked texture {0} is corrupt, texture will be cooked again.", path);
+			cooked.m_levels.clear();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool TextureCooker::Write(const std::string& path, uint64 key, const CookedTexture& cooked)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			LINA_CORE_WARN("Cooked texture {0} could not be written.", path);
+			return false;
+		}
+
+		uint32 magic = TEXTURECOOKER_MAGIC, version = TEXTURECOOKER_VERSION, compression = (uint32)cooked.m_compression;
+		uint32 sRGB = cooked.m_sRGB ? 1 : 0, levelCount = (uint32)cooked.m_levels.size();
+		file.write((const char*)&magic, sizeof(uint32));
+		file.write((const char*)&version, sizeof(uint32));
+		file.write((const char*)&key, sizeof(uint64));
+		file.write((const char*)&compression, sizeof(uint32));
+		file.write((const char*)&sRGB, sizeof(uint32));
+		file.write((const char*)&levelCount, sizeof(uint32));
+
+		for (const CookedTextureLevel& level : cooked.m_levels)
+		{
+			uint32 header[2] = { level.m_width, level.m_height };
+			file.write((const char*)header, sizeof(header));
+			file.write((const char*)level.m_blocks.data(), level.m_blocks.size());
+		}
+
+		return file.good();
+	}
+}
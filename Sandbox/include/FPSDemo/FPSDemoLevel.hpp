@@ -67,6 +67,7 @@ namespace LinaEngine
 		virtual void Tick(bool isInPlayMode, float delta) override;
 		virtual void SerializeRegistry(LinaEngine::ECS::ECSRegistry& reg, cereal::BinaryOutputArchive& o) override;
 		virtual void DeserializeRegistry(LinaEngine::ECS::ECSRegistry& reg, cereal::BinaryInputArchive& o) override;
+		virtual void DeserializeLegacyRegistry(LinaEngine::ECS::ECSRegistry& reg, cereal::BinaryInputArchive& o) override;
 	
 	private:
 
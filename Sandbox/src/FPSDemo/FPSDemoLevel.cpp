@@ -122,6 +122,26 @@ namespace LinaEngine
 			>(iarchive);
 	}
 
+	void FPSDemoLevel::DeserializeLegacyRegistry(LinaEngine::ECS::ECSRegistry& registry, cereal::BinaryInputArchive& iarchive)
+	{
+		entt::snapshot_loader{ registry }
+			.entities(iarchive)
+			.component<
+			LinaEngine::ECS::ECSEntityData,
+			LinaEngine::ECS::CameraComponent,
+			LinaEngine::ECS::FreeLookComponent,
+			LinaEngine::ECS::PointLightComponent,
+			LinaEngine::ECS::LegacyComponent<LinaEngine::ECS::DirectionalLightComponent>,
+			LinaEngine::ECS::SpotLightComponent,
+			LinaEngine::ECS::RigidbodyComponent,
+			LinaEngine::ECS::LegacyComponent<LinaEngine::ECS::MeshRendererComponent>,
+			LinaEngine::ECS::LegacyComponent<LinaEngine::ECS::SpriteRendererComponent>,
+			LinaEngine::ECS::TransformComponent,
+			LinaEngine::ECS::HeadbobComponent,
+			LinaEngine::ECS::PlayerMotionComponent
+			>(iarchive);
+	}
+
 
 	void FPSDemoLevel::PreDraw()
 	{